@@ -2,11 +2,23 @@
 
 #include "FastVAT.h"
 
+#include "ShaderCore.h"
+#include "Interfaces/IPluginManager.h"
+#include "Misc/Paths.h"
+
 #define LOCTEXT_NAMESPACE "FFastVATModule"
 
 void FFastVATModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
+
+	// Map the plugin shader directory so generated material layers can include /Plugin/FastVAT/*.ush
+	const TSharedPtr<IPlugin> Plugin = IPluginManager::Get().FindPlugin(TEXT("FastVAT"));
+	if (Plugin.IsValid())
+	{
+		const FString ShaderDirectory = FPaths::Combine(Plugin->GetBaseDir(), TEXT("Shaders"));
+		AddShaderSourceDirectoryMapping(TEXT("/Plugin/FastVAT"), ShaderDirectory);
+	}
 }
 
 void FFastVATModule::ShutdownModule()
@@ -17,4 +29,4 @@ void FFastVATModule::ShutdownModule()
 
 #undef LOCTEXT_NAMESPACE
 	
-IMPLEMENT_MODULE(FFastVATModule, FastVAT)
\ No newline at end of file
+IMPLEMENT_MODULE(FFastVATModule, FastVAT)
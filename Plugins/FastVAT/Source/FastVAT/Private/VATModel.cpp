@@ -18,6 +18,7 @@ void UVATModel::ResetInfo()
 
 	// Bone Info
 	NumBones = 0;
+	BoneMap.Reset();
 	// BoneRowsPerFrame.Empty();
 	//BoneWeightRowsPerFrame.Empty();
 	BoneMinBBox = FVector3f::ZeroVector;
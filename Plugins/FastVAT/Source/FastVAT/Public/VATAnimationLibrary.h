@@ -0,0 +1,52 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "VATModelSettings.h"
+#include "Animation/Skeleton.h"
+#include "Engine/DataAsset.h"
+#include "Engine/Texture2D.h"
+
+#include "VATAnimationLibrary.generated.h"
+
+/**
+ * Bone Mode textures shared by all the VATModels of a Skeleton.
+ * Bone positions and rotations only depend on the Skeleton, the animations and the settings, so they are baked once
+ * by the first VATModel referencing the library. Following VATModels only bake their weights and UVs.
+ */
+UCLASS(BlueprintType)
+class FASTVAT_API UVATAnimationLibrary : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+public:
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Animation")
+	TObjectPtr<USkeleton> Skeleton;
+
+	/* Animations baked by the library. They replace the AnimSequences of the VATModels referencing it */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Animation")
+	TArray<FVATAnimSequenceInfo> AnimSequences;
+
+	// generated properties
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Generated|Texture")
+	TSoftObjectPtr<UTexture2D> BonePositionTexture;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Generated|Texture")
+	TSoftObjectPtr<UTexture2D> BoneRotationTexture;
+
+	/* Hash of the Skeleton, RefPose, animations and settings the textures were baked with. Empty until baked */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Generated|Info")
+	FString BakeKey;
+
+	/* Name of the VATModel that baked the textures */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Generated|Info")
+	FString BakedBy;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Generated|Info")
+	int32 NumFrames = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Generated|Info")
+	int32 NumBones = 0;
+};
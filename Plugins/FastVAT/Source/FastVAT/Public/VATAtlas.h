@@ -0,0 +1,122 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/Texture2D.h"
+
+#include "VATAtlas.generated.h"
+
+class UVATModel;
+class UMaterial;
+class UMaterialInstanceConstant;
+class UMaterialFunctionMaterialLayer;
+
+/* Location of a VATModel LOD in the atlas textures */
+USTRUCT(BlueprintType)
+struct FVATAtlasEntry
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, Category = Default, BlueprintReadOnly)
+	TObjectPtr<UVATModel> Model;
+
+	UPROPERTY(VisibleAnywhere, Category = Default, BlueprintReadOnly)
+	int32 LODIndex = 0;
+
+	/* First atlas row of the model textures */
+	UPROPERTY(VisibleAnywhere, Category = Default, BlueprintReadOnly)
+	int32 RowOffset = 0;
+
+	UPROPERTY(VisibleAnywhere, Category = Default, BlueprintReadOnly)
+	int32 RowsPerFrame = 0;
+
+	/* Size of the model textures, used to address its VertexUVs */
+	UPROPERTY(VisibleAnywhere, Category = Default, BlueprintReadOnly)
+	int32 Width = 0;
+
+	UPROPERTY(VisibleAnywhere, Category = Default, BlueprintReadOnly)
+	int32 Height = 0;
+};
+
+/**
+ * Vertex textures of several VATModels packed into one shared texture set.
+ * Models are stacked vertically and a Lookup table stores the rows, size, bounding box and frames of each model (and LOD).
+ * The shared material reads the model from the PerInstanceCustomData, so instances of different models use the same
+ * material, textures and samplers:
+ *   0: Model index in Models
+ *   1: StartFrame (Frame when AutoPlay is off)
+ *   2: EndFrame. A negative EndFrame plays all the frames of the model
+ * With Merge Meshes, the model StaticMeshes (variants) are also merged into one mesh, with a single section per LOD.
+ * The Model ID hides the vertices of the other variants, so a single instanced component renders mixed crowds.
+ * This is only used on Vertex Mode
+ */
+UCLASS(BlueprintType)
+class FASTVAT_API UVATAtlas : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+public:
+
+	/* Models packed in the atlas. Their index is the per-instance Model ID */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Atlas")
+	TArray<TObjectPtr<UVATModel>> Models;
+
+	/* Maximum height of the atlas textures. The models must fit in a single texture */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Atlas", meta = (ClampMin = "1", ClampMax = "16384"))
+	int32 MaxHeight = 8192;
+
+	/**
+	* Merges the model StaticMeshes into a single mesh. Each vertex stores its model index (variant) in an extra UVChannel,
+	* and vertices of the variants not selected by the per-instance Model ID are collapsed
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Atlas")
+	bool bMergeMeshes = false;
+
+	// generated properties
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Generated|Texture")
+	TSoftObjectPtr<UTexture2D> PositionTexture;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Generated|Texture")
+	TSoftObjectPtr<UTexture2D> NormalTexture;
+
+	/**
+	* One row per model, three texels per LOD: (RowOffset, RowsPerFrame, Width, Height), (MinBBox, NumFrames), (SizeBBox, SampleRate).
+	* Models with fewer LODs repeat their last LOD
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Generated|Texture")
+	TSoftObjectPtr<UTexture2D> LookupTexture;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Generated|Material")
+	TSoftObjectPtr<UMaterialFunctionMaterialLayer> MaterialLayer;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Generated|Material")
+	TSoftObjectPtr<UMaterial> Material;
+
+	/* Per-LOD instances of the shared material, selecting the LOD column of the Lookup table */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Generated|Material")
+	TArray<TSoftObjectPtr<UMaterialInstanceConstant>> MaterialInstances;
+
+	/* Merged mesh of all the models. This is only used with Merge Meshes */
+	UPROPERTY(EditAnywhere, Category = "Generated|Mesh")
+	TObjectPtr<UStaticMesh> MergedStaticMesh;
+
+	/* Per-LOD instances of the shared material hiding the unselected variants. This is only used with Merge Meshes */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Generated|Material")
+	TArray<TSoftObjectPtr<UMaterialInstanceConstant>> MergedMaterialInstances;
+
+	// ------------------------------------------------------
+	// Info
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Generated|Info")
+	TArray<FVATAtlasEntry> Entries;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Generated|Info")
+	int32 NumLODs = 0;
+
+	/* UVChannel storing the variant of each vertex of the merged mesh. This is only used with Merge Meshes */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Generated|Info")
+	int32 VariantUVChannel = INDEX_NONE;
+};
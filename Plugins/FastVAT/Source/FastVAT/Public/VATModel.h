@@ -9,9 +9,12 @@
 #include "Engine/SkeletalMesh.h"
 #include "Engine/StaticMesh.h"
 #include "Engine/Texture2D.h"
+#include "Engine/Texture2DArray.h"
 
 #include "VATModel.generated.h"
 
+class UVATAnimationLibrary;
+
 /**
  * 
  */
@@ -34,6 +37,14 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Animation")
 	TArray<FVATAnimSequenceInfo> AnimSequences;
 
+	/**
+	* Bone textures shared with the other VATModels of the Skeleton. When set, the library animations are baked
+	* into the library Bone textures (once per Skeleton, animations and settings) and this model only bakes its weights and UVs.
+	* This is only used on Bone Mode
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Animation")
+	TObjectPtr<UVATAnimationLibrary> AnimationLibrary;
+
 	
 	/**
 	* StaticMesh UVChannel Index for storing vertex information.
@@ -83,6 +94,105 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Generated|Texture")
 	TSoftObjectPtr<UTexture2D> BoneWeightTexture;
 
+	/**
+	* Texture for storing the three RefToLocal matrix rows of each bone
+	* This is only used on Bone Mode with the MatrixPalette Bone Encoding
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Generated|Texture")
+	TSoftObjectPtr<UTexture2D> BoneMatrixTexture;
+
+	/**
+	* Textures for storing the Real (rotation) and Dual (translation) quaternions of each bone
+	* This is only used on Bone Mode with the DualQuaternion Bone Encoding
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Generated|Texture")
+	TSoftObjectPtr<UTexture2D> BoneRealTexture;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Generated|Texture")
+	TSoftObjectPtr<UTexture2D> BoneDualTexture;
+
+	/**
+	* Textures for storing the mean and basis of the vertex deltas
+	* This is only used on CompressedVertex Mode
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Generated|Texture")
+	TArray< TSoftObjectPtr<UTexture2D> > VertexBasisTextures;
+
+	/**
+	* Textures for storing the mean and basis of the vertex normals
+	* This is only used on CompressedVertex Mode
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Generated|Texture")
+	TArray< TSoftObjectPtr<UTexture2D> > VertexNormalBasisTextures;
+
+	/**
+	* Textures for storing the per-frame basis coefficients
+	* This is only used on CompressedVertex Mode
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Generated|Texture")
+	TArray< TSoftObjectPtr<UTexture2D> > VertexCoefficientTextures;
+
+	/**
+	* Textures for storing the quantization range of the mean, each basis and each coefficient column
+	* One row per basis block, four full precision texels: delta min, delta size, normal min, normal size.
+	* The coefficient min and size of basis k are stored in the alpha of the first two texels of row k + 1.
+	* This is only used on CompressedVertex Mode
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Generated|Texture")
+	TArray< TSoftObjectPtr<UTexture2D> > VertexBasisRangeTextures;
+
+	/**
+	* Textures mapping each baked frame to the stored keyframes
+	* This is only used with Keyframe Reduction
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Generated|Texture")
+	TArray< TSoftObjectPtr<UTexture2D> > FrameRemapTextures;
+
+	/**
+	* Textures storing the integer bone indices of each vertex
+	* This is only used with Integer Bone Indices
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Generated|Texture")
+	TArray< TSoftObjectPtr<UTexture2D> > BoneIndexTextures;
+
+	/**
+	* Texture Arrays storing the vertex deltas and normals in pages
+	* This is only used on Vertex Mode with a Paged Texture Layout
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Generated|Texture")
+	TArray< TSoftObjectPtr<UTexture2DArray> > VertexPositionPageTextures;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Generated|Texture")
+	TArray< TSoftObjectPtr<UTexture2DArray> > VertexNormalPageTextures;
+
+	/**
+	* Texture Arrays storing the bone positions and rotations in pages
+	* This is only used on Bone Mode with a Paged Texture Layout
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Generated|Texture")
+	TSoftObjectPtr<UTexture2DArray> BonePositionPageTexture;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Generated|Texture")
+	TSoftObjectPtr<UTexture2DArray> BoneRotationPageTexture;
+
+	/**
+	* Textures mapping each stored frame to its page and its frame within the page
+	* This is only used with a Paged Texture Layout
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Generated|Texture")
+	TArray< TSoftObjectPtr<UTexture2D> > PageTableTextures;
+
+	/**
+	* Textures storing the per-frame residuals of the vertices over the Residual Threshold,
+	* and the residual slot (+ 1) of each vertex, in the BoneWeight texel layout
+	* This is only used on Bone Mode with Bake Residuals
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Generated|Texture")
+	TArray< TSoftObjectPtr<UTexture2D> > ResidualTextures;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Generated|Texture")
+	TArray< TSoftObjectPtr<UTexture2D> > ResidualIndexTextures;
+
 	// ------------------------------------------------------
 	// Info
 
@@ -90,10 +200,31 @@ public:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Generated|Info")
 	int32 NumFrames = 0;
 
-	/* Total Number of Bones */
+	/* Number of baked Bones */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Generated|Info")
 	int32 NumBones = 0;
 
+	/* Skeleton (raw) bone index of each baked bone. Empty when all bones are baked in Skeleton order.
+	*  This is only used with Cull Unused Bones or Reduce Bone LODs */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Generated|Info")
+	TArray<int32> BoneMap;
+
+	/* Per-LOD number of skinned bones (a prefix of the baked bones). This is only used with Reduce Bone LODs */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Generated|Info")
+	TArray<int32> NumLODBones;
+
+	/* Per-LOD max number of bone influences of a vertex, after pruning */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Generated|Info")
+	TArray<int32> MaxNumInfluences;
+
+	/* Per-LOD number of vertices without texels. This is only used with Skip Static Vertices */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Generated|Info")
+	TArray<int32> NumStaticVertices;
+
+	/* Per-LOD number of vertices baked in Vertex Mode. This is only used with Vertex Sections */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Generated|Info")
+	TArray<int32> NumVertexSectionVertices;
+
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Generated|Info")
 	TArray<int32> VertexRowsPerFrame;
 
@@ -109,14 +240,61 @@ public:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Generated|Info")
 	TArray<int32> BoneRowsPerFrame;
 
+	/* Bone position Bounding Box. With the MatrixPalette Bone Encoding, the Bounding Box of the matrix translations.
+	*  With the DualQuaternion Bone Encoding, the (symmetric) range of the Dual quaternions */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Generated|Info")
 	FVector3f BoneMinBBox;
 
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Generated|Info")
 	FVector3f BoneSizeBBox;
 
+	/* Per-LOD number of vertices storing residuals. This is only used with Bake Residuals */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Generated|Info")
+	TArray<int32> NumResidualVertices;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Generated|Info")
+	TArray<int32> ResidualRowsPerFrame;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Generated|Info")
+	TArray<FVector3f> ResidualMinBBox;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Generated|Info")
+	TArray<FVector3f> ResidualSizeBBox;
+
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Generated|Info")
 	TArray<FVATAnimInfo> Animations;
+
+	/* Per-LOD number of stored frames. Smaller than NumFrames with Keyframe Reduction or Frame Deduplication */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Generated|Info")
+	TArray<int32> NumKeyframes;
+
+	/* Per-LOD number of Texture2DArray pages. This is only used with a Paged Texture Layout */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Generated|Info")
+	TArray<int32> NumPages;
+
+	/* Per-LOD number of temporal mips of the Vertex textures. This is only used with Temporal Mips */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Generated|Info")
+	TArray<int32> NumTemporalMips;
+
+	/* Texture memory saved by frame deduplication (all LODs) */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Generated|Info")
+	int64 DeduplicatedBytes = 0;
+
+	/* Per-LOD basis info. This is only used on CompressedVertex Mode */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Generated|Info")
+	TArray<FVATBasisInfo> BasisInfos;
+
+	/* RMS vertex error (cm) of the fitted virtual bones. This is only used on SkinningDecomposition Mode */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Generated|Info")
+	TArray<float> DecompositionErrors;
+
+	/* Virtual bone transforms (NumFrames x NumBones) and pivots fitted on the first LOD.
+	*  Following LODs only solve their skin weights. Not serialized */
+	TArray<FTransform3f> VirtualBoneTransforms;
+	TArray<FVector3f> VirtualBonePivots;
+
+	/* Per-animation sample steps picked by Auto SampleRate on the first LOD. Not serialized */
+	TArray<int32> AutoSampleSteps;
 	
 public:
 	UStaticMesh* GetStaticMesh() const { return StaticMesh; }
@@ -153,6 +331,22 @@ public:
 	VATModel_Texture_ASSET_ACCESSOR(UTexture2D, BonePositionTexture);
 	VATModel_Texture_ASSET_ACCESSOR(UTexture2D, BoneRotationTexture);
 	VATModel_Array_Texture_ASSET_ACCESSOR(UTexture2D, BoneWeightTexture);
+	VATModel_Texture_ASSET_ACCESSOR(UTexture2D, BoneMatrixTexture);
+	VATModel_Texture_ASSET_ACCESSOR(UTexture2D, BoneRealTexture);
+	VATModel_Texture_ASSET_ACCESSOR(UTexture2D, BoneDualTexture);
+	VATModel_Array_Texture_ASSET_ACCESSOR(UTexture2D, VertexBasisTexture);
+	VATModel_Array_Texture_ASSET_ACCESSOR(UTexture2D, VertexNormalBasisTexture);
+	VATModel_Array_Texture_ASSET_ACCESSOR(UTexture2D, VertexCoefficientTexture);
+	VATModel_Array_Texture_ASSET_ACCESSOR(UTexture2D, VertexBasisRangeTexture);
+	VATModel_Array_Texture_ASSET_ACCESSOR(UTexture2D, FrameRemapTexture);
+	VATModel_Array_Texture_ASSET_ACCESSOR(UTexture2D, BoneIndexTexture);
+	VATModel_Array_Texture_ASSET_ACCESSOR(UTexture2DArray, VertexPositionPageTexture);
+	VATModel_Array_Texture_ASSET_ACCESSOR(UTexture2DArray, VertexNormalPageTexture);
+	VATModel_Texture_ASSET_ACCESSOR(UTexture2DArray, BonePositionPageTexture);
+	VATModel_Texture_ASSET_ACCESSOR(UTexture2DArray, BoneRotationPageTexture);
+	VATModel_Array_Texture_ASSET_ACCESSOR(UTexture2D, PageTableTexture);
+	VATModel_Array_Texture_ASSET_ACCESSOR(UTexture2D, ResidualTexture);
+	VATModel_Array_Texture_ASSET_ACCESSOR(UTexture2D, ResidualIndexTexture);
 
 	void ResetInfo();
 	
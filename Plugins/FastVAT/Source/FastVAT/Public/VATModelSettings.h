@@ -35,6 +35,31 @@ namespace VATParamNames
 	static const FName UseUV3 = TEXT("UseUV3");
 	static const FName UseTwoInfluences = TEXT("UseTwoInfluences");
 	static const FName UseFourInfluences = TEXT("UseFourInfluences");
+	static const FName BasisTexture = TEXT("BasisTexture");
+	static const FName NormalBasisTexture = TEXT("NormalBasisTexture");
+	static const FName CoefficientTexture = TEXT("CoefficientTexture");
+	static const FName NumBasis = TEXT("NumBasis");
+	static const FName BasisRangeTexture = TEXT("BasisRangeTexture");
+	static const FName FrameRemapTexture = TEXT("FrameRemapTexture");
+	static const FName PageTableTexture = TEXT("PageTableTexture");
+	static const FName NumStoredFrames = TEXT("NumStoredFrames");
+	static const FName NumTemporalMips = TEXT("NumTemporalMips");
+	static const FName TemporalMipDistance = TEXT("TemporalMipDistance");
+	static const FName BoneIndicesTexture = TEXT("BoneIndicesTexture");
+	static const FName BoneMatrixTexture = TEXT("BoneMatrixTexture");
+	static const FName BoneRealTexture = TEXT("BoneRealTexture");
+	static const FName BoneDualTexture = TEXT("BoneDualTexture");
+	static const FName ResidualTexture = TEXT("ResidualTexture");
+	static const FName ResidualIndexTexture = TEXT("ResidualIndexTexture");
+	static const FName ResidualMinBBox = TEXT("ResidualMinBBox");
+	static const FName ResidualSizeBBox = TEXT("ResidualSizeBBox");
+	static const FName ResidualRowsPerFrame = TEXT("ResidualRowsPerFrame");
+	static const FName VertexMinBBox = TEXT("VertexMinBBox");
+	static const FName VertexSizeBBox = TEXT("VertexSizeBBox");
+	static const FName VertexRowsPerFrame = TEXT("VertexRowsPerFrame");
+	static const FName LookupTexture = TEXT("LookupTexture");
+	static const FName AtlasLOD = TEXT("AtlasLOD");
+	static const FName UseVariants = TEXT("UseVariants");
 }
 
 UENUM()
@@ -42,6 +67,10 @@ enum class EVATModelMode : uint8
 {
 	Vertex,
 	Bone,
+	/* Vertex deltas compressed into a PCA basis and per-frame coefficients */
+	CompressedVertex,
+	/* Vertex animation fitted to virtual bones and baked as Bone Mode textures */
+	SkinningDecomposition,
 };
 
 UENUM(Blueprintable)
@@ -53,6 +82,30 @@ enum class EVATPrecision : uint8
 	SixteenBits,
 };
 
+UENUM(Blueprintable)
+enum class EVATTextureLayout : uint8
+{
+	/* All frames in a single texture */
+	Single,
+	/* Frames spill across the pages (slices) of a Texture2DArray */
+	Paged,
+	/* Animations are packed whole into the pages (slices) of a Texture2DArray. Pages are sized to the largest animation */
+	PerAnimation,
+	/* Frames of each vertex are vertically adjacent, so a single bilinear sample blends two frames. Vertex Mode only */
+	Interleaved,
+};
+
+UENUM(Blueprintable)
+enum class EVATBoneEncoding : uint8
+{
+	/* Position delta and axis-angle rotation relative to the RefPose, in two textures */
+	AxisAngle,
+	/* Three rows of the RefToLocal matrix of each bone. Skinning is three dot products per influence */
+	MatrixPalette,
+	/* Dual Quaternion of each bone, in two textures. Blending preserves volume at twisting joints */
+	DualQuaternion,
+};
+
 UENUM(Blueprintable)
 enum class EVATNumBoneInfluences : uint8
 {
@@ -75,6 +128,52 @@ struct FVATAnimInfo
 	UPROPERTY(VisibleAnywhere, Category = Default, BlueprintReadOnly)
 	int32 EndFrame = 0;
 
+	/* Playback rate of the baked frames */
+	UPROPERTY(VisibleAnywhere, Category = Default, BlueprintReadOnly)
+	float SampleRate = 30.0f;
+
+	/* Frames resolved to data stored by another animation (first LOD).
+	*  Frames are referenced through the FrameRemap indirection table. */
+	UPROPERTY(VisibleAnywhere, Category = Default, BlueprintReadOnly)
+	int32 NumSharedFrames = 0;
+
+	/* First Texture2DArray page (slice) storing this animation (first LOD). Only used with Paged Texture Layouts */
+	UPROPERTY(VisibleAnywhere, Category = Default, BlueprintReadOnly)
+	int32 FirstPage = 0;
+
+	/* Number of Texture2DArray pages (slices) storing this animation (first LOD). Only used with Paged Texture Layouts */
+	UPROPERTY(VisibleAnywhere, Category = Default, BlueprintReadOnly)
+	int32 NumPages = 0;
+
+};
+
+/* Per-LOD info generated by CompressedVertex Mode */
+USTRUCT(Blueprintable)
+struct FVATBasisInfo
+{
+	GENERATED_BODY()
+
+	/* Number of basis vectors (not including the mean) */
+	UPROPERTY(VisibleAnywhere, Category = Default, BlueprintReadOnly)
+	int32 NumBasis = 0;
+
+	/* RMS vertex error (cm) of the reconstruction */
+	UPROPERTY(VisibleAnywhere, Category = Default, BlueprintReadOnly)
+	float Error = 0.f;
+
+	/* Bounding Box of the mean deltas. Each basis is quantized with its own range, see BasisRangeTexture */
+	UPROPERTY(VisibleAnywhere, Category = Default, BlueprintReadOnly)
+	FVector3f MinBBox = FVector3f::ZeroVector;
+
+	UPROPERTY(VisibleAnywhere, Category = Default, BlueprintReadOnly)
+	FVector3f SizeBBox = FVector3f::ZeroVector;
+
+	/* Bounding Box of the mean normals */
+	UPROPERTY(VisibleAnywhere, Category = Default, BlueprintReadOnly)
+	FVector3f NormalMinBBox = FVector3f::ZeroVector;
+
+	UPROPERTY(VisibleAnywhere, Category = Default, BlueprintReadOnly)
+	FVector3f NormalSizeBBox = FVector3f::ZeroVector;
 };
 
 USTRUCT(Blueprintable)
@@ -100,6 +199,14 @@ struct FVATAnimSequenceInfo
 	UPROPERTY(EditAnywhere, Category = Default, BlueprintReadWrite)
 	int32 EndFrame = 0;
 
+	/* Use Custom SampleRate instead of the Model SampleRate */
+	UPROPERTY(EditAnywhere, Category = Default, BlueprintReadWrite)
+	bool bUseCustomSampleRate = false;
+
+	/* Animation SampleRate. The animation time range is sampled at this rate */
+	UPROPERTY(EditAnywhere, Category = Default, BlueprintReadWrite, meta = (ClampMin = "1.0", EditCondition = "bUseCustomSampleRate"))
+	float SampleRate = 30.0f;
+
 };
 
 /**
@@ -127,12 +234,33 @@ public:
 	/** 
 	* Bone used for Rigid Binding. The bone needs to be part of the RawBones. 
 	* Sockets and VirtualBones are not supported.
+	* All vertices follow the bone with a single influence, so only this bone is baked, without the StaticMesh mapping
+	* or a BoneWeight texture. This is only used on Bone Mode
 	*/
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Animation")
 	FName AttachToSocket;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Animation")
 	float SampleRate = 30.0f;
+
+	/**
+	* Lowers the SampleRate of each animation while the interpolated frames stay within SampleRateErrorTolerance.
+	* Rates are integer fractions of the animation SampleRate, so slow animations use fewer frames.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Animation")
+	bool bAutoSampleRate = false;
+
+	/**
+	* Maximum vertex error (cm) of the interpolated frames for Auto SampleRate.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Animation", meta = (ClampMin = "0.0", EditCondition = "bAutoSampleRate"))
+	float SampleRateErrorTolerance = 0.1f;
+
+	/**
+	* Lowest SampleRate picked by Auto SampleRate.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Animation", meta = (ClampMin = "1.0", EditCondition = "bAutoSampleRate"))
+	float MinSampleRate = 5.0f;
 	
 	/**
 	* Number of Driver Triangles
@@ -171,12 +299,224 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Texture")
 	bool bEnforcePowerOfTwo = false;
 
+	/**
+	* Picks the resolution with the smallest padded GPU allocation (each dimension rounded up to a power of two),
+	* instead of the smallest number of texels.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Texture")
+	bool bMinimizePaddedTextureSize = false;
+
+	/**
+	* Reorders vertex texels for texture cache locality.
+	* Vertices get texels in post-transform cache order (Tipsify), in tiles within each frame block.
+	* Only the texels change: the StaticMesh build keeps the engine's own cache optimized triangle order.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Texture")
+	bool bOptimizeVertexOrder = false;
+
+	/**
+	* Generates temporal mips for Vertex Mode textures. Each mip level halves the texture dimensions and keeps every fourth
+	* frame of the previous level (Level L plays at 1/4^L of the frame rate), so distant instances fetch less data.
+	* Playback stays within the StartFrame and EndFrame of the animation.
+	* The shader addresses the mips directly, so the textures never stream: they stay fully resident and take about
+	* a third more memory than a plain bake. The gain is fetch bandwidth and cache locality, not memory.
+	* Requires bEnforcePowerOfTwo, and no Keyframe Reduction or Frame Deduplication.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Texture")
+	bool bTemporalMips = false;
+
+	/**
+	* Maximum number of temporal mip levels, including the full frame rate level.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Texture", meta = (EditCondition = "bTemporalMips", ClampMin = "1", ClampMax = "8"))
+	int32 MaxNumTemporalMips = 4;
+
 	/**
 	* Texture Precision
 	*/
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Texture")
 	EVATPrecision Precision = EVATPrecision::EightBits;
 
+	/**
+	* Stores bone indices as exact integers in a separate 16 bit float texture, while weights keep the texture Precision.
+	* Removes the 256 bone limit of 8 bit Precision (up to 2048 bones). This is only used on Bone Mode
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Texture")
+	bool bIntegerBoneIndices = false;
+
+	/**
+	* Stores the four bone indices and weights of each vertex in the StaticMesh UVChannel and the next one,
+	* instead of the BoneWeight texture. Removes a dependent texture read per vertex. This is only used on Bone Mode
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Texture")
+	bool bSkinWeightsInUVs = false;
+
+	/**
+	* StaticMesh sections skinned to a single bone (props, armour) store the bone in the VAT UVChannel
+	* and skip the BoneWeight texture read. Only one bone is fetched per vertex. This is only used on Bone Mode
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Texture")
+	bool bRigidSections = false;
+
+	/**
+	* Hybrid Bone Mode. Also bakes the residual of each vertex (ground truth minus bone skinning), keeping corrective detail
+	* such as muscles, cloth and faces. Only vertices with a residual over the threshold are stored, in a sparse 8 bit
+	* Residual texture addressed by a ResidualIndex texture. This is only used on Bone Mode
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Texture")
+	bool bBakeResiduals = false;
+
+	/**
+	* Residual length (cm) over which a vertex stores its residuals.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Texture", meta = (ClampMin = "0.0", EditCondition = "bBakeResiduals"))
+	float ResidualThreshold = 0.1f;
+
+	/**
+	* Per-section bake mode. StaticMesh sections (section index of each LOD) baked in Vertex Mode, such as capes and faces.
+	* Their vertices store deltas and normals in the Vertex textures and skip skinning, the other sections keep Bone Mode.
+	* Requires a Single Texture Layout. This is only used on Bone Mode
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Texture")
+	TArray<int32> VertexSections;
+
+	/**
+	* Encoding of the bone transforms. MatrixPalette stores three texels per bone and frame, and skins without trigonometry.
+	* DualQuaternion stores a Real and a Dual texture, and skins without the volume loss of linear blending.
+	* Both are always 16 bit and require a Single Texture Layout. This is only used on Bone Mode
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Texture")
+	EVATBoneEncoding BoneEncoding = EVATBoneEncoding::AxisAngle;
+
+	/**
+	* Texture Layout of the per-frame data.
+	* Paged layouts can bake data larger than MaxWidth x MaxHeight. They use a Texture2DArray and a page table.
+	* PerAnimation layouts pack each animation into its own pages, so only the pages of the playing animations are needed.
+	* Interleaved layouts halve the fetches of interpolated playback (Vertex Mode).
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Texture")
+	EVATTextureLayout TextureLayout = EVATTextureLayout::Single;
+
+	/**
+	* Maximum number of basis vectors used by CompressedVertex Mode.
+	* Each basis adds a block of vertex texels and a coefficient per frame.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Compression", meta = (ClampMin = "1", ClampMax = "256"))
+	int32 MaxNumBasis = 64;
+
+	/**
+	* Maximum RMS vertex error (cm) allowed by CompressedVertex Mode.
+	* The smallest number of basis vectors under this error will be used.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Compression", meta = (ClampMin = "0.0"))
+	float BasisErrorTolerance = 0.1f;
+
+	/**
+	* Drops frames that can be interpolated from their neighbours within KeyframeErrorTolerance.
+	* A frame remap texture keeps the animations playing at their authored duration.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Compression")
+	bool bReduceKeyframes = false;
+
+	/**
+	* Maximum vertex error (cm) of the interpolated frames.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Compression", meta = (ClampMin = "0.0", EditCondition = "bReduceKeyframes"))
+	float KeyframeErrorTolerance = 0.05f;
+
+	/**
+	* Trims static leading and trailing frames of each animation.
+	* Trimmed frames hold the first (or last) moving frame.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Compression", meta = (EditCondition = "bReduceKeyframes"))
+	bool bTrimStaticFrames = true;
+
+	/**
+	* Vertices whose delta stays under the Static Vertex Tolerance in every frame (helmets, rigid props, the lower body
+	* of upper body clips) get no texels. Their UV is (-1, -1) and the material keeps them at rest. This is only used on Vertex Mode
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Compression")
+	bool bSkipStaticVertices = false;
+
+	/**
+	* Max delta (cm) of a static vertex.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Compression", meta = (ClampMin = "0.0", EditCondition = "bSkipStaticVertices"))
+	float StaticVertexTolerance = 0.01f;
+
+	/**
+	* Bakes only the bones referenced by the skin weights of the baked LODs (and KeepBones / AttachToSocket).
+	* IK targets, twist helpers and other unskinned bones are skipped, so bone textures are smaller. This is only used on Bone Mode
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Compression")
+	bool bCullUnusedBones = false;
+
+	/**
+	* Bones baked even without skinned vertices, e.g. bones driving sockets.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Compression", meta = (EditCondition = "bCullUnusedBones"))
+	TArray<FName> KeepBones;
+
+	/**
+	* Orders the baked bones by importance (skin weight of the bone and its children), so following LODs skin with a prefix of the bones.
+	* Bones under the LOD importance threshold are collapsed into their closest kept parent. This is only used on Bone Mode
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Compression")
+	bool bReduceBoneLODs = false;
+
+	/**
+	* Importance (fraction of the total skin weight of the bone and its children) under which bones are collapsed on LOD 1.
+	* The threshold doubles on each following LOD.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Compression", meta = (ClampMin = "0.0", ClampMax = "1.0", EditCondition = "bReduceBoneLODs"))
+	float BoneLODImportanceThreshold = 0.005f;
+
+	/**
+	* Drops bone influences lighter than the pruning threshold and renormalizes the remaining ones.
+	* Material instances only enable as many influences as the LOD needs. This is only used on Bone Mode
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Compression")
+	bool bPruneInfluences = false;
+
+	/**
+	* Weight (fraction) under which a bone influence is dropped.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Compression", meta = (ClampMin = "0.0", ClampMax = "0.5", EditCondition = "bPruneInfluences"))
+	float InfluencePruningThreshold = 0.05f;
+
+	/**
+	* Stores identical (or near-identical) frames once, across all animations.
+	* Frames are referenced through the FrameRemap indirection table.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Compression")
+	bool bDeduplicateFrames = false;
+
+	/**
+	* Maximum vertex error (cm) between merged frames.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Compression", meta = (ClampMin = "0.0", EditCondition = "bDeduplicateFrames"))
+	float FrameDeduplicationTolerance = 0.01f;
+
+	/**
+	* Number of virtual bones fitted by SkinningDecomposition Mode.
+	* More bones reduce the error at the cost of larger bone textures.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SkinningDecomposition", meta = (ClampMin = "1", ClampMax = "256"))
+	int32 NumVirtualBones = 32;
+
+	/**
+	* Target RMS vertex error (cm) for SkinningDecomposition Mode.
+	* Fitting stops once the error is under this value.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SkinningDecomposition", meta = (ClampMin = "0.0"))
+	float DecompositionErrorTolerance = 0.1f;
+
+	/**
+	* Maximum number of fitting iterations for SkinningDecomposition Mode.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SkinningDecomposition", meta = (ClampMin = "0"))
+	int32 MaxDecompositionIterations = 20;
+
 	/**
 	* AutoPlay will use Engine Time for driving the animation.
 	* This will be used by UpdateMaterialInstanceFromDataAsset and AssetActions for setting MaterialInstance static switches
@@ -206,4 +546,29 @@ public:
 	*/
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Material")
 	EVATNumBoneInfluences NumBoneInfluences = EVATNumBoneInfluences::Four;
+
+	/**
+	* Camera distance (cm) at which the first temporal mip is used. Each following mip doubles the distance.
+	* This will be used by UpdateMaterialInstanceFromDataAsset
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Material", meta = (EditCondition = "bTemporalMips", ClampMin = "0.0"))
+	float TemporalMipDistance = 2000.f;
+
+	/* Returns true if all vertices follow the AttachToSocket bone */
+	bool UsesSocketBinding() const { return !AttachToSocket.IsNone(); }
+
+	/* Returns true if rigid sections store their bone in the VAT UVChannel */
+	bool UsesRigidSections() const { return (bRigidSections || UsesSocketBinding()) && !bSkinWeightsInUVs; }
+
+	/* Returns true if some sections are baked in Vertex Mode */
+	bool UsesVertexSections() const { return VertexSections.Num() > 0; }
+
+	/* Returns true if frames are addressed through the FrameRemap texture */
+	bool UsesFrameRemap() const { return bReduceKeyframes || bDeduplicateFrames; }
+
+	/* Returns true if per-frame data is stored in Texture2DArray pages */
+	bool UsesPagedTextures() const { return TextureLayout == EVATTextureLayout::Paged || TextureLayout == EVATTextureLayout::PerAnimation; }
+
+	/* Returns true if the frames of each element are stored in adjacent rows */
+	bool UsesInterleavedFrames() const { return TextureLayout == EVATTextureLayout::Interleaved; }
 };
\ No newline at end of file
@@ -31,6 +31,7 @@ public class FastVATEditor : ModuleRules
                 "Slate",
                 "SlateCore", 
                 "UnrealEd", 
+                "RHI",
             }
         );
     }
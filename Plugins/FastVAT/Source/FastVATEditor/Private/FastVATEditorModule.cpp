@@ -9,6 +9,8 @@ void FFastVATEditorModule::StartupModule()
 {
 	VATModelAssetTypeActions = MakeShared<FVATModelAssetTypeActions>();
 	FAssetToolsModule::GetModule().Get().RegisterAssetTypeActions(VATModelAssetTypeActions.ToSharedRef());
+	VATAtlasAssetTypeActions = MakeShared<FVATAtlasAssetTypeActions>();
+	FAssetToolsModule::GetModule().Get().RegisterAssetTypeActions(VATAtlasAssetTypeActions.ToSharedRef());
 	
 	// Register commands
 	FVATModelEditorCommands::Register();
@@ -27,6 +29,7 @@ void FFastVATEditorModule::ShutdownModule()
 	}
 	
 	FAssetToolsModule::GetModule().Get().UnregisterAssetTypeActions(VATModelAssetTypeActions.ToSharedRef()); 
+	FAssetToolsModule::GetModule().Get().UnregisterAssetTypeActions(VATAtlasAssetTypeActions.ToSharedRef());
 	
 }
 
@@ -0,0 +1,51 @@
+﻿#include "VATAtlasAssetTypeActions.h"
+
+#include "ToolMenuSection.h"
+#include "VATAtlas.h"
+#include "VATAtlasBuilder.h"
+
+UClass* FVATAtlasAssetTypeActions::GetSupportedClass() const
+{
+	return UVATAtlas::StaticClass();
+}
+
+FText FVATAtlasAssetTypeActions::GetName() const
+{
+	return INVTEXT("VAT Atlas");
+}
+
+FColor FVATAtlasAssetTypeActions::GetTypeColor() const
+{
+	return FColor::Red;
+}
+
+uint32 FVATAtlasAssetTypeActions::GetCategories()
+{
+	return EAssetTypeCategories::Animation;
+}
+
+bool FVATAtlasAssetTypeActions::HasActions(const TArray<UObject*>& InObjects) const
+{
+	return true;
+}
+
+void FVATAtlasAssetTypeActions::GetActions(const TArray<UObject*>& InObjects, FToolMenuSection& Section)
+{
+	const TArray<TWeakObjectPtr<UVATAtlas>> Atlases = GetTypedWeakObjectPtrs<UVATAtlas>(InObjects);
+
+	Section.AddMenuEntry(
+		"VATAtlas_Build",
+		INVTEXT("Build Atlas"),
+		INVTEXT("Packs the Vertex textures of the Models into the shared textures and creates the shared material."),
+		FSlateIcon(),
+		FUIAction(FExecuteAction::CreateLambda([Atlases]()
+		{
+			for (const TWeakObjectPtr<UVATAtlas>& Atlas : Atlases)
+			{
+				if (Atlas.IsValid())
+				{
+					FVATAtlasBuilder::BuildAtlas(Atlas.Get());
+				}
+			}
+		})));
+}
@@ -0,0 +1,561 @@
+﻿#include "VATAtlasBuilder.h"
+
+#include "AssetToolsModule.h"
+#include "EditorAssetLibrary.h"
+#include "MaterialEditingLibrary.h"
+#include "StaticMeshAttributes.h"
+#include "StaticMeshOperations.h"
+#include "VATAtlas.h"
+#include "VATMaterialLayerBuilder.h"
+#include "VATModel.h"
+#include "VATUtils.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Factories/MaterialFactoryNew.h"
+#include "Factories/MaterialInstanceConstantFactoryNew.h"
+#include "Factories/TextureFactory.h"
+#include "Materials/Material.h"
+#include "Materials/MaterialExpressionMaterialAttributeLayers.h"
+#include "Materials/MaterialFunctionMaterialLayer.h"
+#include "Materials/MaterialInstanceConstant.h"
+
+bool FVATAtlasBuilder::BuildAtlas(UVATAtlas* Atlas)
+{
+	check(Atlas);
+
+	if (!CheckAtlas(Atlas))
+	{
+		return false;
+	}
+
+	// ---------------------------------------------------------------------------
+	// Entries. Every LOD of every model is stacked below the previous one
+	//
+	TArray<FVATAtlasEntry> Entries;
+	TArray<UTexture2D*> PositionTextures;
+	TArray<UTexture2D*> NormalTextures;
+	TArray<int32> RowOffsets;
+	int32 Height = 0;
+	int32 Width = 0;
+	int32 NumLODs = 0;
+	int32 NumUVChannels = 0;
+
+	for (UVATModel* Model : Atlas->Models)
+	{
+		const int32 NumModelLODs = Model->VertexRowsPerFrame.Num();
+		NumLODs = FMath::Max(NumLODs, NumModelLODs);
+
+		for (int32 LODIndex = 0; LODIndex < NumModelLODs; LODIndex++)
+		{
+			UTexture2D* PositionTexture = Model->GetVertexPositionTexture(LODIndex);
+
+			FVATAtlasEntry& Entry = Entries.AddDefaulted_GetRef();
+			Entry.Model = Model;
+			Entry.LODIndex = LODIndex;
+			Entry.RowOffset = Height;
+			Entry.RowsPerFrame = Model->VertexRowsPerFrame[LODIndex];
+			Entry.Width = PositionTexture->Source.GetSizeX();
+			Entry.Height = PositionTexture->Source.GetSizeY();
+
+			PositionTextures.Add(PositionTexture);
+			NormalTextures.Add(Model->GetVertexNormalTexture(LODIndex));
+			RowOffsets.Add(Height);
+
+			Height += Entry.Height;
+			Width = FMath::Max(Width, Entry.Width);
+
+			if (Atlas->bMergeMeshes)
+			{
+				NumUVChannels = FMath::Max(NumUVChannels, Model->GetStaticMesh()->GetNumUVChannels(LODIndex));
+			}
+		}
+	}
+
+	if (Height > Atlas->MaxHeight)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s: Models need %d rows, over the MaxHeight: %d"), *Atlas->GetName(), Height, Atlas->MaxHeight);
+		return false;
+	}
+
+	// Variants are stored after the UVChannels of every model
+	if (Atlas->bMergeMeshes && NumUVChannels >= MAX_MESH_TEXTURE_COORDS_MD)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s: No UVChannel left for the variants. Models use %d UVChannels"), *Atlas->GetName(), NumUVChannels);
+		return false;
+	}
+
+	Atlas->Entries = MoveTemp(Entries);
+	Atlas->NumLODs = NumLODs;
+	Atlas->VariantUVChannel = Atlas->bMergeMeshes ? NumUVChannels : INDEX_NONE;
+
+	// ---------------------------------------------------------------------------
+	// Textures
+	//
+	const FString OutDirectoryPath = GetOutDirectoryPath(Atlas);
+	if (UEditorAssetLibrary::DoesDirectoryExist(OutDirectoryPath))
+	{
+		UEditorAssetLibrary::DeleteDirectory(OutDirectoryPath);
+	}
+	UEditorAssetLibrary::MakeDirectory(OutDirectoryPath);
+
+	UTexture2D* PositionTexture = CreateTexture2DAsset(FPaths::Combine(OutDirectoryPath, "TX_VATAtlas_" + Atlas->GetName() + "_VertexPosition"));
+	UTexture2D* NormalTexture = CreateTexture2DAsset(FPaths::Combine(OutDirectoryPath, "TX_VATAtlas_" + Atlas->GetName() + "_VertexNormal"));
+	UTexture2D* LookupTexture = CreateTexture2DAsset(FPaths::Combine(OutDirectoryPath, "TX_VATAtlas_" + Atlas->GetName() + "_Lookup"));
+	if (!PositionTexture || !NormalTexture || !LookupTexture)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s: Unable to create the Atlas textures"), *Atlas->GetName());
+		return false;
+	}
+
+	// All the models share the Precision (see CheckAtlas)
+	bool bWritten;
+	if (Atlas->Models[0]->Settings->Precision == EVATPrecision::SixteenBits)
+	{
+		bWritten = CopyTextureRows<FHighPrecision>(PositionTextures, RowOffsets, Height, Width, PositionTexture) &&
+			CopyTextureRows<FHighPrecision>(NormalTextures, RowOffsets, Height, Width, NormalTexture);
+	}
+	else
+	{
+		bWritten = CopyTextureRows<FLowPrecision>(PositionTextures, RowOffsets, Height, Width, PositionTexture) &&
+			CopyTextureRows<FLowPrecision>(NormalTextures, RowOffsets, Height, Width, NormalTexture);
+	}
+
+	if (!bWritten || !WriteLookupTexture(Atlas, LookupTexture))
+	{
+		return false;
+	}
+
+	Atlas->PositionTexture = PositionTexture;
+	Atlas->NormalTexture = NormalTexture;
+	Atlas->LookupTexture = LookupTexture;
+
+	// ---------------------------------------------------------------------------
+	// Materials. Per-LOD instances select the LOD column of the Lookup table
+	//
+	UMaterialFunctionMaterialLayer* Layer = CreateMaterialLayer(Atlas);
+	UMaterial* Material = Layer ? CreateMaterial(Atlas, Layer) : nullptr;
+	if (!Material)
+	{
+		return false;
+	}
+
+	Atlas->MaterialLayer = Layer;
+	Atlas->Material = Material;
+	if (!CreateMaterialInstances(Atlas, Material, TEXT("MI_VATAtlas"), false, Atlas->MaterialInstances))
+	{
+		return false;
+	}
+
+	// ---------------------------------------------------------------------------
+	// Merged Mesh. Instances select their variant with the Model ID
+	//
+	Atlas->MergedStaticMesh = nullptr;
+	Atlas->MergedMaterialInstances.Reset();
+	if (Atlas->bMergeMeshes)
+	{
+		if (!CreateMaterialInstances(Atlas, Material, TEXT("MI_VATAtlas_Merged"), true, Atlas->MergedMaterialInstances))
+		{
+			return false;
+		}
+
+		Atlas->MergedStaticMesh = CreateMergedStaticMesh(Atlas);
+		if (!Atlas->MergedStaticMesh)
+		{
+			return false;
+		}
+	}
+
+	Atlas->MarkPackageDirty();
+
+	UE_LOG(LogTemp, Log, TEXT("%s: Packed %d Models (%d LODs) in %dx%d textures"), *Atlas->GetName(), Atlas->Models.Num(), NumLODs, Width, Height);
+
+	return true;
+}
+
+bool FVATAtlasBuilder::CheckAtlas(const UVATAtlas* Atlas)
+{
+	if (Atlas->Models.IsEmpty())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s: No Models"), *Atlas->GetName());
+		return false;
+	}
+
+	for (int32 ModelIndex = 0; ModelIndex < Atlas->Models.Num(); ModelIndex++)
+	{
+		const UVATModel* Model = Atlas->Models[ModelIndex];
+		if (!Model || !Model->Settings)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("%s: Invalid Model: %d"), *Atlas->GetName(), ModelIndex);
+			return false;
+		}
+
+		// The atlas stacks plain Vertex textures, addressed by the model VertexUVs
+		if (Model->Mode != EVATModelMode::Vertex)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("%s: Model %s is not on Vertex Mode"), *Atlas->GetName(), *Model->GetName());
+			return false;
+		}
+
+		if (Model->Settings->UsesFrameRemap() || Model->Settings->UsesPagedTextures() || Model->Settings->UsesInterleavedFrames() ||
+			Model->Settings->bTemporalMips)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("%s: Model %s must use a Single Texture Layout without Keyframe Reduction, Frame Deduplication or Temporal Mips"),
+				*Atlas->GetName(), *Model->GetName());
+			return false;
+		}
+
+		// Shared textures and VertexUV input
+		const UVATModel* FirstModel = Atlas->Models[0];
+		if (Model->Settings->Precision != FirstModel->Settings->Precision || Model->UVChannel != FirstModel->UVChannel)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("%s: Model %s Precision and UVChannel must match %s"), *Atlas->GetName(), *Model->GetName(), *FirstModel->GetName());
+			return false;
+		}
+
+		if (Atlas->bMergeMeshes && !Model->GetStaticMesh())
+		{
+			UE_LOG(LogTemp, Warning, TEXT("%s: Model %s has no StaticMesh"), *Atlas->GetName(), *Model->GetName());
+			return false;
+		}
+
+		if (Model->VertexRowsPerFrame.IsEmpty() || Model->VertexPositionTextures.Num() < Model->VertexRowsPerFrame.Num() ||
+			Model->VertexNormalTextures.Num() < Model->VertexRowsPerFrame.Num())
+		{
+			UE_LOG(LogTemp, Warning, TEXT("%s: Model %s is not generated"), *Atlas->GetName(), *Model->GetName());
+			return false;
+		}
+
+		// The Lookup table stores a single SampleRate per model, shared by all its animations
+		for (const FVATAnimInfo& AnimInfo : Model->Animations)
+		{
+			if (!FMath::IsNearlyEqual(AnimInfo.SampleRate, Model->Animations[0].SampleRate))
+			{
+				UE_LOG(LogTemp, Warning, TEXT("%s: Model %s animations must share the same SampleRate"), *Atlas->GetName(), *Model->GetName());
+				return false;
+			}
+		}
+
+		for (int32 LODIndex = 0; LODIndex < Model->VertexRowsPerFrame.Num(); LODIndex++)
+		{
+			if (!Model->GetVertexPositionTexture(LODIndex) || !Model->GetVertexNormalTexture(LODIndex))
+			{
+				UE_LOG(LogTemp, Warning, TEXT("%s: Model %s is missing the LOD %d Vertex textures"), *Atlas->GetName(), *Model->GetName(), LODIndex);
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+FString FVATAtlasBuilder::GetOutDirectoryPath(const UVATAtlas* Atlas)
+{
+	const FString PackageName = Atlas->GetOutermost()->GetName();
+	const FString PackagePath = FPackageName::GetLongPackagePath(PackageName);
+	return FPaths::Combine(PackagePath, Atlas->GetName() + "_GeneratedVAT");
+}
+
+UTexture2D* FVATAtlasBuilder::CreateTexture2DAsset(const FString& Path)
+{
+	FString PackageName;
+	FString Name;
+	IAssetTools::Get().CreateUniqueAssetName(Path, "", /*out*/ PackageName, /*out*/ Name);
+
+	UTextureFactory* TextureFactory = NewObject<UTextureFactory>();
+	UTexture2D* NewAsset = TextureFactory->CreateTexture2D(CreatePackage(*PackageName), FName(Name), RF_Standalone | RF_Public);
+
+	UE_LOG(LogTemp, Log, TEXT("Creating %s"), *PackageName);
+
+	if (NewAsset)
+	{
+		NewAsset->SRGB = false;
+		NewAsset->MarkPackageDirty();
+		FAssetRegistryModule::AssetCreated(NewAsset);
+	}
+
+	return NewAsset;
+}
+
+template<class TextureSettings>
+bool FVATAtlasBuilder::CopyTextureRows(const TArray<UTexture2D*>& SourceTextures, const TArray<int32>& RowOffsets,
+	const int32 Height, const int32 Width, UTexture2D* Texture)
+{
+	using ColorType = typename TextureSettings::ColorType;
+
+	TArray<ColorType> Pixels;
+	Pixels.Init(TextureSettings::DefaultColor, Height * Width);
+
+	for (int32 Index = 0; Index < SourceTextures.Num(); Index++)
+	{
+		FTextureSource& Source = SourceTextures[Index]->Source;
+		if (Source.GetFormat() != TextureSettings::TextureSourceFormat)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Invalid Texture Format: %s"), *SourceTextures[Index]->GetName());
+			return false;
+		}
+
+		TArray64<uint8> MipData;
+		if (!Source.GetMipData(MipData, 0, 0, 0))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Unable to read Texture: %s"), *SourceTextures[Index]->GetName());
+			return false;
+		}
+
+		const int32 SourceWidth = Source.GetSizeX();
+		const int32 SourceHeight = Source.GetSizeY();
+		check(MipData.Num() >= (int64)SourceWidth * SourceHeight * sizeof(ColorType));
+
+		const ColorType* SourcePixels = reinterpret_cast<const ColorType*>(MipData.GetData());
+		for (int32 Row = 0; Row < SourceHeight; Row++)
+		{
+			FMemory::Memcpy(&Pixels[(RowOffsets[Index] + Row) * Width], &SourcePixels[Row * SourceWidth], SourceWidth * sizeof(ColorType));
+		}
+	}
+
+	return FVATUtils::WriteToTexture<TextureSettings>(Texture, Height, Width, Pixels);
+}
+
+bool FVATAtlasBuilder::WriteLookupTexture(const UVATAtlas* Atlas, UTexture2D* Texture)
+{
+	const int32 Width = Atlas->NumLODs * 3;
+	const int32 Height = Atlas->Models.Num();
+
+	TArray<FLinearColor> Pixels;
+	Pixels.Init(FFullPrecision::DefaultColor, Height * Width);
+
+	for (int32 ModelIndex = 0; ModelIndex < Atlas->Models.Num(); ModelIndex++)
+	{
+		const UVATModel* Model = Atlas->Models[ModelIndex];
+
+		// SampleRate. All the animations of the model share it (see CheckAtlas)
+		const float SampleRate = Model->Animations.IsEmpty() ? Model->Settings->SampleRate : Model->Animations[0].SampleRate;
+
+		// Models with fewer LODs repeat their last LOD
+		const FVATAtlasEntry* Entry = nullptr;
+		for (int32 LODIndex = 0; LODIndex < Atlas->NumLODs; LODIndex++)
+		{
+			const FVATAtlasEntry* LODEntry = Atlas->Entries.FindByPredicate([Model, LODIndex](const FVATAtlasEntry& Other)
+			{
+				return Other.Model == Model && Other.LODIndex == LODIndex;
+			});
+			Entry = LODEntry ? LODEntry : Entry;
+			check(Entry);
+
+			FLinearColor* Texels = &Pixels[ModelIndex * Width + LODIndex * 3];
+			Texels[0] = FLinearColor(Entry->RowOffset, Entry->RowsPerFrame, Entry->Width, Entry->Height);
+			Texels[1] = FLinearColor(Model->VertexMinBBox.X, Model->VertexMinBBox.Y, Model->VertexMinBBox.Z, Model->NumFrames);
+			Texels[2] = FLinearColor(Model->VertexSizeBBox.X, Model->VertexSizeBBox.Y, Model->VertexSizeBBox.Z, SampleRate);
+		}
+	}
+
+	return FVATUtils::WriteToTexture<FFullPrecision>(Texture, Height, Width, Pixels);
+}
+
+UMaterialFunctionMaterialLayer* FVATAtlasBuilder::CreateMaterialLayer(const UVATAtlas* Atlas)
+{
+	FVATMaterialLayerBuilder Builder(TEXT("FastVAT Atlas Layer"));
+
+	Builder.AddInclude(TEXT("/Plugin/FastVAT/Private/VATCommon.ush"));
+	Builder.AddInclude(TEXT("/Plugin/FastVAT/Private/VATVertex.ush"));
+	Builder.AddTexCoord(TEXT("VertexUV"), Atlas->Models[0]->UVChannel);
+	Builder.AddTime(TEXT("Time"));
+	Builder.AddLocalNormal(TEXT("LocalNormal"));
+	Builder.AddStaticSwitchParameter(VATParamNames::AutoPlay, true);
+	Builder.AddScalarParameter(VATParamNames::AtlasLOD);
+	Builder.AddTextureParameter(VATParamNames::VertexPositionTexture, UVATModel::GetAsset(Atlas->PositionTexture));
+	Builder.AddTextureParameter(VATParamNames::VertexNormalTexture, UVATModel::GetAsset(Atlas->NormalTexture));
+	Builder.AddTextureParameter(VATParamNames::LookupTexture, UVATModel::GetAsset(Atlas->LookupTexture));
+
+	// Model and frame range of each instance
+	Builder.AddPerInstanceCustomData(TEXT("ModelID"), 0);
+	Builder.AddPerInstanceCustomData(TEXT("StartFrame"), 1);
+	Builder.AddPerInstanceCustomData(TEXT("EndFrame"), 2, -1.f);
+
+	// Vertices of the other variants of a merged mesh are collapsed
+	if (Atlas->bMergeMeshes)
+	{
+		Builder.AddTexCoord(TEXT("VariantUV"), Atlas->VariantUVChannel);
+		Builder.AddLocalPosition(TEXT("LocalPosition"));
+		Builder.AddStaticSwitchParameter(VATParamNames::UseVariants, false);
+		Builder.AddCode(TEXT("if (UseVariants > 0.5f && VATIsHiddenVariant(VariantUV.x, ModelID))"));
+		Builder.AddCode(TEXT("{"));
+		Builder.AddCode(TEXT("	Normal = LocalNormal;"));
+		Builder.AddCode(TEXT("	return -LocalPosition;"));
+		Builder.AddCode(TEXT("}"));
+	}
+
+	// Static vertices have no texels and stay at rest
+	Builder.AddCode(TEXT("if (VATIsStaticVertex(VertexUV))"));
+	Builder.AddCode(TEXT("{"));
+	Builder.AddCode(TEXT("	Normal = LocalNormal;"));
+	Builder.AddCode(TEXT("	return 0.0f;"));
+	Builder.AddCode(TEXT("}"));
+	Builder.AddCode(TEXT("return VATVertexAtlas(PositionTexture, NormalTexture, LookupTexture, VertexUV, ModelID, AtlasLOD,"));
+	Builder.AddCode(TEXT("	Time, AutoPlay, StartFrame, EndFrame, Normal);"));
+
+	return Builder.Build(GetOutDirectoryPath(Atlas), "ML_VATAtlas_" + Atlas->GetName());
+}
+
+UMaterial* FVATAtlasBuilder::CreateMaterial(const UVATAtlas* Atlas, UMaterialFunctionMaterialLayer* Layer)
+{
+	const FString AssetName = "M_VATAtlas_" + Atlas->GetName();
+
+	UMaterialFactoryNew* Factory = NewObject<UMaterialFactoryNew>();
+	UMaterial* Material = Cast<UMaterial>(IAssetTools::Get().CreateAsset(AssetName, GetOutDirectoryPath(Atlas), UMaterial::StaticClass(), Factory));
+	if (!Material)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Unable to create Material: %s"), *AssetName);
+		return nullptr;
+	}
+
+	UMaterialExpressionMaterialAttributeLayers* MatAttrLayers = Cast<UMaterialExpressionMaterialAttributeLayers>(
+		UMaterialEditingLibrary::CreateMaterialExpression(Material, UMaterialExpressionMaterialAttributeLayers::StaticClass(), -300, 0));
+	check(MatAttrLayers);
+
+	MatAttrLayers->DefaultLayers.Layers[0] = Layer;
+	MatAttrLayers->DefaultLayers.UnlinkLayerFromParent(0);
+
+	Material->bUseMaterialAttributes = true;
+	Material->bUsedWithInstancedStaticMeshes = true;
+	Material->bUsedWithNanite = true;
+	Material->bTangentSpaceNormal = false;
+
+	MatAttrLayers->ConnectExpression(&Material->GetEditorOnlyData()->MaterialAttributes, 0);
+
+	UMaterialEditingLibrary::LayoutMaterialExpressions(Material);
+	UMaterialEditingLibrary::RecompileMaterial(Material);
+
+	return Material;
+}
+
+bool FVATAtlasBuilder::CreateMaterialInstances(const UVATAtlas* Atlas, UMaterial* Material, const FString& Prefix, const bool bUseVariants,
+	TArray<TSoftObjectPtr<UMaterialInstanceConstant>>& OutMaterialInstances)
+{
+	OutMaterialInstances.Reset();
+
+	for (int32 LODIndex = 0; LODIndex < Atlas->NumLODs; LODIndex++)
+	{
+		UMaterialInstanceConstantFactoryNew* Factory = NewObject<UMaterialInstanceConstantFactoryNew>();
+		Factory->InitialParent = Material;
+
+		UMaterialInstanceConstant* MaterialInstance = Cast<UMaterialInstanceConstant>(IAssetTools::Get().CreateAsset(
+			FString::Printf(TEXT("%s_LOD_%d_%s"), *Prefix, LODIndex, *Atlas->GetName()), GetOutDirectoryPath(Atlas),
+			UMaterialInstanceConstant::StaticClass(), Factory));
+		if (!MaterialInstance)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("%s: Unable to create the LOD %d MaterialInstance"), *Atlas->GetName(), LODIndex);
+			return false;
+		}
+
+		UMaterialEditingLibrary::SetMaterialInstanceScalarParameterValue(MaterialInstance, VATParamNames::AtlasLOD, LODIndex, EMaterialParameterAssociation::LayerParameter);
+		if (bUseVariants)
+		{
+			UMaterialEditingLibrary::SetMaterialInstanceStaticSwitchParameterValue(MaterialInstance, VATParamNames::UseVariants, true, EMaterialParameterAssociation::LayerParameter);
+		}
+		OutMaterialInstances.Add(MaterialInstance);
+	}
+
+	return true;
+}
+
+UStaticMesh* FVATAtlasBuilder::CreateMergedStaticMesh(const UVATAtlas* Atlas)
+{
+	const int32 NumModels = Atlas->Models.Num();
+	const UStaticMesh* FirstStaticMesh = Atlas->Models[0]->GetStaticMesh();
+
+	const FString AssetName = "SM_VATAtlas_" + Atlas->GetName();
+	UStaticMesh* StaticMesh = NewObject<UStaticMesh>(CreatePackage(*FPaths::Combine(GetOutDirectoryPath(Atlas), AssetName)), FName(AssetName),
+		RF_Public | RF_Standalone | RF_Transactional);
+	if (!StaticMesh)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Unable to create StaticMesh: %s"), *AssetName);
+		return nullptr;
+	}
+
+	StaticMesh->SetNumSourceModels(Atlas->NumLODs);
+	StaticMesh->SetLightMapCoordinateIndex(FirstStaticMesh->GetLightMapCoordinateIndex());
+	StaticMesh->NaniteSettings = FirstStaticMesh->NaniteSettings;
+
+	TArray<FStaticMaterial> StaticMaterials;
+	FBox ModelsBox(ForceInit);
+
+	for (int32 LODIndex = 0; LODIndex < Atlas->NumLODs; LODIndex++)
+	{
+		FMeshDescription MeshDescription;
+		FStaticMeshAttributes Attributes(MeshDescription);
+		Attributes.Register();
+		Attributes.GetVertexInstanceUVs().SetNumChannels(Atlas->VariantUVChannel + 1);
+
+		// A single section for all the variants, so the merged LOD is drawn in one call
+		UMaterialInterface* MaterialInstance = UVATModel::GetAsset(Atlas->MergedMaterialInstances[LODIndex]);
+		const FName SlotName = *FString::Printf(TEXT("LOD_%d"), LODIndex);
+		const FPolygonGroupID PolygonGroup = MeshDescription.CreatePolygonGroup();
+		Attributes.GetPolygonGroupMaterialSlotNames()[PolygonGroup] = SlotName;
+
+		const int32 MaterialIndex = StaticMaterials.Add(FStaticMaterial(MaterialInstance, SlotName, SlotName));
+		StaticMesh->GetSectionInfoMap().Set(LODIndex, 0, FMeshSectionInfo(MaterialIndex));
+
+		for (int32 ModelIndex = 0; ModelIndex < NumModels; ModelIndex++)
+		{
+			const UVATModel* Model = Atlas->Models[ModelIndex];
+
+			// Models with fewer LODs repeat their last LOD
+			const int32 ModelLODIndex = FMath::Min(LODIndex, Model->GetStaticMesh()->GetNumSourceModels() - 1);
+			const FMeshDescription* SourceMeshDescription = Model->GetStaticMesh()->GetMeshDescription(ModelLODIndex);
+			if (!SourceMeshDescription)
+			{
+				UE_LOG(LogTemp, Warning, TEXT("%s: Model %s has no LOD %d MeshDescription"), *Atlas->GetName(), *Model->GetName(), ModelLODIndex);
+				return nullptr;
+			}
+
+			// Every polygon group of the model goes to the shared section
+			FStaticMeshOperations::FAppendSettings AppendSettings;
+			AppendSettings.PolygonGroupsDelegate = FStaticMeshOperations::FAppendPolygonGroupsDelegate::CreateLambda(
+				[PolygonGroup](const FMeshDescription& SourceMesh, FMeshDescription& TargetMesh, PolygonGroupMap& RemapPolygonGroups)
+				{
+					for (const FPolygonGroupID SourcePolygonGroup : SourceMesh.PolygonGroups().GetElementIDs())
+					{
+						RemapPolygonGroups.Add(SourcePolygonGroup, PolygonGroup);
+					}
+				});
+
+			// Appended vertex instances follow the existing ones
+			const int32 FirstVertexInstance = MeshDescription.VertexInstances().GetArraySize();
+			FStaticMeshOperations::AppendMeshDescription(*SourceMeshDescription, MeshDescription, AppendSettings);
+
+			TVertexInstanceAttributesRef<FVector2f> UVs = Attributes.GetVertexInstanceUVs();
+			for (int32 VertexInstance = FirstVertexInstance; VertexInstance < MeshDescription.VertexInstances().GetArraySize(); VertexInstance++)
+			{
+				UVs.Set(FVertexInstanceID(VertexInstance), Atlas->VariantUVChannel, FVector2f(ModelIndex, 0.f));
+			}
+
+			ModelsBox += Model->GetStaticMesh()->GetBoundingBox();
+		}
+
+		// Same build settings as the models. Generated lightmap UVs go before the VariantUVChannel
+		FStaticMeshSourceModel& SourceModel = StaticMesh->GetSourceModel(LODIndex);
+		SourceModel.BuildSettings = FirstStaticMesh->GetSourceModel(0).BuildSettings;
+		SourceModel.BuildSettings.bUseFullPrecisionUVs = true;
+
+		StaticMesh->CreateMeshDescription(LODIndex, MoveTemp(MeshDescription));
+		StaticMesh->CommitMeshDescription(LODIndex);
+	}
+
+	StaticMesh->SetStaticMaterials(StaticMaterials);
+
+	TArray<FText> OutErrors;
+	StaticMesh->Build(true, &OutErrors);
+
+	// Bounds cover the animated bounds of every model
+	const FBox BoundingBox = StaticMesh->GetBoundingBox();
+	StaticMesh->SetPositiveBoundsExtension((ModelsBox.Max - BoundingBox.Max).ComponentMax(FVector::ZeroVector));
+	StaticMesh->SetNegativeBoundsExtension((BoundingBox.Min - ModelsBox.Min).ComponentMax(FVector::ZeroVector));
+	StaticMesh->CalculateExtendedBounds();
+
+	StaticMesh->PostEditChange();
+	StaticMesh->MarkPackageDirty();
+	FAssetRegistryModule::AssetCreated(StaticMesh);
+
+	UE_LOG(LogTemp, Log, TEXT("%s: Merged %d Models in %s"), *Atlas->GetName(), NumModels, *AssetName);
+
+	return StaticMesh;
+}
@@ -0,0 +1,390 @@
+﻿#include "VATCompressionUtilities.h"
+
+#include "Async/ParallelFor.h"
+#include "Math/RandomStream.h"
+
+int32 FVATCompressionUtilities::ComputeBasis(const TArray<FVector3f>& Deltas, const TArray<FVector3f>& Normals,
+	const int32 NumFrames, const int32 NumVertices, const int32 MaxNumBasis, const float ErrorTolerance,
+	TArray<FVector3f>& OutDeltaBasis, TArray<FVector3f>& OutNormalBasis, TArray<float>& OutCoefficients,
+	float& OutError)
+{
+	check(Deltas.Num() == NumFrames * NumVertices);
+	check(Normals.Num() == NumFrames * NumVertices);
+
+	OutDeltaBasis.Reset();
+	OutNormalBasis.Reset();
+	OutCoefficients.Reset();
+	OutError = 0.f;
+
+	if (!NumFrames || !NumVertices)
+	{
+		return 0;
+	}
+
+	// Data is a NumFrames x NumDimensions matrix (one row per frame)
+	const int32 NumDimensions = NumVertices * 3;
+
+	// ---------------------------------------------------------------------------
+	// Mean
+	//
+	TArray<FVector3f> MeanDeltas;
+	TArray<FVector3f> MeanNormals;
+	MeanDeltas.SetNumZeroed(NumVertices);
+	MeanNormals.SetNumZeroed(NumVertices);
+
+	ParallelFor(NumVertices, [&](int32 VertexIndex)
+	{
+		for (int32 Frame = 0; Frame < NumFrames; Frame++)
+		{
+			MeanDeltas[VertexIndex] += Deltas[Frame * NumVertices + VertexIndex];
+			MeanNormals[VertexIndex] += Normals[Frame * NumVertices + VertexIndex];
+		}
+		MeanDeltas[VertexIndex] /= (float)NumFrames;
+		MeanNormals[VertexIndex] /= (float)NumFrames;
+	});
+
+	// Centered Data
+	TArray<float> Data;
+	Data.SetNumUninitialized(NumFrames * NumDimensions);
+
+	ParallelFor(NumFrames, [&](int32 Frame)
+	{
+		for (int32 VertexIndex = 0; VertexIndex < NumVertices; VertexIndex++)
+		{
+			const FVector3f Centered = Deltas[Frame * NumVertices + VertexIndex] - MeanDeltas[VertexIndex];
+			float* Row = &Data[Frame * NumDimensions + VertexIndex * 3];
+			Row[0] = Centered.X;
+			Row[1] = Centered.Y;
+			Row[2] = Centered.Z;
+		}
+	});
+
+	// Total Energy
+	double TotalEnergy = 0.0;
+	for (const float Value : Data)
+	{
+		TotalEnergy += (double)Value * (double)Value;
+	}
+
+	// ---------------------------------------------------------------------------
+	// Randomized Range Finder.
+	// Instead of decomposing the full matrix, we find an orthonormal basis Q (NumFrames x NumSamples)
+	// for its range, and decompose the (much smaller) projected matrix.
+	//
+	const int32 NumSamples = FMath::Min3(MaxNumBasis + 8, NumFrames, NumDimensions);
+	const int32 NumPowerIterations = 2;
+
+	// Random Projection (NumDimensions x NumSamples, column major)
+	TArray<float> Projection;
+	Projection.SetNumUninitialized(NumDimensions * NumSamples);
+	{
+		FRandomStream RandomStream(0);
+		for (float& Value : Projection)
+		{
+			Value = RandomStream.FRandRange(-1.f, 1.f);
+		}
+	}
+
+	// Q = Data * Projection (NumFrames x NumSamples, column major)
+	TArray<float> Q;
+	Q.SetNumUninitialized(NumFrames * NumSamples);
+
+	auto MultiplyData = [&](const TArray<float>& InMatrix /* NumDimensions x NumSamples */, TArray<float>& OutMatrix /* NumFrames x NumSamples */)
+	{
+		ParallelFor(NumFrames, [&](int32 Frame)
+		{
+			const float* Row = &Data[Frame * NumDimensions];
+			for (int32 Sample = 0; Sample < NumSamples; Sample++)
+			{
+				const float* Column = &InMatrix[Sample * NumDimensions];
+				double Sum = 0.0;
+				for (int32 Dimension = 0; Dimension < NumDimensions; Dimension++)
+				{
+					Sum += Row[Dimension] * Column[Dimension];
+				}
+				OutMatrix[Sample * NumFrames + Frame] = (float)Sum;
+			}
+		});
+	};
+
+	auto MultiplyDataTransposed = [&](const TArray<float>& InMatrix /* NumFrames x NumSamples */, TArray<float>& OutMatrix /* NumDimensions x NumSamples */)
+	{
+		ParallelFor(NumSamples, [&](int32 Sample)
+		{
+			const float* Column = &InMatrix[Sample * NumFrames];
+			float* OutColumn = &OutMatrix[Sample * NumDimensions];
+			FMemory::Memzero(OutColumn, NumDimensions * sizeof(float));
+
+			for (int32 Frame = 0; Frame < NumFrames; Frame++)
+			{
+				const float Weight = Column[Frame];
+				const float* Row = &Data[Frame * NumDimensions];
+				for (int32 Dimension = 0; Dimension < NumDimensions; Dimension++)
+				{
+					OutColumn[Dimension] += Weight * Row[Dimension];
+				}
+			}
+		});
+	};
+
+	MultiplyData(Projection, Q);
+	OrthonormalizeColumns(Q, NumFrames, NumSamples);
+
+	// Power Iterations, improves accuracy when the spectrum decays slowly.
+	// Z = Data^T * Q is also the transposed projected matrix (B = Q^T * Data)
+	TArray<float>& Z = Projection;
+	for (int32 Iteration = 0; Iteration < NumPowerIterations; Iteration++)
+	{
+		MultiplyDataTransposed(Q, Z);
+		OrthonormalizeColumns(Z, NumDimensions, NumSamples);
+		MultiplyData(Z, Q);
+		OrthonormalizeColumns(Q, NumFrames, NumSamples);
+	}
+	MultiplyDataTransposed(Q, Z);
+
+	// ---------------------------------------------------------------------------
+	// Decompose B * B^T (NumSamples x NumSamples)
+	//
+	TArray<double> Gram;
+	Gram.SetNumZeroed(NumSamples * NumSamples);
+
+	ParallelFor(NumSamples, [&](int32 Row)
+	{
+		const float* ColumnA = &Z[Row * NumDimensions];
+		for (int32 Column = 0; Column <= Row; Column++)
+		{
+			const float* ColumnB = &Z[Column * NumDimensions];
+			double Sum = 0.0;
+			for (int32 Dimension = 0; Dimension < NumDimensions; Dimension++)
+			{
+				Sum += (double)ColumnA[Dimension] * (double)ColumnB[Dimension];
+			}
+			Gram[Row * NumSamples + Column] = Sum;
+			Gram[Column * NumSamples + Row] = Sum;
+		}
+	});
+
+	TArray<double> EigenValues;
+	TArray<double> EigenVectors;
+	SymmetricEigenDecomposition(Gram, NumSamples, EigenValues, EigenVectors);
+
+	// ---------------------------------------------------------------------------
+	// Find Number of Basis for the given Error.
+	// The residual energy of a rank K reconstruction is TotalEnergy - Sum(EigenValues[0..K])
+	//
+	const int32 MaxBasis = FMath::Min(MaxNumBasis, NumSamples);
+	const double ErrorNorm = 1.0 / ((double)NumFrames * (double)NumVertices);
+
+	int32 NumBasis = 0;
+	double ResidualEnergy = TotalEnergy;
+	while (NumBasis < MaxBasis)
+	{
+		ResidualEnergy -= FMath::Max(EigenValues[NumBasis], 0.0);
+		NumBasis++;
+
+		if (FMath::Sqrt(FMath::Max(ResidualEnergy, 0.0) * ErrorNorm) <= ErrorTolerance)
+		{
+			break;
+		}
+	}
+
+	OutError = (float)FMath::Sqrt(FMath::Max(ResidualEnergy, 0.0) * ErrorNorm);
+
+	// ---------------------------------------------------------------------------
+	// Basis and Coefficients.
+	// Basis_k = Z * W_k / sqrt(NumFrames), Coefficient_k = Q * W_k * sqrt(NumFrames)
+	// Scaling keeps the basis in the same range as the deltas and the coefficients around [-1, 1]
+	//
+	const float FramesScale = FMath::Sqrt((float)NumFrames);
+
+	OutDeltaBasis.SetNumZeroed((NumBasis + 1) * NumVertices);
+	OutNormalBasis.SetNumZeroed((NumBasis + 1) * NumVertices);
+	OutCoefficients.SetNumZeroed(NumFrames * NumBasis);
+
+	// Mean
+	for (int32 VertexIndex = 0; VertexIndex < NumVertices; VertexIndex++)
+	{
+		OutDeltaBasis[VertexIndex] = MeanDeltas[VertexIndex];
+		OutNormalBasis[VertexIndex] = MeanNormals[VertexIndex];
+	}
+
+	ParallelFor(NumFrames, [&](int32 Frame)
+	{
+		for (int32 Basis = 0; Basis < NumBasis; Basis++)
+		{
+			double Sum = 0.0;
+			for (int32 Sample = 0; Sample < NumSamples; Sample++)
+			{
+				Sum += Q[Sample * NumFrames + Frame] * EigenVectors[Sample * NumSamples + Basis];
+			}
+			OutCoefficients[Frame * NumBasis + Basis] = (float)Sum * FramesScale;
+		}
+	});
+
+	ParallelFor(NumVertices, [&](int32 VertexIndex)
+	{
+		for (int32 Basis = 0; Basis < NumBasis; Basis++)
+		{
+			FVector3f& DeltaBasis = OutDeltaBasis[(Basis + 1) * NumVertices + VertexIndex];
+			FVector3f& NormalBasis = OutNormalBasis[(Basis + 1) * NumVertices + VertexIndex];
+
+			// Delta Basis
+			for (int32 Sample = 0; Sample < NumSamples; Sample++)
+			{
+				const float Weight = (float)EigenVectors[Sample * NumSamples + Basis];
+				const float* Column = &Z[Sample * NumDimensions + VertexIndex * 3];
+				DeltaBasis += FVector3f(Column[0], Column[1], Column[2]) * Weight;
+			}
+			DeltaBasis /= FramesScale;
+
+			// Normal Basis.
+			// Coefficients are orthogonal with Sum(C_k * C_k) = NumFrames,
+			// so the least squares projection is a simple weighted average.
+			for (int32 Frame = 0; Frame < NumFrames; Frame++)
+			{
+				const FVector3f CenteredNormal = Normals[Frame * NumVertices + VertexIndex] - MeanNormals[VertexIndex];
+				NormalBasis += CenteredNormal * OutCoefficients[Frame * NumBasis + Basis];
+			}
+			NormalBasis /= (float)NumFrames;
+		}
+	});
+
+	return NumBasis;
+}
+
+void FVATCompressionUtilities::SymmetricEigenDecomposition(const TArray<double>& Matrix, const int32 N,
+	TArray<double>& OutEigenValues, TArray<double>& OutEigenVectors)
+{
+	check(Matrix.Num() == N * N);
+
+	TArray<double> A = Matrix;
+
+	// Start from Identity
+	OutEigenVectors.SetNumZeroed(N * N);
+	for (int32 Index = 0; Index < N; Index++)
+	{
+		OutEigenVectors[Index * N + Index] = 1.0;
+	}
+
+	// Cyclic Jacobi Rotations
+	const int32 MaxSweeps = 64;
+	for (int32 Sweep = 0; Sweep < MaxSweeps; Sweep++)
+	{
+		double OffDiagonal = 0.0;
+		double Diagonal = 0.0;
+		for (int32 Row = 0; Row < N; Row++)
+		{
+			Diagonal += A[Row * N + Row] * A[Row * N + Row];
+			for (int32 Column = Row + 1; Column < N; Column++)
+			{
+				OffDiagonal += A[Row * N + Column] * A[Row * N + Column];
+			}
+		}
+
+		if (OffDiagonal <= Diagonal * 1e-24 || OffDiagonal == 0.0)
+		{
+			break;
+		}
+
+		for (int32 P = 0; P < N - 1; P++)
+		{
+			for (int32 R = P + 1; R < N; R++)
+			{
+				const double APR = A[P * N + R];
+				if (FMath::Abs(APR) < 1e-300)
+				{
+					continue;
+				}
+
+				const double Theta = (A[R * N + R] - A[P * N + P]) / (2.0 * APR);
+				const double T = (Theta >= 0.0 ? 1.0 : -1.0) / (FMath::Abs(Theta) + FMath::Sqrt(Theta * Theta + 1.0));
+				const double C = 1.0 / FMath::Sqrt(T * T + 1.0);
+				const double S = T * C;
+
+				for (int32 K = 0; K < N; K++)
+				{
+					const double AKP = A[K * N + P];
+					const double AKR = A[K * N + R];
+					A[K * N + P] = C * AKP - S * AKR;
+					A[K * N + R] = S * AKP + C * AKR;
+				}
+				for (int32 K = 0; K < N; K++)
+				{
+					const double APK = A[P * N + K];
+					const double ARK = A[R * N + K];
+					A[P * N + K] = C * APK - S * ARK;
+					A[R * N + K] = S * APK + C * ARK;
+				}
+				for (int32 K = 0; K < N; K++)
+				{
+					const double VKP = OutEigenVectors[K * N + P];
+					const double VKR = OutEigenVectors[K * N + R];
+					OutEigenVectors[K * N + P] = C * VKP - S * VKR;
+					OutEigenVectors[K * N + R] = S * VKP + C * VKR;
+				}
+			}
+		}
+	}
+
+	// Sort by EigenValue (descending)
+	TArray<int32> Order;
+	Order.SetNumUninitialized(N);
+	for (int32 Index = 0; Index < N; Index++)
+	{
+		Order[Index] = Index;
+	}
+	Order.Sort([&A, N](const int32 IndexA, const int32 IndexB)
+	{
+		return A[IndexA * N + IndexA] > A[IndexB * N + IndexB];
+	});
+
+	const TArray<double> UnsortedEigenVectors = OutEigenVectors;
+	OutEigenValues.SetNumUninitialized(N);
+	for (int32 Column = 0; Column < N; Column++)
+	{
+		const int32 SourceColumn = Order[Column];
+		OutEigenValues[Column] = A[SourceColumn * N + SourceColumn];
+		for (int32 Row = 0; Row < N; Row++)
+		{
+			OutEigenVectors[Row * N + Column] = UnsortedEigenVectors[Row * N + SourceColumn];
+		}
+	}
+}
+
+void FVATCompressionUtilities::OrthonormalizeColumns(TArray<float>& Matrix, const int32 NumRows, const int32 NumColumns)
+{
+	check(Matrix.Num() == NumRows * NumColumns);
+
+	for (int32 Column = 0; Column < NumColumns; Column++)
+	{
+		float* Current = &Matrix[Column * NumRows];
+
+		for (int32 Previous = 0; Previous < Column; Previous++)
+		{
+			const float* Other = &Matrix[Previous * NumRows];
+
+			double Dot = 0.0;
+			for (int32 Row = 0; Row < NumRows; Row++)
+			{
+				Dot += (double)Current[Row] * (double)Other[Row];
+			}
+			for (int32 Row = 0; Row < NumRows; Row++)
+			{
+				Current[Row] -= (float)Dot * Other[Row];
+			}
+		}
+
+		double Length = 0.0;
+		for (int32 Row = 0; Row < NumRows; Row++)
+		{
+			Length += (double)Current[Row] * (double)Current[Row];
+		}
+		Length = FMath::Sqrt(Length);
+
+		const float Scale = Length > UE_DOUBLE_SMALL_NUMBER ? (float)(1.0 / Length) : 0.f;
+		for (int32 Row = 0; Row < NumRows; Row++)
+		{
+			Current[Row] *= Scale;
+		}
+	}
+}
@@ -0,0 +1,328 @@
+﻿#include "VATKeyframeReduction.h"
+
+#include "Async/ParallelFor.h"
+
+namespace
+{
+	// Distance of the bone proxy points from the bone pivot (cm)
+	constexpr float BoneProxyDistance = 10.f;
+
+	// Returns true if all points in Frame are within Tolerance of the interpolation between FrameA and FrameB
+	bool IsInterpolated(const TArray<FVector3f>& Points, const int32 NumPoints,
+		const int32 FrameA, const int32 FrameB, const int32 Frame, const float SquaredTolerance)
+	{
+		const float Alpha = (float)(Frame - FrameA) / (float)(FrameB - FrameA);
+		const FVector3f* PointsA = &Points[FrameA * NumPoints];
+		const FVector3f* PointsB = &Points[FrameB * NumPoints];
+		const FVector3f* FramePoints = &Points[Frame * NumPoints];
+
+		for (int32 Index = 0; Index < NumPoints; Index++)
+		{
+			const FVector3f Interpolated = FMath::Lerp(PointsA[Index], PointsB[Index], Alpha);
+			if (FVector3f::DistSquared(Interpolated, FramePoints[Index]) > SquaredTolerance)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Returns true if all points in FrameA are within Tolerance of FrameB
+	bool IsEqual(const TArray<FVector3f>& Points, const int32 NumPoints,
+		const int32 FrameA, const int32 FrameB, const float SquaredTolerance)
+	{
+		const FVector3f* PointsA = &Points[FrameA * NumPoints];
+		const FVector3f* PointsB = &Points[FrameB * NumPoints];
+
+		for (int32 Index = 0; Index < NumPoints; Index++)
+		{
+			if (FVector3f::DistSquared(PointsA[Index], PointsB[Index]) > SquaredTolerance)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Appends the Keyframes of each animation and maps every baked frame to them
+	void BuildFrameRemap(const TArray<FVATAnimInfo>& Animations, const TArray<TArray<int32>>& AnimationKeyframes,
+		TArray<int32>& OutKeyframes, TArray<FVector4f>& OutFrameRemap)
+	{
+		for (int32 AnimationIndex = 0; AnimationIndex < Animations.Num(); AnimationIndex++)
+		{
+			const TArray<int32>& Keyframes = AnimationKeyframes[AnimationIndex];
+			const int32 FirstKey = OutKeyframes.Num();
+			const int32 LastKey = FirstKey + Keyframes.Num() - 1;
+			OutKeyframes.Append(Keyframes);
+
+			// Leading Frames
+			for (int32 Frame = Animations[AnimationIndex].StartFrame; Frame < Keyframes[0]; Frame++)
+			{
+				OutFrameRemap[Frame] = FVector4f((float)FirstKey, (float)FirstKey, 0.f, 0.f);
+			}
+
+			// Segments
+			for (int32 Index = 0; Index < Keyframes.Num() - 1; Index++)
+			{
+				const int32 SegmentLength = Keyframes[Index + 1] - Keyframes[Index];
+				for (int32 Frame = Keyframes[Index]; Frame < Keyframes[Index + 1]; Frame++)
+				{
+					OutFrameRemap[Frame] = FVector4f(
+						(float)(FirstKey + Index), (float)(FirstKey + Index + 1),
+						(float)(Frame - Keyframes[Index]) / (float)SegmentLength, 1.f / (float)SegmentLength);
+				}
+			}
+
+			// Trailing Frames
+			for (int32 Frame = Keyframes.Last(); Frame <= Animations[AnimationIndex].EndFrame; Frame++)
+			{
+				OutFrameRemap[Frame] = FVector4f((float)LastKey, (float)LastKey, 0.f, 0.f);
+			}
+		}
+	}
+}
+
+int32 FVATKeyframeReduction::ReduceKeyframes(const TArray<FVector3f>& Points, const int32 NumPoints,
+	const TArray<FVATAnimInfo>& Animations, const float ErrorTolerance, const bool bTrimStaticFrames,
+	TArray<int32>& OutKeyframes, TArray<FVector4f>& OutFrameRemap)
+{
+	check(NumPoints > 0);
+	const int32 NumFrames = Points.Num() / NumPoints;
+	const float SquaredTolerance = ErrorTolerance * ErrorTolerance;
+
+	OutKeyframes.Reset();
+	OutFrameRemap.Init(FVector4f(0.f, 0.f, 0.f, 0.f), NumFrames);
+
+	// ---------------------------------------------------------------------------
+	// Find Keyframes (animations are independent)
+	//
+	TArray<TArray<int32>> AnimationKeyframes;
+	AnimationKeyframes.SetNum(Animations.Num());
+
+	ParallelFor(Animations.Num(), [&](int32 AnimationIndex)
+	{
+		const int32 StartFrame = Animations[AnimationIndex].StartFrame;
+		const int32 EndFrame = Animations[AnimationIndex].EndFrame;
+		check(StartFrame >= 0 && EndFrame < NumFrames && StartFrame <= EndFrame);
+
+		int32 FirstFrame = StartFrame;
+		int32 LastFrame = EndFrame;
+
+		// Trim Static leading and trailing frames.
+		// They are held at the first (and last) moving frame
+		if (bTrimStaticFrames)
+		{
+			while (FirstFrame < LastFrame && IsEqual(Points, NumPoints, StartFrame, FirstFrame + 1, SquaredTolerance))
+			{
+				FirstFrame++;
+			}
+			while (LastFrame > FirstFrame && IsEqual(Points, NumPoints, EndFrame, LastFrame - 1, SquaredTolerance))
+			{
+				LastFrame--;
+			}
+		}
+
+		// Greedy segments. Each segment is extended while all its inner frames can be interpolated.
+		TArray<int32>& Keyframes = AnimationKeyframes[AnimationIndex];
+		Keyframes.Add(FirstFrame);
+
+		int32 SegmentStart = FirstFrame;
+		int32 SegmentEnd = FirstFrame + 1;
+		while (SegmentEnd < LastFrame)
+		{
+			const int32 CandidateEnd = SegmentEnd + 1;
+
+			bool bValidSegment = true;
+			for (int32 Frame = SegmentStart + 1; Frame < CandidateEnd && bValidSegment; Frame++)
+			{
+				bValidSegment = IsInterpolated(Points, NumPoints, SegmentStart, CandidateEnd, Frame, SquaredTolerance);
+			}
+
+			if (bValidSegment)
+			{
+				SegmentEnd = CandidateEnd;
+			}
+			else
+			{
+				Keyframes.Add(SegmentEnd);
+				SegmentStart = SegmentEnd;
+				SegmentEnd = SegmentStart + 1;
+			}
+		}
+
+		if (LastFrame != FirstFrame)
+		{
+			Keyframes.Add(LastFrame);
+		}
+	});
+
+	BuildFrameRemap(Animations, AnimationKeyframes, OutKeyframes, OutFrameRemap);
+
+	return OutKeyframes.Num();
+}
+
+int32 FVATKeyframeReduction::GetFrameRemap(const TArray<FVATAnimInfo>& Animations, const int32 NumFrames,
+	TArray<int32>& OutKeyframes, TArray<FVector4f>& OutFrameRemap)
+{
+	OutKeyframes.Reset();
+	OutFrameRemap.Init(FVector4f(0.f, 0.f, 0.f, 0.f), NumFrames);
+
+	TArray<TArray<int32>> AnimationKeyframes;
+	AnimationKeyframes.SetNum(Animations.Num());
+	for (int32 AnimationIndex = 0; AnimationIndex < Animations.Num(); AnimationIndex++)
+	{
+		for (int32 Frame = Animations[AnimationIndex].StartFrame; Frame <= Animations[AnimationIndex].EndFrame; Frame++)
+		{
+			AnimationKeyframes[AnimationIndex].Add(Frame);
+		}
+	}
+
+	BuildFrameRemap(Animations, AnimationKeyframes, OutKeyframes, OutFrameRemap);
+
+	return OutKeyframes.Num();
+}
+
+int32 FVATKeyframeReduction::DeduplicateKeyframes(const TArray<FVector3f>& Points, const int32 NumPoints, const float Tolerance,
+	TArray<int32>& InOutKeyframes, TArray<FVector4f>& InOutFrameRemap)
+{
+	check(NumPoints > 0);
+	const float SquaredTolerance = Tolerance * Tolerance;
+	const float CellSize = FMath::Max(Tolerance, UE_KINDA_SMALL_NUMBER);
+
+	// Frames within Tolerance have centroids within Tolerance, 
+	// so candidates are found in the neighbouring cells of the quantized centroid.
+	TArray<FIntVector> Cells;
+	Cells.SetNumUninitialized(InOutKeyframes.Num());
+
+	ParallelFor(InOutKeyframes.Num(), [&](int32 Index)
+	{
+		const FVector3f* FramePoints = &Points[InOutKeyframes[Index] * NumPoints];
+
+		FVector3f Centroid = FVector3f::ZeroVector;
+		for (int32 PointIndex = 0; PointIndex < NumPoints; PointIndex++)
+		{
+			Centroid += FramePoints[PointIndex];
+		}
+		Centroid /= (float)NumPoints;
+
+		Cells[Index] = FIntVector(
+			FMath::FloorToInt32(Centroid.X / CellSize),
+			FMath::FloorToInt32(Centroid.Y / CellSize),
+			FMath::FloorToInt32(Centroid.Z / CellSize));
+	});
+
+	// Keyframes are compared with the unique ones only, so the error is never accumulated.
+	TMultiMap<FIntVector, int32> UniqueCells;
+	TArray<int32> UniqueKeyframes;
+	TArray<int32> KeyframeToUnique;
+	KeyframeToUnique.SetNumUninitialized(InOutKeyframes.Num());
+
+	TArray<int32> Candidates;
+	for (int32 Index = 0; Index < InOutKeyframes.Num(); Index++)
+	{
+		int32 UniqueIndex = INDEX_NONE;
+
+		for (int32 Z = -1; Z <= 1 && UniqueIndex == INDEX_NONE; Z++)
+		{
+			for (int32 Y = -1; Y <= 1 && UniqueIndex == INDEX_NONE; Y++)
+			{
+				for (int32 X = -1; X <= 1 && UniqueIndex == INDEX_NONE; X++)
+				{
+					Candidates.Reset();
+					UniqueCells.MultiFind(Cells[Index] + FIntVector(X, Y, Z), Candidates);
+					for (const int32 Candidate : Candidates)
+					{
+						if (IsEqual(Points, NumPoints, UniqueKeyframes[Candidate], InOutKeyframes[Index], SquaredTolerance))
+						{
+							UniqueIndex = Candidate;
+							break;
+						}
+					}
+				}
+			}
+		}
+
+		if (UniqueIndex == INDEX_NONE)
+		{
+			UniqueIndex = UniqueKeyframes.Add(InOutKeyframes[Index]);
+			UniqueCells.Add(Cells[Index], UniqueIndex);
+		}
+		KeyframeToUnique[Index] = UniqueIndex;
+	}
+
+	// Point the FrameRemap to the unique Keyframes
+	for (FVector4f& Remap : InOutFrameRemap)
+	{
+		Remap.X = (float)KeyframeToUnique[(int32)Remap.X];
+		Remap.Y = (float)KeyframeToUnique[(int32)Remap.Y];
+	}
+
+	InOutKeyframes = MoveTemp(UniqueKeyframes);
+	return InOutKeyframes.Num();
+}
+
+int32 FVATKeyframeReduction::FindSampleStep(const TArray<FVector3f>& Points, const int32 NumPoints, const int32 MaxStep, const float ErrorTolerance)
+{
+	check(NumPoints > 0);
+	const int32 NumFrames = Points.Num() / NumPoints;
+	const float SquaredTolerance = ErrorTolerance * ErrorTolerance;
+
+	for (int32 Step = FMath::Min(MaxStep, NumFrames - 1); Step > 1; Step--)
+	{
+		// Frames after the last sample hold it
+		const int32 LastSample = ((NumFrames - 1) / Step) * Step;
+
+		bool bValidStep = true;
+		for (int32 Frame = 1; Frame < NumFrames && bValidStep; Frame++)
+		{
+			const int32 Sample = Frame - Frame % Step;
+			if (Sample == Frame)
+			{
+				continue;
+			}
+
+			bValidStep = Sample == LastSample ?
+				IsEqual(Points, NumPoints, LastSample, Frame, SquaredTolerance) :
+				IsInterpolated(Points, NumPoints, Sample, Sample + Step, Frame, SquaredTolerance);
+		}
+
+		if (bValidStep)
+		{
+			return Step;
+		}
+	}
+
+	return 1;
+}
+
+void FVATKeyframeReduction::GetBoneProxyPoints(const TArray<FVector3f>& Positions, const TArray<FVector4f>& Rotations,
+	const int32 NumBones, const int32 NumFrames, TArray<FVector3f>& OutPoints)
+{
+	check(Positions.Num() == (NumFrames + 1) * NumBones);
+	check(Rotations.Num() == (NumFrames + 1) * NumBones);
+
+	const FVector3f Offsets[3] = {
+		FVector3f::ZeroVector,
+		FVector3f(BoneProxyDistance, 0.f, 0.f),
+		FVector3f(0.f, BoneProxyDistance, 0.f) };
+
+	OutPoints.SetNumUninitialized(NumFrames * NumBones * 3);
+
+	ParallelFor(NumFrames, [&](int32 Frame)
+	{
+		for (int32 Bone = 0; Bone < NumBones; Bone++)
+		{
+			// RefPose is stored in the first frame
+			const FVector3f& RefPosition = Positions[Bone];
+			const FVector3f& Delta = Positions[(Frame + 1) * NumBones + Bone];
+			const FVector4f& Rotation = Rotations[(Frame + 1) * NumBones + Bone];
+			const FQuat4f Quat(FVector3f(Rotation).GetSafeNormal(), Rotation.W);
+
+			for (int32 Index = 0; Index < 3; Index++)
+			{
+				const FVector3f Point = RefPosition + Offsets[Index];
+				OutPoints[(Frame * NumBones + Bone) * 3 + Index] = Quat.RotateVector(Point - RefPosition) + RefPosition + Delta;
+			}
+		}
+	});
+}
@@ -0,0 +1,364 @@
+﻿#include "VATMaterialLayerBuilder.h"
+
+#include "AssetToolsModule.h"
+#include "MaterialEditingLibrary.h"
+#include "Factories/MaterialFunctionMaterialLayerFactory.h"
+#include "Materials/MaterialAttributeDefinitionMap.h"
+#include "Materials/MaterialExpressionCameraPositionWS.h"
+#include "Materials/MaterialExpressionConstant.h"
+#include "Materials/MaterialExpressionCustom.h"
+#include "Materials/MaterialExpressionDistance.h"
+#include "Materials/MaterialExpressionFunctionInput.h"
+#include "Materials/MaterialExpressionFunctionOutput.h"
+#include "Materials/MaterialExpressionLocalPosition.h"
+#include "Materials/MaterialExpressionObjectPositionWS.h"
+#include "Materials/MaterialExpressionPerInstanceCustomData.h"
+#include "Materials/MaterialExpressionScalarParameter.h"
+#include "Materials/MaterialExpressionSetMaterialAttributes.h"
+#include "Materials/MaterialExpressionStaticSwitchParameter.h"
+#include "Materials/MaterialExpressionTextureCoordinate.h"
+#include "Materials/MaterialExpressionTextureObjectParameter.h"
+#include "Materials/MaterialExpressionTime.h"
+#include "Materials/MaterialExpressionTransform.h"
+#include "Materials/MaterialExpressionVectorParameter.h"
+#include "Materials/MaterialExpressionVertexInterpolator.h"
+#include "Materials/MaterialExpressionVertexNormalWS.h"
+#include "Materials/MaterialFunctionMaterialLayer.h"
+
+namespace
+{
+	template <typename T>
+	T* CreateFunctionExpression(UMaterialFunction* Function, int32 NodePosX, int32 NodePosY)
+	{
+		return Cast<T>(UMaterialEditingLibrary::CreateMaterialExpressionInFunction(Function, T::StaticClass(), NodePosX, NodePosY));
+	}
+
+	template <typename T>
+	T* FindFunctionExpression(UMaterialFunction* Function)
+	{
+		for (UMaterialExpression* Expression : Function->GetExpressions())
+		{
+			if (T* TypedExpression = Cast<T>(Expression))
+			{
+				return TypedExpression;
+			}
+		}
+		return nullptr;
+	}
+}
+
+FVATMaterialLayerBuilder::FVATMaterialLayerBuilder(const FString& InDescription)
+	: Description(InDescription)
+{
+}
+
+void FVATMaterialLayerBuilder::AddInclude(const FString& IncludeFilePath)
+{
+	IncludeFilePaths.AddUnique(IncludeFilePath);
+}
+
+void FVATMaterialLayerBuilder::AddDefine(const FString& Name, const FString& Value)
+{
+	Defines.Emplace(Name, Value);
+}
+
+void FVATMaterialLayerBuilder::AddScalarParameter(const FName Name, const float DefaultValue)
+{
+	FInput& Input = Inputs.AddDefaulted_GetRef();
+	Input.Type = EInputType::Scalar;
+	Input.Name = Name;
+	Input.ScalarValue = DefaultValue;
+}
+
+void FVATMaterialLayerBuilder::AddVectorParameter(const FName Name, const FLinearColor& DefaultValue)
+{
+	FInput& Input = Inputs.AddDefaulted_GetRef();
+	Input.Type = EInputType::Vector;
+	Input.Name = Name;
+	Input.VectorValue = DefaultValue;
+}
+
+void FVATMaterialLayerBuilder::AddTextureParameter(const FName Name, UTexture* DefaultTexture)
+{
+	FInput& Input = Inputs.AddDefaulted_GetRef();
+	Input.Type = EInputType::Texture;
+	Input.Name = Name;
+	Input.TextureValue = DefaultTexture;
+}
+
+void FVATMaterialLayerBuilder::AddStaticSwitchParameter(const FName Name, const bool bDefaultValue)
+{
+	FInput& Input = Inputs.AddDefaulted_GetRef();
+	Input.Type = EInputType::StaticSwitch;
+	Input.Name = Name;
+	Input.ScalarValue = bDefaultValue ? 1.f : 0.f;
+}
+
+void FVATMaterialLayerBuilder::AddTexCoord(const FName Name, const int32 CoordinateIndex)
+{
+	FInput& Input = Inputs.AddDefaulted_GetRef();
+	Input.Type = EInputType::TexCoord;
+	Input.Name = Name;
+	Input.CoordinateIndex = CoordinateIndex;
+}
+
+void FVATMaterialLayerBuilder::AddTime(const FName Name)
+{
+	FInput& Input = Inputs.AddDefaulted_GetRef();
+	Input.Type = EInputType::Time;
+	Input.Name = Name;
+}
+
+void FVATMaterialLayerBuilder::AddLocalPosition(const FName Name)
+{
+	FInput& Input = Inputs.AddDefaulted_GetRef();
+	Input.Type = EInputType::LocalPosition;
+	Input.Name = Name;
+}
+
+void FVATMaterialLayerBuilder::AddLocalNormal(const FName Name)
+{
+	FInput& Input = Inputs.AddDefaulted_GetRef();
+	Input.Type = EInputType::LocalNormal;
+	Input.Name = Name;
+}
+
+void FVATMaterialLayerBuilder::AddCameraDistance(const FName Name)
+{
+	FInput& Input = Inputs.AddDefaulted_GetRef();
+	Input.Type = EInputType::CameraDistance;
+	Input.Name = Name;
+}
+
+void FVATMaterialLayerBuilder::AddPerInstanceCustomData(const FName Name, const int32 DataIndex, const float DefaultValue)
+{
+	FInput& Input = Inputs.AddDefaulted_GetRef();
+	Input.Type = EInputType::PerInstanceCustomData;
+	Input.Name = Name;
+	Input.DataIndex = DataIndex;
+	Input.ScalarValue = DefaultValue;
+}
+
+void FVATMaterialLayerBuilder::AddCode(const FString& Line)
+{
+	CodeLines.Add(Line);
+}
+
+UMaterialFunctionMaterialLayer* FVATMaterialLayerBuilder::Build(const FString& PackagePath, const FString& AssetName) const
+{
+	// ---------------------------------------------------------------------------
+	// Create Asset
+	//
+	UMaterialFunctionMaterialLayerFactory* Factory = NewObject<UMaterialFunctionMaterialLayerFactory>();
+	UMaterialFunctionMaterialLayer* Layer = Cast<UMaterialFunctionMaterialLayer>(
+		IAssetTools::Get().CreateAsset(AssetName, PackagePath, UMaterialFunctionMaterialLayer::StaticClass(), Factory));
+
+	if (!Layer)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Unable to create MaterialLayer: %s/%s"), *PackagePath, *AssetName);
+		return nullptr;
+	}
+
+	Layer->Description = Description;
+
+	// ---------------------------------------------------------------------------
+	// Custom Node
+	//
+	UMaterialExpressionCustom* Custom = CreateFunctionExpression<UMaterialExpressionCustom>(Layer, -400, 0);
+	check(Custom);
+
+	Custom->Description = TEXT("VAT");
+	Custom->OutputType = ECustomMaterialOutputType::CMOT_Float3;
+	Custom->IncludeFilePaths = IncludeFilePaths;
+	for (const TPair<FString, FString>& Define : Defines)
+	{
+		FCustomDefine& CustomDefine = Custom->AdditionalDefines.AddDefaulted_GetRef();
+		CustomDefine.DefineName = Define.Key;
+		CustomDefine.DefineValue = Define.Value;
+	}
+	Custom->Code = FString::Join(CodeLines, TEXT("\n"));
+	Custom->Inputs.Reset();
+
+	FCustomOutput& NormalOutput = Custom->AdditionalOutputs.AddDefaulted_GetRef();
+	NormalOutput.OutputName = TEXT("Normal");
+	NormalOutput.OutputType = ECustomMaterialOutputType::CMOT_Float3;
+
+	// Outputs are only rebuilt when the property changes
+	FProperty* AdditionalOutputsProperty = FindFProperty<FProperty>(UMaterialExpressionCustom::StaticClass(), GET_MEMBER_NAME_CHECKED(UMaterialExpressionCustom, AdditionalOutputs));
+	FPropertyChangedEvent AdditionalOutputsChangedEvent(AdditionalOutputsProperty);
+	Custom->PostEditChangeProperty(AdditionalOutputsChangedEvent);
+
+	// ---------------------------------------------------------------------------
+	// Inputs
+	//
+	int32 NodePosY = 0;
+	for (const FInput& Input : Inputs)
+	{
+		UMaterialExpression* InputExpression = nullptr;
+		const int32 NodePosX = -800;
+
+		switch (Input.Type)
+		{
+			case EInputType::Scalar:
+			{
+				UMaterialExpressionScalarParameter* Parameter = CreateFunctionExpression<UMaterialExpressionScalarParameter>(Layer, NodePosX, NodePosY);
+				Parameter->ParameterName = Input.Name;
+				Parameter->DefaultValue = Input.ScalarValue;
+				InputExpression = Parameter;
+				break;
+			}
+			case EInputType::Vector:
+			{
+				UMaterialExpressionVectorParameter* Parameter = CreateFunctionExpression<UMaterialExpressionVectorParameter>(Layer, NodePosX, NodePosY);
+				Parameter->ParameterName = Input.Name;
+				Parameter->DefaultValue = Input.VectorValue;
+				InputExpression = Parameter;
+				break;
+			}
+			case EInputType::Texture:
+			{
+				UMaterialExpressionTextureObjectParameter* Parameter = CreateFunctionExpression<UMaterialExpressionTextureObjectParameter>(Layer, NodePosX, NodePosY);
+				Parameter->ParameterName = Input.Name;
+				Parameter->SamplerType = EMaterialSamplerType::SAMPLERTYPE_LinearColor;
+				if (Input.TextureValue)
+				{
+					Parameter->Texture = Input.TextureValue;
+				}
+				InputExpression = Parameter;
+				break;
+			}
+			case EInputType::StaticSwitch:
+			{
+				UMaterialExpressionStaticSwitchParameter* Parameter = CreateFunctionExpression<UMaterialExpressionStaticSwitchParameter>(Layer, NodePosX, NodePosY);
+				Parameter->ParameterName = Input.Name;
+				Parameter->DefaultValue = Input.ScalarValue > 0.5f;
+
+				UMaterialExpressionConstant* True = CreateFunctionExpression<UMaterialExpressionConstant>(Layer, NodePosX - 200, NodePosY);
+				True->R = 1.f;
+				UMaterialExpressionConstant* False = CreateFunctionExpression<UMaterialExpressionConstant>(Layer, NodePosX - 200, NodePosY + 50);
+				False->R = 0.f;
+
+				True->ConnectExpression(&Parameter->A, 0);
+				False->ConnectExpression(&Parameter->B, 0);
+				InputExpression = Parameter;
+				break;
+			}
+			case EInputType::TexCoord:
+			{
+				UMaterialExpressionTextureCoordinate* TexCoord = CreateFunctionExpression<UMaterialExpressionTextureCoordinate>(Layer, NodePosX, NodePosY);
+				TexCoord->CoordinateIndex = Input.CoordinateIndex;
+				InputExpression = TexCoord;
+				break;
+			}
+			case EInputType::Time:
+			{
+				InputExpression = CreateFunctionExpression<UMaterialExpressionTime>(Layer, NodePosX, NodePosY);
+				break;
+			}
+			case EInputType::LocalPosition:
+			{
+				UMaterialExpressionLocalPosition* LocalPosition = CreateFunctionExpression<UMaterialExpressionLocalPosition>(Layer, NodePosX, NodePosY);
+				LocalPosition->IncludedOffsets = EPositionIncludedOffsets::ExcludeOffsets;
+				InputExpression = LocalPosition;
+				break;
+			}
+			case EInputType::LocalNormal:
+			{
+				UMaterialExpressionVertexNormalWS* Normal = CreateFunctionExpression<UMaterialExpressionVertexNormalWS>(Layer, NodePosX - 200, NodePosY);
+				UMaterialExpressionTransform* Transform = CreateFunctionExpression<UMaterialExpressionTransform>(Layer, NodePosX, NodePosY);
+				Transform->TransformSourceType = EMaterialVectorCoordTransformSource::TRANSFORMSOURCE_World;
+				Transform->TransformType = EMaterialVectorCoordTransform::TRANSFORM_Local;
+				Normal->ConnectExpression(&Transform->Input, 0);
+				InputExpression = Transform;
+				break;
+			}
+			case EInputType::CameraDistance:
+			{
+				UMaterialExpressionCameraPositionWS* CameraPosition = CreateFunctionExpression<UMaterialExpressionCameraPositionWS>(Layer, NodePosX - 200, NodePosY);
+				UMaterialExpressionObjectPositionWS* ObjectPosition = CreateFunctionExpression<UMaterialExpressionObjectPositionWS>(Layer, NodePosX - 200, NodePosY + 50);
+				UMaterialExpressionDistance* Distance = CreateFunctionExpression<UMaterialExpressionDistance>(Layer, NodePosX, NodePosY);
+				CameraPosition->ConnectExpression(&Distance->A, 0);
+				ObjectPosition->ConnectExpression(&Distance->B, 0);
+				InputExpression = Distance;
+				break;
+			}
+			case EInputType::PerInstanceCustomData:
+			{
+				UMaterialExpressionPerInstanceCustomData* CustomData = CreateFunctionExpression<UMaterialExpressionPerInstanceCustomData>(Layer, NodePosX, NodePosY);
+				CustomData->DataIndex = Input.DataIndex;
+				CustomData->ConstDefaultValue = Input.ScalarValue;
+				InputExpression = CustomData;
+				break;
+			}
+		}
+
+		check(InputExpression);
+		NodePosY += 100;
+
+		FCustomInput& CustomInput = Custom->Inputs.AddDefaulted_GetRef();
+		CustomInput.InputName = Input.Name;
+		InputExpression->ConnectExpression(&CustomInput.Input, 0);
+	}
+
+	// ---------------------------------------------------------------------------
+	// Transform Offset and Normal to World Space
+	//
+	UMaterialExpressionTransform* OffsetTransform = CreateFunctionExpression<UMaterialExpressionTransform>(Layer, -200, 0);
+	OffsetTransform->TransformSourceType = EMaterialVectorCoordTransformSource::TRANSFORMSOURCE_Local;
+	OffsetTransform->TransformType = EMaterialVectorCoordTransform::TRANSFORM_World;
+	Custom->ConnectExpression(&OffsetTransform->Input, 0);
+
+	UMaterialExpressionTransform* NormalTransform = CreateFunctionExpression<UMaterialExpressionTransform>(Layer, -200, 100);
+	NormalTransform->TransformSourceType = EMaterialVectorCoordTransformSource::TRANSFORMSOURCE_Local;
+	NormalTransform->TransformType = EMaterialVectorCoordTransform::TRANSFORM_World;
+	Custom->ConnectExpression(&NormalTransform->Input, 1);
+
+	// The Normal is computed per vertex and interpolated, so the Custom node never runs in the pixel shader
+	UMaterialExpressionVertexInterpolator* NormalInterpolator = CreateFunctionExpression<UMaterialExpressionVertexInterpolator>(Layer, -100, 100);
+	NormalTransform->ConnectExpression(&NormalInterpolator->Input, 0);
+
+	// ---------------------------------------------------------------------------
+	// Material Attributes
+	//
+	UMaterialExpressionFunctionInput* FunctionInput = FindFunctionExpression<UMaterialExpressionFunctionInput>(Layer);
+	if (!FunctionInput)
+	{
+		FunctionInput = CreateFunctionExpression<UMaterialExpressionFunctionInput>(Layer, -200, -200);
+		FunctionInput->InputType = EFunctionInputType::FunctionInput_MaterialAttributes;
+		FunctionInput->InputName = TEXT("Material Attributes");
+		FunctionInput->bUsePreviewValueAsDefault = true;
+	}
+
+	UMaterialExpressionFunctionOutput* FunctionOutput = FindFunctionExpression<UMaterialExpressionFunctionOutput>(Layer);
+	if (!FunctionOutput)
+	{
+		FunctionOutput = CreateFunctionExpression<UMaterialExpressionFunctionOutput>(Layer, 400, 0);
+		FunctionOutput->OutputName = TEXT("Result");
+	}
+
+	UMaterialExpressionSetMaterialAttributes* SetMatAttrs = CreateFunctionExpression<UMaterialExpressionSetMaterialAttributes>(Layer, 100, 0);
+	check(SetMatAttrs);
+
+	SetMatAttrs->AttributeSetTypes.Add(FMaterialAttributeDefinitionMap::GetID(MP_WorldPositionOffset));
+	SetMatAttrs->Inputs.Add(FExpressionInput());
+	SetMatAttrs->Inputs.Last().InputName = FName(*FMaterialAttributeDefinitionMap::GetAttributeName(SetMatAttrs->AttributeSetTypes.Last()));
+
+	SetMatAttrs->AttributeSetTypes.Add(FMaterialAttributeDefinitionMap::GetID(MP_Normal));
+	SetMatAttrs->Inputs.Add(FExpressionInput());
+	SetMatAttrs->Inputs.Last().InputName = FName(*FMaterialAttributeDefinitionMap::GetAttributeName(SetMatAttrs->AttributeSetTypes.Last()));
+
+	FunctionInput->ConnectExpression(SetMatAttrs->GetInput(0), 0);
+	OffsetTransform->ConnectExpression(SetMatAttrs->GetInput(1), 0);
+	NormalInterpolator->ConnectExpression(SetMatAttrs->GetInput(2), 0);
+	SetMatAttrs->ConnectExpression(FunctionOutput->GetInput(0), 0);
+
+	// ---------------------------------------------------------------------------
+	// Update
+	//
+	UMaterialEditingLibrary::LayoutMaterialFunctionExpressions(Layer);
+	UMaterialEditingLibrary::UpdateMaterialFunction(Layer, nullptr);
+
+	Layer->MarkPackageDirty();
+
+	return Layer;
+}
@@ -8,9 +8,15 @@
 #include "MeshUtilities.h"
 #include "RawMesh.h"
 #include "SVATModelEditorViewport.h"
+#include "VATAnimationLibrary.h"
+#include "VATCompressionUtilities.h"
+#include "VATKeyframeReduction.h"
+#include "VATMaterialLayerBuilder.h"
 #include "VATMeshMapping.h"
 #include "VATModelEditorCommands.h"
+#include "VATSkinningDecomposition.h"
 #include "VATUtils.h"
+#include "VATVertexReorder.h"
 #include "AssetRegistry/AssetRegistryHelpers.h"
 #include "AssetRegistry/AssetRegistryModule.h"
 #include "Editor/MaterialEditor/Public/MaterialEditingLibrary.h"
@@ -27,7 +33,9 @@
 #include "Materials/MaterialExpressionSetMaterialAttributes.h"
 #include "Materials/MaterialFunctionMaterialLayer.h"
 #include "Materials/MaterialInstanceConstant.h"
+#include "Misc/SecureHash.h"
 #include "Rendering/NaniteResources.h"
+#include "RHI.h"
 
 
 // helper macros for material manipulation
@@ -60,6 +68,68 @@
 	
 #define LOCTEXT_NAMESPACE "VATModelEditor"
 
+namespace
+{
+	// Vertex order optimization. Post-transform cache size, texel tiles and simulated texture cache (64 byte lines of 8 byte texels).
+	constexpr int32 VertexCacheSize = 32;
+	constexpr int32 TexelTileSize = 8;
+	constexpr int32 TextureCacheLines = 128;
+	constexpr int32 TextureCacheLineWidth = 4;
+	constexpr int32 TextureCacheLineHeight = 2;
+
+	// Returns the data of the baked bones. BoneData stores one element per Skeleton bone
+	template <typename T>
+	TArray<T> GatherBones(const TArray<T>& BoneData, const TArray<int32>& BoneMap)
+	{
+		TArray<T> OutBoneData;
+		OutBoneData.Reserve(BoneMap.Num());
+		for (const int32 BoneIndex : BoneMap)
+		{
+			OutBoneData.Add(BoneData[BoneIndex]);
+		}
+		return OutBoneData;
+	}
+
+	// Returns the Indices of the given elements as element indices, skipping the other vertices
+	TArray<int32> GatherIndices(const TArray<int32>& Indices, const TArray<int32>& Elements, const int32 NumVertices)
+	{
+		TArray<int32> VertexElements;
+		VertexElements.Init(INDEX_NONE, NumVertices);
+		for (int32 Element = 0; Element < Elements.Num(); Element++)
+		{
+			VertexElements[Elements[Element]] = Element;
+		}
+
+		TArray<int32> OutIndices;
+		OutIndices.Reserve(Indices.Num());
+		for (const int32 Vertex : Indices)
+		{
+			if (VertexElements[Vertex] != INDEX_NONE)
+			{
+				OutIndices.Add(VertexElements[Vertex]);
+			}
+		}
+		return OutIndices;
+	}
+
+	// Returns the data of the given elements, for each frame. Data stores NumElements elements per frame
+	template <typename T>
+	TArray<T> GatherFrameElements(const TArray<T>& Data, const int32 NumElements, const TArray<int32>& Elements)
+	{
+		const int32 NumFrames = NumElements ? Data.Num() / NumElements : 0;
+		TArray<T> OutData;
+		OutData.Reserve(NumFrames * Elements.Num());
+		for (int32 Frame = 0; Frame < NumFrames; Frame++)
+		{
+			for (const int32 Element : Elements)
+			{
+				OutData.Add(Data[Frame * NumElements + Element]);
+			}
+		}
+		return OutData;
+	}
+}
+
 void FVATModelEditorToolkit::InitEditor(const TArray<UObject*>& InObjects)
 {
 	VATModel = Cast<UVATModel>(InObjects[0]);
@@ -232,17 +302,77 @@ void FVATModelEditorToolkit::CreateTextures()
 	// Mode: Vertex | Textures: Position, Normal
 	// e.g. TX_VAT_<AssetName>_VertexPosition
 
-	// Mode: Bone | Textures: Position, Rotation, Weight
+	// Mode: Bone | Textures: Position, Rotation, Weight (Matrix or Real, Dual with other bone encodings)
 	// e.g. TX_VAT_<AssetName>_BonePosition
+	// Vertex Sections add the Vertex Mode textures
+
+	// Mode: SkinningDecomposition | Textures: same as Bone
+
+	// Mode: CompressedVertex | Textures: Basis, NormalBasis, Coefficient, BasisRange
+	// e.g. TX_VAT_LOD_0_<AssetName>_VertexBasis
 
 	int NumLODs = (int) VATModel->LODRange.Y - (int) VATModel->LODRange.X + 1; // range is inclusive 
 
 	VATModel->VertexPositionTextures.Empty();
 	VATModel->VertexNormalTextures.Empty();
 	VATModel->BoneWeightTextures.Empty();
+	VATModel->VertexBasisTextures.Empty();
+	VATModel->VertexNormalBasisTextures.Empty();
+	VATModel->VertexCoefficientTextures.Empty();
+	VATModel->VertexBasisRangeTextures.Empty();
+	VATModel->FrameRemapTextures.Empty();
+	VATModel->VertexPositionPageTextures.Empty();
+	VATModel->VertexNormalPageTextures.Empty();
+	VATModel->PageTableTextures.Empty();
+	VATModel->ResidualTextures.Empty();
+	VATModel->ResidualIndexTextures.Empty();
+	VATModel->BoneIndexTextures.Empty();
+
+	// Animation Library Bone textures live next to the library and are shared by all its VATModels
+	UVATAnimationLibrary* AnimationLibrary = VATModel->Mode == EVATModelMode::Bone ? VATModel->AnimationLibrary.Get() : nullptr;
+	if(AnimationLibrary)
+	{
+		const FString LibraryDirectory = FPaths::GetPath(AnimationLibrary->GetPackage()->GetName());
+		if(!UVATModel::GetAsset(AnimationLibrary->BonePositionTexture))
+		{
+			AnimationLibrary->BonePositionTexture = CreateTexture2DAsset(FPaths::Combine(LibraryDirectory, "TX_VAT_" + AnimationLibrary->GetName() + "_BonePosition"));
+			AnimationLibrary->BakeKey.Empty();
+		}
+		if(!UVATModel::GetAsset(AnimationLibrary->BoneRotationTexture))
+		{
+			AnimationLibrary->BoneRotationTexture = CreateTexture2DAsset(FPaths::Combine(LibraryDirectory, "TX_VAT_" + AnimationLibrary->GetName() + "_BoneRotation"));
+			AnimationLibrary->BakeKey.Empty();
+		}
+		AnimationLibrary->MarkPackageDirty();
+
+		VATModel->BonePositionTexture = AnimationLibrary->BonePositionTexture;
+		VATModel->BoneRotationTexture = AnimationLibrary->BoneRotationTexture;
+	}
+	else
+	{
+		VATModel->BonePositionTexture = CreateTexture2DAsset(FPaths::Combine(Directory, CreateTexture2DName("BonePosition", -1)));
+		VATModel->BoneRotationTexture = CreateTexture2DAsset(FPaths::Combine(Directory, CreateTexture2DName("BoneRotation", -1)));
+	}
+
+	if(VATModel->Settings->BoneEncoding == EVATBoneEncoding::MatrixPalette &&
+		(VATModel->Mode == EVATModelMode::Bone || VATModel->Mode == EVATModelMode::SkinningDecomposition))
+	{
+		VATModel->BoneMatrixTexture = CreateTexture2DAsset(FPaths::Combine(Directory, CreateTexture2DName("BoneMatrix", -1)));
+	}
+
+	if(VATModel->Settings->BoneEncoding == EVATBoneEncoding::DualQuaternion &&
+		(VATModel->Mode == EVATModelMode::Bone || VATModel->Mode == EVATModelMode::SkinningDecomposition))
+	{
+		VATModel->BoneRealTexture = CreateTexture2DAsset(FPaths::Combine(Directory, CreateTexture2DName("BoneReal", -1)));
+		VATModel->BoneDualTexture = CreateTexture2DAsset(FPaths::Combine(Directory, CreateTexture2DName("BoneDual", -1)));
+	}
 
-	VATModel->BonePositionTexture = CreateTexture2DAsset(FPaths::Combine(Directory, CreateTexture2DName("BonePosition", -1)));
-	VATModel->BoneRotationTexture = CreateTexture2DAsset(FPaths::Combine(Directory, CreateTexture2DName("BoneRotation", -1)));
+	if(VATModel->Settings->UsesPagedTextures() && 
+		(VATModel->Mode == EVATModelMode::Bone || VATModel->Mode == EVATModelMode::SkinningDecomposition))
+	{
+		VATModel->BonePositionPageTexture = CreateTexture2DArrayAsset(FPaths::Combine(Directory, CreateTexture2DName("BonePositionPages", -1)));
+		VATModel->BoneRotationPageTexture = CreateTexture2DArrayAsset(FPaths::Combine(Directory, CreateTexture2DName("BoneRotationPages", -1)));
+	}
 	
 	for(int i = 0; i < NumLODs; i++)
 	{
@@ -251,9 +381,52 @@ void FVATModelEditorToolkit::CreateTextures()
 			VATModel->VertexPositionTextures.Add(CreateTexture2DAsset(FPaths::Combine(Directory, CreateTexture2DName("VertexPosition", i))) );
 			VATModel->VertexNormalTextures.Add(CreateTexture2DAsset(FPaths::Combine(Directory, CreateTexture2DName("VertexNormal", i))) );
 		}
-		else if(VATModel->Mode == EVATModelMode::Bone)
+		else if(VATModel->Mode == EVATModelMode::Bone || VATModel->Mode == EVATModelMode::SkinningDecomposition)
+		{
+			// Skin Weights in UVChannels and Rigid Binding don't need textures
+			if(!VATModel->Settings->bSkinWeightsInUVs && !VATModel->Settings->UsesSocketBinding())
+			{
+				VATModel->BoneWeightTextures.Add( CreateTexture2DAsset(FPaths::Combine(Directory, CreateTexture2DName("BoneWeight", i))) );
+				if(VATModel->Settings->bIntegerBoneIndices)
+				{
+					VATModel->BoneIndexTextures.Add( CreateTexture2DAsset(FPaths::Combine(Directory, CreateTexture2DName("BoneIndex", i))) );
+				}
+			}
+
+			if(VATModel->Settings->bBakeResiduals && VATModel->Mode == EVATModelMode::Bone)
+			{
+				VATModel->ResidualTextures.Add( CreateTexture2DAsset(FPaths::Combine(Directory, CreateTexture2DName("Residual", i))) );
+				VATModel->ResidualIndexTextures.Add( CreateTexture2DAsset(FPaths::Combine(Directory, CreateTexture2DName("ResidualIndex", i))) );
+			}
+
+			// Sections baked in Vertex Mode
+			if(VATModel->Settings->UsesVertexSections() && VATModel->Mode == EVATModelMode::Bone)
+			{
+				VATModel->VertexPositionTextures.Add(CreateTexture2DAsset(FPaths::Combine(Directory, CreateTexture2DName("VertexPosition", i))) );
+				VATModel->VertexNormalTextures.Add(CreateTexture2DAsset(FPaths::Combine(Directory, CreateTexture2DName("VertexNormal", i))) );
+			}
+		}
+		else if(VATModel->Mode == EVATModelMode::CompressedVertex)
 		{
-			VATModel->BoneWeightTextures.Add( CreateTexture2DAsset(FPaths::Combine(Directory, CreateTexture2DName("BoneWeight", i))) );
+			VATModel->VertexBasisTextures.Add(CreateTexture2DAsset(FPaths::Combine(Directory, CreateTexture2DName("VertexBasis", i))) );
+			VATModel->VertexNormalBasisTextures.Add(CreateTexture2DAsset(FPaths::Combine(Directory, CreateTexture2DName("VertexNormalBasis", i))) );
+			VATModel->VertexCoefficientTextures.Add(CreateTexture2DAsset(FPaths::Combine(Directory, CreateTexture2DName("VertexCoefficient", i))) );
+			VATModel->VertexBasisRangeTextures.Add(CreateTexture2DAsset(FPaths::Combine(Directory, CreateTexture2DName("VertexBasisRange", i))) );
+		}
+
+		if(VATModel->Settings->UsesFrameRemap())
+		{
+			VATModel->FrameRemapTextures.Add(CreateTexture2DAsset(FPaths::Combine(Directory, CreateTexture2DName("FrameRemap", i))) );
+		}
+
+		if(VATModel->Settings->UsesPagedTextures())
+		{
+			if(VATModel->Mode == EVATModelMode::Vertex)
+			{
+				VATModel->VertexPositionPageTextures.Add(CreateTexture2DArrayAsset(FPaths::Combine(Directory, CreateTexture2DName("VertexPositionPages", i))) );
+				VATModel->VertexNormalPageTextures.Add(CreateTexture2DArrayAsset(FPaths::Combine(Directory, CreateTexture2DName("VertexNormalPages", i))) );
+			}
+			VATModel->PageTableTextures.Add(CreateTexture2DAsset(FPaths::Combine(Directory, CreateTexture2DName("PageTable", i))) );
 		}
 	}
 }
@@ -275,6 +448,9 @@ UTexture2D* FVATModelEditorToolkit::CreateTexture2DAsset(FString Path)
 	
 	if( NewAsset )
 	{
+		// VAT data is linear. This also allows the texture to be used as a LinearColor parameter default.
+		Cast<UTexture2D>(NewAsset)->SRGB = false;
+
 		// package needs saving
 		bool bSuccess = NewAsset->MarkPackageDirty();
 
@@ -285,6 +461,33 @@ UTexture2D* FVATModelEditorToolkit::CreateTexture2DAsset(FString Path)
 	return Cast<UTexture2D>(NewAsset);
 }
 
+UTexture2DArray* FVATModelEditorToolkit::CreateTexture2DArrayAsset(FString Path)
+{
+	FAssetToolsModule& AssetToolsModule = FModuleManager::Get().LoadModuleChecked<FAssetToolsModule>("AssetTools");
+
+	FString PackageName;
+	FString Name;
+	AssetToolsModule.Get().CreateUniqueAssetName(Path, "", /*out*/ PackageName, /*out*/ Name);
+
+	// Texture Arrays are filled from their Source, so no source textures are needed.
+	UTexture2DArray* NewAsset = NewObject<UTexture2DArray>(CreatePackage(*PackageName), FName(Name), RF_Standalone | RF_Public);
+
+	UE_LOG(LogTemp, Log, TEXT("Creating %s"), *PackageName);
+
+	if( NewAsset )
+	{
+		NewAsset->SRGB = false;
+
+		// package needs saving
+		NewAsset->MarkPackageDirty();
+
+		// Notify the asset registry
+		FAssetRegistryModule::AssetCreated(NewAsset);
+	}
+
+	return NewAsset;
+}
+
 FString FVATModelEditorToolkit::CreateTexture2DName(FString Name, const int32 LODIndex )
 {
 	if(LODIndex < 0)
@@ -454,14 +657,18 @@ bool FVATModelEditorToolkit::AnimationToTexture(UVATModel* Model, const int32 LO
 		return false;
 	}
 
-	// Reset DataAsset Info Values
+	// Reset DataAsset Info Values.
+	// Per-animation info of the first LOD (pages, shared frames) is kept for the next LODs.
+	const TArray<FVATAnimInfo> FirstLODAnimations = LODIndex > 0 ? Model->Animations : TArray<FVATAnimInfo>();
 	Model->ResetInfo();
 
 	// ---------------------------------------------------------------------------		
 	// Get Mapping between Static and Skeletal Meshes
 	// Since they might not have same number of points.
+	// Rigid Binding doesn't need the mapping, all vertices follow the socket.
 	//
 	FSourceMeshToDriverMesh Mapping;
+	if (SocketIndex == INDEX_NONE)
 	{
 		FScopedSlowTask ProgressBar(1.f, LOCTEXT("ProcessingMapping", "Processing StaticMesh -> SkeletalMesh Mapping ..."), true /*Enabled*/);
 		ProgressBar.MakeDialog(false /*bShowCancelButton*/, false /*bAllowInPIE*/);
@@ -471,7 +678,12 @@ bool FVATModelEditorToolkit::AnimationToTexture(UVATModel* Model, const int32 LO
 	}
 
 	// Get Number of Source Vertices (StaticMesh)
-	const int32 NumVertices = Mapping.GetNumSourceVertices();
+	int32 NumVertices = Mapping.GetNumSourceVertices();
+	if (SocketIndex != INDEX_NONE)
+	{
+		TArray<FVector3f> Positions, Normals;
+		NumVertices = FMath::Max(FVATSkeletalMeshUtilities::GetVertices(Model->GetStaticMesh(), LODIndex, Positions, Normals), 0);
+	}
 
 	UE_LOG(LogTemp, Log, TEXT("LOD: %d Num Vertices: %d"), LODIndex, NumVertices);
 	
@@ -483,21 +695,53 @@ bool FVATModelEditorToolkit::AnimationToTexture(UVATModel* Model, const int32 LO
 	// ---------------------------------------------------------------------------
 	// Get Reference Skeleton Transforms
 	//
+	TArray<FVector3f> SkeletonRefPositions;
+	TArray<float> BoneImportances;
 	TArray<FVector3f> BoneRefPositions;
 	TArray<FVector4f> BoneRefRotations;
 	TArray<FVector3f> BonePositions;
 	TArray<FVector4f> BoneRotations;
+
+	// Animation Library. Shared Bone textures are only written when the library is out of date
+	UVATAnimationLibrary* AnimationLibrary = Model->Mode == EVATModelMode::Bone ? Model->AnimationLibrary.Get() : nullptr;
+	FString AnimationLibraryKey;
 	
 	if (Model->Mode == EVATModelMode::Bone)
 	{
 		// Gets Ref Bone Position and Rotations.
 		Model->NumBones = GetRefBonePositionsAndRotations(Model->GetSkeletalMesh(),
 			BoneRefPositions, BoneRefRotations);
+		SkeletonRefPositions = BoneRefPositions;
+
+		// Rigid Binding only bakes the socket. Otherwise only bake the bones referenced by skin weights,
+		// and order them by importance for Bone LODs
+		if (SocketIndex != INDEX_NONE || Model->Settings->bCullUnusedBones || Model->Settings->bReduceBoneLODs)
+		{
+			if (SocketIndex != INDEX_NONE)
+			{
+				Model->BoneMap = { SocketIndex };
+				BoneImportances = { 1.f };
+			}
+			else
+			{
+				GetBoneMap(Model, Model->BoneMap, BoneImportances);
+			}
+			BoneRefPositions = GatherBones(BoneRefPositions, Model->BoneMap);
+			BoneRefRotations = GatherBones(BoneRefRotations, Model->BoneMap);
+
+			UE_LOG(LogTemp, Log, TEXT("Baked Bones: %d / %d"), Model->BoneMap.Num(), Model->NumBones);
+			Model->NumBones = Model->BoneMap.Num();
+		}
 
 		// Add RefPose 
 		// Note: this is added in the first frame of the Bone Position and Rotation Textures
 		BonePositions.Append(BoneRefPositions);
 		BoneRotations.Append(BoneRefRotations);
+
+		if (AnimationLibrary)
+		{
+			AnimationLibraryKey = GetAnimationLibraryKey(Model, AnimSequences, BoneRefPositions, BoneRefRotations);
+		}
 	}
 
 	// --------------------------------------------------------------------------
@@ -546,18 +790,27 @@ bool FVATModelEditorToolkit::AnimationToTexture(UVATModel* Model, const int32 LO
 		const int32 AnimNumFrames = GetAnimationFrameRange(AnimSequenceInfo, AnimStartFrame, AnimEndFrame);
 		const float AnimStartTime = AnimSequence->GetTimeAtFrame(AnimStartFrame);
 
+		// Custom SampleRates sample the animation time range, otherwise frames are sampled at the Model SampleRate.
+		const float SampleRate = AnimSequenceInfo.bUseCustomSampleRate ? AnimSequenceInfo.SampleRate : Model->Settings->SampleRate;
+		int32 AnimNumSamples = AnimNumFrames;
+		if (AnimSequenceInfo.bUseCustomSampleRate)
+		{
+			const float AnimDuration = AnimSequence->GetTimeAtFrame(AnimEndFrame) - AnimStartTime;
+			AnimNumSamples = FMath::FloorToInt32(AnimDuration * SampleRate + UE_KINDA_SMALL_NUMBER) + 1;
+		}
+
 		int32 SampleIndex = 0;
-		const float SampleInterval = 1.f / Model->Settings->SampleRate;
+		const float SampleInterval = 1.f / SampleRate;
 
 		// Progress Bar
 		FFormatNamedArguments Args;
 		Args.Add(TEXT("AnimSequenceIndex"), AnimSequenceIndex+1);
 		Args.Add(TEXT("NumAnimSequences"), AnimSequences.Num());
 		Args.Add(TEXT("AnimSequence"), FText::FromString(*AnimSequence->GetFName().ToString()));
-		FScopedSlowTask AnimProgressBar(AnimNumFrames, FText::Format(LOCTEXT("ProcessingAnimSequence", "Processing AnimSequence: {AnimSequence} [{AnimSequenceIndex}/{NumAnimSequences}]"), Args), true /*Enabled*/);
+		FScopedSlowTask AnimProgressBar(AnimNumSamples, FText::Format(LOCTEXT("ProcessingAnimSequence", "Processing AnimSequence: {AnimSequence} [{AnimSequenceIndex}/{NumAnimSequences}]"), Args), true /*Enabled*/);
 		AnimProgressBar.MakeDialog(false /*bShowCancelButton*/, false /*bAllowInPIE*/);
 
-		while (SampleIndex < AnimNumFrames)
+		while (SampleIndex < AnimNumSamples)
 		{
 			AnimProgressBar.EnterProgressFrame();
 
@@ -571,9 +824,12 @@ bool FVATModelEditorToolkit::AnimationToTexture(UVATModel* Model, const int32 LO
 			SkeletalMeshComponent->RefreshBoneTransforms(nullptr /*TickFunction*/);
 			
 			// ---------------------------------------------------------------------------
-			// Store Vertex Deltas & Normals.
+			// Store Vertex Deltas & Normals. Hybrid Bone Mode keeps them as the ground truth of the residuals,
+			// Vertex Sections bake them.
 			//
-			if (Model->Mode == EVATModelMode::Vertex)
+			if (Model->Mode == EVATModelMode::Vertex || Model->Mode == EVATModelMode::CompressedVertex ||
+				Model->Mode == EVATModelMode::SkinningDecomposition ||
+				(Model->Mode == EVATModelMode::Bone && (Model->Settings->bBakeResiduals || Model->Settings->UsesVertexSections())))
 			{
 				TArray<FVector3f> VertexFrameDeltas;
 				TArray<FVector3f> VertexFrameNormals;
@@ -589,28 +845,94 @@ bool FVATModelEditorToolkit::AnimationToTexture(UVATModel* Model, const int32 LO
 			// ---------------------------------------------------------------------------
 			// Store Bone Positions & Rotations
 			//
-			else if (Model->Mode == EVATModelMode::Bone)
+			if (Model->Mode == EVATModelMode::Bone)
 			{
 				TArray<FVector3f> BoneFramePositions;
 				TArray<FVector4f> BoneFrameRotations;
 
-				GetBonePositionsAndRotations(SkeletalMeshComponent, BoneRefPositions,
+				GetBonePositionsAndRotations(SkeletalMeshComponent, SkeletonRefPositions,
 					BoneFramePositions, BoneFrameRotations);
 
+				if (Model->BoneMap.Num())
+				{
+					BoneFramePositions = GatherBones(BoneFramePositions, Model->BoneMap);
+					BoneFrameRotations = GatherBones(BoneFrameRotations, Model->BoneMap);
+				}
+
 				BonePositions.Append(BoneFramePositions);
 				BoneRotations.Append(BoneFrameRotations);
 
 			}
 		} // End Frame
 
+		// ---------------------------------------------------------------------------
+		// Auto SampleRate. Keeps every SampleStep-th frame. 
+		// Steps are picked on the first LOD, so all LODs have the same frames.
+		//
+		int32 SampleStep = 1;
+		if (Model->Settings->bAutoSampleRate)
+		{
+			if (LODIndex == 0 || !Model->AutoSampleSteps.IsValidIndex(AnimSequenceIndex))
+			{
+				TArray<FVector3f> Points;
+				int32 NumPoints;
+				if (Model->Mode == EVATModelMode::Bone)
+				{
+					// Proxy Points need the RefPose in the first frame
+					TArray<FVector3f> AnimBonePositions(BoneRefPositions);
+					TArray<FVector4f> AnimBoneRotations(BoneRefRotations);
+					AnimBonePositions.Append(&BonePositions[(Model->NumFrames + 1) * Model->NumBones], AnimNumSamples * Model->NumBones);
+					AnimBoneRotations.Append(&BoneRotations[(Model->NumFrames + 1) * Model->NumBones], AnimNumSamples * Model->NumBones);
+					FVATKeyframeReduction::GetBoneProxyPoints(AnimBonePositions, AnimBoneRotations, Model->NumBones, AnimNumSamples, Points);
+					NumPoints = Model->NumBones * 3;
+				}
+				else
+				{
+					Points.Append(&VertexDeltas[Model->NumFrames * NumVertices], AnimNumSamples * NumVertices);
+					NumPoints = NumVertices;
+				}
+
+				const int32 MaxStep = FMath::Max(FMath::FloorToInt32(SampleRate / Model->Settings->MinSampleRate), 1);
+				Model->AutoSampleSteps.SetNum(FMath::Max(Model->AutoSampleSteps.Num(), AnimSequenceIndex + 1));
+				Model->AutoSampleSteps[AnimSequenceIndex] = FVATKeyframeReduction::FindSampleStep(Points, NumPoints, MaxStep, Model->Settings->SampleRateErrorTolerance);
+			}
+			SampleStep = Model->AutoSampleSteps[AnimSequenceIndex];
+
+			if (SampleStep > 1)
+			{
+				TArray<int32> Samples;
+				for (int32 Sample = 0; Sample < AnimNumSamples; Sample += SampleStep)
+				{
+					Samples.Add(Sample);
+				}
+
+				if (Model->Mode == EVATModelMode::Bone)
+				{
+					FVATKeyframeReduction::GatherKeyframes(BonePositions, Model->NumBones, Samples, Model->NumFrames + 1);
+					FVATKeyframeReduction::GatherKeyframes(BoneRotations, Model->NumBones, Samples, Model->NumFrames + 1);
+				}
+				if (Model->Mode != EVATModelMode::Bone || Model->Settings->bBakeResiduals || Model->Settings->UsesVertexSections())
+				{
+					FVATKeyframeReduction::GatherKeyframes(VertexDeltas, NumVertices, Samples, Model->NumFrames);
+					FVATKeyframeReduction::GatherKeyframes(VertexNormals, NumVertices, Samples, Model->NumFrames);
+				}
+				AnimNumSamples = Samples.Num();
+			}
+
+			UE_LOG(LogTemp, Log, TEXT("LOD: %d AnimSequence: %s SampleRate: %.2f Frames: %d"), LODIndex,
+				*AnimSequence->GetName(), SampleRate / (float)SampleStep, AnimNumSamples);
+		}
+
 		// Store Anim Info Data
-		FVATAnimInfo AnimInfo;
+		const int32 AnimationIndex = Model->Animations.Num();
+		FVATAnimInfo AnimInfo = FirstLODAnimations.IsValidIndex(AnimationIndex) ? FirstLODAnimations[AnimationIndex] : FVATAnimInfo();
 		AnimInfo.StartFrame = Model->NumFrames;
-		AnimInfo.EndFrame = Model->NumFrames + AnimNumFrames - 1;
+		AnimInfo.EndFrame = Model->NumFrames + AnimNumSamples - 1;
+		AnimInfo.SampleRate = SampleRate / (float)SampleStep;
 		Model->Animations.Add(AnimInfo);
 
 		// Accumulate Frames
-		Model->NumFrames += AnimNumFrames;
+		Model->NumFrames += AnimNumSamples;
 
 	} // End Anim
 		
@@ -620,153 +942,1022 @@ bool FVATModelEditorToolkit::AnimationToTexture(UVATModel* Model, const int32 LO
 	Actor->Destroy();
 	
 	// ---------------------------------------------------------------------------
-
-	if (Model->Mode == EVATModelMode::Vertex)
+	// Fit Virtual Bones to Vertex Data.
+	// Bone Positions, Rotations and SkinWeights are then written as in Bone Mode.
+	//
+	TArray<VertexSkinWeightFour> DecompositionSkinWeights;
+	
+	if (Model->Mode == EVATModelMode::SkinningDecomposition)
 	{
-		// Find Best Resolution for Vertex Data
-		int32 Height, Width;
-		if (!FindBestResolution(Model->NumFrames, NumVertices, 
-								Height, Width, Model->VertexRowsPerFrame[LODIndex], 
-								Model->Settings->MaxHeight, Model->Settings->MaxWidth, Model->Settings->bEnforcePowerOfTwo))
+		FScopedSlowTask ProgressBar(1.f, LOCTEXT("ProcessingDecomposition", "Processing Skinning Decomposition ..."), true /*Enabled*/);
+		ProgressBar.MakeDialog(false /*bShowCancelButton*/, false /*bAllowInPIE*/);
+
+		TArray<FVector3f> RestVertices;
+		Mapping.GetSourceVertices(RestVertices);
+
+		int32 NumInfluences = 4;
+		switch (Model->Settings->NumBoneInfluences)
 		{
-			UE_LOG(LogTemp, Warning, TEXT("Vertex Animation data cannot be fit in a %ix%i texture."), Model->Settings->MaxHeight, Model->Settings->MaxWidth);
-			return false;
+			case EVATNumBoneInfluences::One: NumInfluences = 1; break;
+			case EVATNumBoneInfluences::Two: NumInfluences = 2; break;
+			case EVATNumBoneInfluences::Four: NumInfluences = 4; break;
 		}
 
-		// Normalize Vertex Data
-		TArray<FVector3f> NormalizedVertexDeltas;
-		TArray<FVector3f> NormalizedVertexNormals;
-		NormalizeVertexData(
-			VertexDeltas, VertexNormals,
-			Model->VertexMinBBox, Model->VertexSizeBBox,
-			NormalizedVertexDeltas, NormalizedVertexNormals);
+		Model->NumBones = Model->Settings->NumVirtualBones;
 
-		// Write Textures
-		if (Model->Settings->Precision == EVATPrecision::SixteenBits)
+		// Bones are fitted on the first LOD, following LODs reuse them and only solve their weights.
+		float& DecompositionError = Model->DecompositionErrors[LODIndex];
+		if (LODIndex == 0 || Model->VirtualBoneTransforms.Num() != Model->NumFrames * Model->NumBones)
 		{
-			FVATUtils::WriteVectorsToTexture<FVector3f, FHighPrecision>(NormalizedVertexDeltas, Model->NumFrames, Model->VertexRowsPerFrame[LODIndex], Height, Width, Model->GetVertexPositionTexture(LODIndex));
-			FVATUtils::WriteVectorsToTexture<FVector3f, FHighPrecision>(NormalizedVertexNormals, Model->NumFrames, Model->VertexRowsPerFrame[LODIndex], Height, Width, Model->GetVertexNormalTexture(LODIndex));
+			DecompositionError = FVATSkinningDecomposition::Decompose(RestVertices, VertexDeltas,
+				Model->NumFrames, Model->NumBones, NumInfluences,
+				Model->Settings->DecompositionErrorTolerance, Model->Settings->MaxDecompositionIterations,
+				Model->VirtualBoneTransforms, DecompositionSkinWeights);
 		}
 		else
 		{
-			FVATUtils::WriteVectorsToTexture<FVector3f, FLowPrecision>(NormalizedVertexDeltas, Model->NumFrames, Model->VertexRowsPerFrame[LODIndex], Height, Width, Model->GetVertexPositionTexture(LODIndex));
-			FVATUtils::WriteVectorsToTexture<FVector3f, FLowPrecision>(NormalizedVertexNormals, Model->NumFrames, Model->VertexRowsPerFrame[LODIndex], Height, Width, Model->GetVertexNormalTexture(LODIndex));
-		}		
+			DecompositionError = FVATSkinningDecomposition::SolveSkinWeights(RestVertices, VertexDeltas,
+				Model->NumFrames, Model->NumBones, NumInfluences,
+				Model->VirtualBoneTransforms, DecompositionSkinWeights);
+		}
 
-		// Add Vertex UVChannel
-		CreateUVChannel(Model->GetStaticMesh(), LODIndex, Model->UVChannel, Height, Width);
+		UE_LOG(LogTemp, Log, TEXT("LOD: %d Virtual Bones: %d RMS Error: %f Texels: %d (Vertex Mode: %d)"), LODIndex,
+			Model->NumBones, DecompositionError,
+			(Model->NumFrames + 1) * Model->NumBones * 2 + NumVertices * 2,
+			Model->NumFrames * NumVertices * 2);
 
-		// Update Bounds
-		SetBoundsExtensions(Model->GetStaticMesh(), (FVector)Model->VertexMinBBox, (FVector)Model->VertexSizeBBox);
+		if (DecompositionError > Model->Settings->DecompositionErrorTolerance)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Skinning Decomposition Error: %f is over the tolerance: %f. Consider increasing NumVirtualBones."),
+				DecompositionError, Model->Settings->DecompositionErrorTolerance);
+		}
 
-		// Done with StaticMesh
-		Model->GetStaticMesh()->PostEditChange();
+		// RefPose. Virtual Bones have no rest rotation and pivot around their vertices.
+		// Pivots are kept from the first LOD, so all LODs write the same Bone data.
+		if (LODIndex == 0 || Model->VirtualBonePivots.Num() != Model->NumBones)
+		{
+			FVATSkinningDecomposition::GetBonePivots(RestVertices, DecompositionSkinWeights, Model->NumBones, Model->VirtualBonePivots);
+		}
+		const TArray<FVector3f>& BonePivots = Model->VirtualBonePivots;
+		BonePositions.Append(BonePivots);
+		BoneRotations.Init(FVector4f(1.f, 0.f, 0.f, 0.f), Model->NumBones);
+
+		// Frames. Position Delta of the pivot and Rotation relative to RefPose
+		for (int32 Frame = 0; Frame < Model->NumFrames; Frame++)
+		{
+			for (int32 BoneIndex = 0; BoneIndex < Model->NumBones; BoneIndex++)
+			{
+				const FTransform3f& Transform = Model->VirtualBoneTransforms[Frame * Model->NumBones + BoneIndex];
+
+				FVector3f Axis;
+				float Angle;
+				Transform.GetRotation().ToAxisAndAngle(Axis, Angle);
+
+				BonePositions.Add(Transform.TransformPosition(BonePivots[BoneIndex]) - BonePivots[BoneIndex]);
+				BoneRotations.Add(FVector4f(Axis, Angle));
+			}
+		}
 	}
 
 	// ---------------------------------------------------------------------------
-	
-	if (Model->Mode == EVATModelMode::Bone)
+	// Keyframe Reduction and Frame Deduplication.
+	// Only Keyframes are stored, the FrameRemap texture maps every baked frame to them.
+	//
+	int32 NumKeyframes = Model->NumFrames;
+	TArray<int32> Keyframes;
+
+	// Texture memory saved by the deduplicated frames. Counted from the texels of a frame of each written texture,
+	// padding included.
+	int32 NumDuplicates = 0;
+	const int32 PrecisionBytesPerTexel = Model->Settings->Precision == EVATPrecision::SixteenBits ? 8 : 4;
+	const auto AddDeduplicatedBytes = [Model, LODIndex, &NumDuplicates](const int32 TexelsPerFrame, const int32 BytesPerTexel)
 	{
-		// Find Best Resolution for Bone Data
-		int32 Height, Width;
-
-		// Write Bone Position and Rotation Textures
+		if (!NumDuplicates)
 		{
-			// Note we are adding +1 frame for the ref pose
-			if (!FindBestResolution(Model->NumFrames + 1, Model->NumBones,
-				Height, Width, Model->BoneRowsPerFrame[LODIndex],
-				Model->Settings->MaxHeight, Model->Settings->MaxWidth, Model->Settings->bEnforcePowerOfTwo))
-			{
-				UE_LOG(LogTemp, Warning, TEXT("Bone Animation data cannot be fit in a %ix%i texture."), Model->Settings->MaxHeight, Model->Settings->MaxWidth);
-				return false;
-			}
+			return;
+		}
 
-			// Normalize Bone Data
-			TArray<FVector3f> NormalizedBonePositions;
-			TArray<FVector4f> NormalizedBoneRotations;
-			NormalizeBoneData(
-				BonePositions, BoneRotations,
-				Model->BoneMinBBox, Model->BoneSizeBBox,
-				NormalizedBonePositions, NormalizedBoneRotations);
+		const int64 SavedBytes = (int64)NumDuplicates * TexelsPerFrame * BytesPerTexel;
+		Model->DeduplicatedBytes += SavedBytes;
 
+		UE_LOG(LogTemp, Log, TEXT("LOD: %d Deduplication Saved: %lld bytes"), LODIndex, SavedBytes);
+	};
 
-			// Write Textures
-			if (Model->Settings->Precision == EVATPrecision::SixteenBits)
-			{
-				FVATUtils::WriteVectorsToTexture<FVector3f, FHighPrecision>(NormalizedBonePositions, Model->NumFrames + 1, Model->BoneRowsPerFrame[LODIndex], Height, Width, Model->GetBonePositionTexture());
-				FVATUtils::WriteVectorsToTexture<FVector4f, FHighPrecision>(NormalizedBoneRotations, Model->NumFrames + 1, Model->BoneRowsPerFrame[LODIndex], Height, Width, Model->GetBoneRotationTexture());
-			}
-			else
-			{
-				FVATUtils::WriteVectorsToTexture<FVector3f, FLowPrecision>(NormalizedBonePositions, Model->NumFrames + 1, Model->BoneRowsPerFrame[LODIndex], Height, Width, Model->GetBonePositionTexture());
-				FVATUtils::WriteVectorsToTexture<FVector4f, FLowPrecision>(NormalizedBoneRotations, Model->NumFrames + 1, Model->BoneRowsPerFrame[LODIndex], Height, Width, Model->GetBoneRotationTexture());
-			}
+	if (Model->Settings->UsesFrameRemap())
+	{
+		const bool bBoneData = Model->Mode == EVATModelMode::Bone || Model->Mode == EVATModelMode::SkinningDecomposition;
 
-			// Update Bounds
-			SetBoundsExtensions(Model->GetStaticMesh(), (FVector)Model->BoneMinBBox, (FVector)Model->BoneSizeBBox);
+		TArray<FVector3f> BoneProxyPoints;
+		if (bBoneData)
+		{
+			FVATKeyframeReduction::GetBoneProxyPoints(BonePositions, BoneRotations, Model->NumBones, Model->NumFrames, BoneProxyPoints);
 		}
+		const TArray<FVector3f>& Points = bBoneData ? BoneProxyPoints : VertexDeltas;
+		const int32 NumPoints = bBoneData ? Model->NumBones * 3 : NumVertices;
 
-		// ---------------------------------------------------------------------------
-		
-		// Write Weights Texture
+		TArray<FVector4f> FrameRemap;
+		if (Model->Settings->bReduceKeyframes)
 		{
-			// Find Best Resolution for Bone Weights Texture
-			if (!FindBestResolution(2, NumVertices,
-				Height, Width, Model->BoneWeightRowsPerFrame[LODIndex],
-				Model->Settings->MaxHeight, Model->Settings->MaxWidth, Model->Settings->bEnforcePowerOfTwo))
-			{
-				UE_LOG(LogTemp, Warning, TEXT("Weights Data cannot be fit in a %ix%i texture."), Model->Settings->MaxHeight, Model->Settings->MaxWidth);
-				return false;
-			}
+			NumKeyframes = FVATKeyframeReduction::ReduceKeyframes(Points, NumPoints,
+				Model->Animations, Model->Settings->KeyframeErrorTolerance, Model->Settings->bTrimStaticFrames,
+				Keyframes, FrameRemap);
 
-			TArray<TVertexSkinWeight<4>> SkinWeights;
+			UE_LOG(LogTemp, Log, TEXT("LOD: %d Keyframes: %d / %d (%.1f%%)"), LODIndex, NumKeyframes, Model->NumFrames,
+				100.f * (float)NumKeyframes / (float)Model->NumFrames);
+		}
+		else
+		{
+			NumKeyframes = FVATKeyframeReduction::GetFrameRemap(Model->Animations, Model->NumFrames, Keyframes, FrameRemap);
+		}
 
-			// Reduce BoneWeights to 4 Influences.
-			if (SocketIndex == INDEX_NONE)
-			{
-				// Project SkinWeights from SkeletalMesh to StaticMesh
-				TArray<VertexSkinWeightMax> StaticMeshSkinWeights;
-				Mapping.ProjectSkinWeights(StaticMeshSkinWeights);
+		if (Model->Settings->bDeduplicateFrames)
+		{
+			NumDuplicates = NumKeyframes - FVATKeyframeReduction::DeduplicateKeyframes(Points, NumPoints,
+				Model->Settings->FrameDeduplicationTolerance, Keyframes, FrameRemap);
+			NumKeyframes -= NumDuplicates;
 
-				// Reduce Weights to 4 highest influences.
-				FVATSkeletalMeshUtilities::ReduceSkinWeights(StaticMeshSkinWeights, SkinWeights);
-			}
-			// If Valid Socket, set all influences to same index.
-			else
+			// Frames referencing a Keyframe baked by another animation. Stored with the first LOD, the next LODs keep it.
+			if (LODIndex == 0)
 			{
-				// Set all indices and weights to same SocketIndex
-				SkinWeights.SetNumUninitialized(NumVertices);
-				for (TVertexSkinWeight<4>& SkinWeight : SkinWeights)
+				for (FVATAnimInfo& AnimInfo : Model->Animations)
 				{
-					SkinWeight.BoneWeights = TStaticArray<uint8, 4>(InPlace, 255);
-					SkinWeight.MeshBoneIndices = TStaticArray<uint16, 4>(InPlace, SocketIndex);
+					AnimInfo.NumSharedFrames = 0;
+					for (int32 Frame = AnimInfo.StartFrame; Frame <= AnimInfo.EndFrame; Frame++)
+					{
+						const int32 Keyframe = Keyframes[(int32)FrameRemap[Frame].X];
+						AnimInfo.NumSharedFrames += (Keyframe < AnimInfo.StartFrame || Keyframe > AnimInfo.EndFrame) ? 1 : 0;
+					}
 				}
 			}
 
-			UE_LOG(LogTemp, Log, TEXT("SkinWeightsNum: %d"), SkinWeights.Num());
+			UE_LOG(LogTemp, Log, TEXT("LOD: %d Deduplicated Frames: %d Stored Frames: %d"), LODIndex, NumDuplicates, NumKeyframes);
+		}
 
-			// Write Bone Weights Texture
-			if (Model->Settings->Precision == EVATPrecision::SixteenBits)
-			{
-				FVATUtils::WriteSkinWeightsToTexture<FHighPrecision>(SkinWeights, Model->NumBones,
-					Model->BoneWeightRowsPerFrame[LODIndex], Height, Width, Model->GetBoneWeightTexture(LODIndex));
-			}
-			else
-			{
-				FVATUtils::WriteSkinWeightsToTexture<FLowPrecision>(SkinWeights, Model->NumBones,
-					Model->BoneWeightRowsPerFrame[LODIndex], Height, Width, Model->GetBoneWeightTexture(LODIndex));
-			}
+		// Keep Keyframes only. Bone data has the RefPose in the first frame.
+		if (bBoneData)
+		{
+			FVATKeyframeReduction::GatherKeyframes(BonePositions, Model->NumBones, Keyframes, 1);
+			FVATKeyframeReduction::GatherKeyframes(BoneRotations, Model->NumBones, Keyframes, 1);
+		}
+		if (!bBoneData || (Model->Mode == EVATModelMode::Bone && (Model->Settings->bBakeResiduals || Model->Settings->UsesVertexSections())))
+		{
+			FVATKeyframeReduction::GatherKeyframes(VertexDeltas, NumVertices, Keyframes);
+			FVATKeyframeReduction::GatherKeyframes(VertexNormals, NumVertices, Keyframes);
+		}
 
-			// Add Vertex UVChannel
-			CreateUVChannel(Model->GetStaticMesh(), LODIndex, Model->UVChannel, Height, Width);
+		// Write FrameRemap Texture
+		int32 Height, Width, RowsPerFrame;
+		if (!FindBestResolution(1, Model->NumFrames,
+			Height, Width, RowsPerFrame,
+			Model->Settings->MaxHeight, Model->Settings->MaxWidth, Model->Settings->bEnforcePowerOfTwo, Model->Settings->bMinimizePaddedTextureSize))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("FrameRemap data cannot be fit in a %ix%i texture."), Model->Settings->MaxHeight, Model->Settings->MaxWidth);
+			return false;
 		}
 
-		// Done with StaticMesh
-		Model->GetStaticMesh()->PostEditChange();
+		FVATUtils::WriteVectorsToTexture<FVector4f, FFullPrecision>(FrameRemap, 1, RowsPerFrame, Height, Width, Model->GetFrameRemapTexture(LODIndex));
+	}
+
+	Model->NumKeyframes[LODIndex] = NumKeyframes;
+
+	// Animation of each stored frame. Used for finding the pages of each animation.
+	TArray<int32> FrameGroups;
+	if (Model->Settings->UsesPagedTextures())
+	{
+		FrameGroups.SetNumUninitialized(NumKeyframes);
+		int32 AnimationIndex = 0;
+		for (int32 Index = 0; Index < NumKeyframes; Index++)
+		{
+			// Stored frames keep the animation order
+			const int32 Frame = Model->Settings->UsesFrameRemap() ? Keyframes[Index] : Index;
+			while (AnimationIndex < Model->Animations.Num() - 1 && Frame > Model->Animations[AnimationIndex].EndFrame)
+			{
+				AnimationIndex++;
+			}
+			FrameGroups[Index] = AnimationIndex;
+		}
 	}
+	const bool bPagePerAnimation = Model->Settings->TextureLayout == EVATTextureLayout::PerAnimation;
 
 	// ---------------------------------------------------------------------------
-	// Mark Packages dirty
+	// Triangles in draw order, used for assigning vertex texels in the order vertices are processed.
+	// The StaticMesh build keeps its own (cache optimized) triangle order, so only the texels change.
+	// The mesh triangle order is kept for reporting the cache misses.
+	//
+	TArray<int32> OptimizedIndices;
+	TArray<int32> MeshIndices;
+	if (Model->Settings->bOptimizeVertexOrder)
+	{
+		int32 NumMeshVertices;
+		if (FVATVertexReorder::GetTriangleIndices(Model->GetStaticMesh(), LODIndex, MeshIndices, NumMeshVertices) && NumMeshVertices == NumVertices)
+		{
+			FVATVertexReorder::OptimizeTriangleOrder(MeshIndices, NumVertices, VertexCacheSize, OptimizedIndices);
+		}
+		else
+		{
+			UE_LOG(LogTemp, Warning, TEXT("LOD: %d Unable to get StaticMesh triangles. Vertex order is not optimized."), LODIndex);
+		}
+	}
+	TArray<int32> VertexTexels;
+
+	// ---------------------------------------------------------------------------
+
+	if (Model->Mode == EVATModelMode::Vertex)
+	{
+		// Skip Static Vertices. Only dynamic vertices are stored, static vertices get no texels
+		int32 NumElements = NumVertices;
+		TArray<int32> DynamicVertices;
+		TArray<int32> ElementIndices = OptimizedIndices;
+		TArray<int32> ElementMeshIndices = MeshIndices;
+		if (Model->Settings->bSkipStaticVertices)
+		{
+			GetDynamicVertices(VertexDeltas, NumVertices, NumKeyframes, Model->Settings->StaticVertexTolerance, DynamicVertices);
+			NumElements = DynamicVertices.Num();
+			Model->NumStaticVertices[LODIndex] = NumVertices - NumElements;
+
+			UE_LOG(LogTemp, Log, TEXT("LOD: %d Static Vertices: %d / %d"), LODIndex, NumVertices - NumElements, NumVertices);
+
+			VertexDeltas = GatherFrameElements(VertexDeltas, NumVertices, DynamicVertices);
+			VertexNormals = GatherFrameElements(VertexNormals, NumVertices, DynamicVertices);
+			ElementIndices = GatherIndices(OptimizedIndices, DynamicVertices, NumVertices);
+			ElementMeshIndices = GatherIndices(MeshIndices, DynamicVertices, NumVertices);
+		}
+
+		// Find Best Resolution for Vertex Data
+		int32 Height, Width;
+		TArray<FIntPoint> FramePages;
+		if (Model->Settings->UsesPagedTextures())
+		{
+			if (!FindBestPagedResolution(NumKeyframes, NumElements, bPagePerAnimation ? FrameGroups : TArray<int32>(), 0,
+									Height, Width, Model->VertexRowsPerFrame[LODIndex], FramePages, Model->NumPages[LODIndex],
+									Model->Settings->MaxHeight, Model->Settings->MaxWidth, Model->Settings->bEnforcePowerOfTwo, Model->Settings->bMinimizePaddedTextureSize))
+			{
+				UE_LOG(LogTemp, Warning, TEXT("Vertex Animation data cannot be paged in %ix%i textures."), Model->Settings->MaxHeight, Model->Settings->MaxWidth);
+				return false;
+			}
+
+			if (LODIndex == 0)
+			{
+				SetAnimationPages(Model, FrameGroups, FramePages);
+			}
+		}
+		else if (!FindBestResolution(NumKeyframes, NumElements, 
+								Height, Width, Model->VertexRowsPerFrame[LODIndex], 
+								Model->Settings->MaxHeight, Model->Settings->MaxWidth, Model->Settings->bEnforcePowerOfTwo, Model->Settings->bMinimizePaddedTextureSize))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Vertex Animation data cannot be fit in a %ix%i texture."), Model->Settings->MaxHeight, Model->Settings->MaxWidth);
+			return false;
+		}
+
+		// Position and Normal textures
+		AddDeduplicatedBytes(Model->VertexRowsPerFrame[LODIndex] * Width * 2, PrecisionBytesPerTexel);
+
+		// Reorder Vertex Data
+		if (GetOptimizedVertexTexels(ElementIndices, ElementMeshIndices, NumElements, Width, Model->VertexRowsPerFrame[LODIndex], VertexTexels))
+		{
+			FVATVertexReorder::ScatterElements(VertexDeltas, NumElements, VertexTexels);
+			FVATVertexReorder::ScatterElements(VertexNormals, NumElements, VertexTexels);
+		}
+
+		// Normalize Vertex Data
+		TArray<FVector3f> NormalizedVertexDeltas;
+		TArray<FVector3f> NormalizedVertexNormals;
+		NormalizeVertexData(
+			VertexDeltas, VertexNormals,
+			Model->VertexMinBBox, Model->VertexSizeBBox,
+			NormalizedVertexDeltas, NormalizedVertexNormals);
+
+		// Write Textures
+		if (Model->Settings->UsesPagedTextures())
+		{
+			const int32 NumPages = Model->NumPages[LODIndex];
+			if (Model->Settings->Precision == EVATPrecision::SixteenBits)
+			{
+				FVATUtils::WriteVectorsToTextureArray<FVector3f, FHighPrecision>(NormalizedVertexDeltas, NumKeyframes, Model->VertexRowsPerFrame[LODIndex], Height, Width, FramePages, NumPages, Model->GetVertexPositionPageTexture(LODIndex));
+				FVATUtils::WriteVectorsToTextureArray<FVector3f, FHighPrecision>(NormalizedVertexNormals, NumKeyframes, Model->VertexRowsPerFrame[LODIndex], Height, Width, FramePages, NumPages, Model->GetVertexNormalPageTexture(LODIndex));
+			}
+			else
+			{
+				FVATUtils::WriteVectorsToTextureArray<FVector3f, FLowPrecision>(NormalizedVertexDeltas, NumKeyframes, Model->VertexRowsPerFrame[LODIndex], Height, Width, FramePages, NumPages, Model->GetVertexPositionPageTexture(LODIndex));
+				FVATUtils::WriteVectorsToTextureArray<FVector3f, FLowPrecision>(NormalizedVertexNormals, NumKeyframes, Model->VertexRowsPerFrame[LODIndex], Height, Width, FramePages, NumPages, Model->GetVertexNormalPageTexture(LODIndex));
+			}
+
+			if (!WritePageTable(Model, LODIndex, FramePages))
+			{
+				return false;
+			}
+		}
+		else if (Model->Settings->bTemporalMips)
+		{
+			const int32 NumMips = FVATUtils::GetNumTemporalMips(NumKeyframes, Model->VertexRowsPerFrame[LODIndex], Height, Width, Model->Settings->MaxNumTemporalMips);
+			Model->NumTemporalMips[LODIndex] = NumMips;
+
+			UE_LOG(LogTemp, Log, TEXT("LOD: %d Temporal Mips: %d"), LODIndex, NumMips);
+
+			if (Model->Settings->Precision == EVATPrecision::SixteenBits)
+			{
+				FVATUtils::WriteVectorsToTextureMips<FVector3f, FHighPrecision>(NormalizedVertexDeltas, NumKeyframes, Model->VertexRowsPerFrame[LODIndex], Height, Width, NumMips, Model->GetVertexPositionTexture(LODIndex));
+				FVATUtils::WriteVectorsToTextureMips<FVector3f, FHighPrecision>(NormalizedVertexNormals, NumKeyframes, Model->VertexRowsPerFrame[LODIndex], Height, Width, NumMips, Model->GetVertexNormalTexture(LODIndex));
+			}
+			else
+			{
+				FVATUtils::WriteVectorsToTextureMips<FVector3f, FLowPrecision>(NormalizedVertexDeltas, NumKeyframes, Model->VertexRowsPerFrame[LODIndex], Height, Width, NumMips, Model->GetVertexPositionTexture(LODIndex));
+				FVATUtils::WriteVectorsToTextureMips<FVector3f, FLowPrecision>(NormalizedVertexNormals, NumKeyframes, Model->VertexRowsPerFrame[LODIndex], Height, Width, NumMips, Model->GetVertexNormalTexture(LODIndex));
+			}
+		}
+		else if (Model->Settings->UsesInterleavedFrames())
+		{
+			if (Model->Settings->Precision == EVATPrecision::SixteenBits)
+			{
+				FVATUtils::WriteVectorsToInterleavedTexture<FVector3f, FHighPrecision>(NormalizedVertexDeltas, NumKeyframes, Height, Width, Model->GetVertexPositionTexture(LODIndex));
+				FVATUtils::WriteVectorsToInterleavedTexture<FVector3f, FHighPrecision>(NormalizedVertexNormals, NumKeyframes, Height, Width, Model->GetVertexNormalTexture(LODIndex));
+			}
+			else
+			{
+				FVATUtils::WriteVectorsToInterleavedTexture<FVector3f, FLowPrecision>(NormalizedVertexDeltas, NumKeyframes, Height, Width, Model->GetVertexPositionTexture(LODIndex));
+				FVATUtils::WriteVectorsToInterleavedTexture<FVector3f, FLowPrecision>(NormalizedVertexNormals, NumKeyframes, Height, Width, Model->GetVertexNormalTexture(LODIndex));
+			}
+		}
+		else if (Model->Settings->Precision == EVATPrecision::SixteenBits)
+		{
+			FVATUtils::WriteVectorsToTexture<FVector3f, FHighPrecision>(NormalizedVertexDeltas, NumKeyframes, Model->VertexRowsPerFrame[LODIndex], Height, Width, Model->GetVertexPositionTexture(LODIndex));
+			FVATUtils::WriteVectorsToTexture<FVector3f, FHighPrecision>(NormalizedVertexNormals, NumKeyframes, Model->VertexRowsPerFrame[LODIndex], Height, Width, Model->GetVertexNormalTexture(LODIndex));
+		}
+		else
+		{
+			FVATUtils::WriteVectorsToTexture<FVector3f, FLowPrecision>(NormalizedVertexDeltas, NumKeyframes, Model->VertexRowsPerFrame[LODIndex], Height, Width, Model->GetVertexPositionTexture(LODIndex));
+			FVATUtils::WriteVectorsToTexture<FVector3f, FLowPrecision>(NormalizedVertexNormals, NumKeyframes, Model->VertexRowsPerFrame[LODIndex], Height, Width, Model->GetVertexNormalTexture(LODIndex));
+		}		
+
+		// Texel of each vertex. Static vertices have none
+		if (Model->Settings->bSkipStaticVertices)
+		{
+			TArray<int32> ElementTexels = MoveTemp(VertexTexels);
+			VertexTexels.Init(INDEX_NONE, NumVertices);
+			for (int32 Element = 0; Element < NumElements; Element++)
+			{
+				VertexTexels[DynamicVertices[Element]] = ElementTexels.Num() ? ElementTexels[Element] : Element;
+			}
+		}
+
+		// Add Vertex UVChannel. Interleaved UVs address the rows of vertices, frames are offset in the shader.
+		CreateUVChannel(Model->GetStaticMesh(), LODIndex, Model->UVChannel,
+			Model->Settings->UsesInterleavedFrames() ? Model->VertexRowsPerFrame[LODIndex] : Height, Width, VertexTexels);
+
+		// Update Bounds
+		SetBoundsExtensions(Model->GetStaticMesh(), (FVector)Model->VertexMinBBox, (FVector)Model->VertexSizeBBox);
+
+		// Done with StaticMesh
+		Model->GetStaticMesh()->PostEditChange();
+	}
+
+	// ---------------------------------------------------------------------------
+
+	if (Model->Mode == EVATModelMode::CompressedVertex)
+	{
+		// Compute Basis
+		TArray<FVector3f> DeltaBasis;
+		TArray<FVector3f> NormalBasis;
+		TArray<float> Coefficients;
+		FVATBasisInfo& BasisInfo = Model->BasisInfos[LODIndex];
+		{
+			FScopedSlowTask ProgressBar(1.f, LOCTEXT("ProcessingBasis", "Processing Vertex Basis ..."), true /*Enabled*/);
+			ProgressBar.MakeDialog(false /*bShowCancelButton*/, false /*bAllowInPIE*/);
+
+			BasisInfo.NumBasis = FVATCompressionUtilities::ComputeBasis(VertexDeltas, VertexNormals,
+				NumKeyframes, NumVertices,
+				Model->Settings->MaxNumBasis, Model->Settings->BasisErrorTolerance,
+				DeltaBasis, NormalBasis, Coefficients, BasisInfo.Error);
+		}
+
+		if (!BasisInfo.NumBasis)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Unable to compute Vertex Basis."));
+			return false;
+		}
+
+		// Find Best Resolution for Basis Data. Mean is stored in the first block.
+		int32 Height, Width;
+		if (!FindBestResolution(BasisInfo.NumBasis + 1, NumVertices,
+								Height, Width, Model->VertexRowsPerFrame[LODIndex],
+								Model->Settings->MaxHeight, Model->Settings->MaxWidth, Model->Settings->bEnforcePowerOfTwo, Model->Settings->bMinimizePaddedTextureSize))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Vertex Basis data cannot be fit in a %ix%i texture."), Model->Settings->MaxHeight, Model->Settings->MaxWidth);
+			return false;
+		}
+
+		// Resolution for Coefficients. Four coefficients per texel, one row per frame.
+		// The shader addresses coefficients by (texel, frame), so frames never wrap into more rows.
+		const int32 NumCoefficientTexels = FMath::DivideAndRoundUp(BasisInfo.NumBasis, 4);
+		const int32 CoefficientRowsPerFrame = 1;
+		int32 CoefficientWidth = NumCoefficientTexels;
+		int32 CoefficientHeight = NumKeyframes;
+		if (Model->Settings->bEnforcePowerOfTwo)
+		{
+			CoefficientWidth = (int32)FMath::RoundUpToPowerOfTwo((uint32)CoefficientWidth);
+			CoefficientHeight = (int32)FMath::RoundUpToPowerOfTwo((uint32)CoefficientHeight);
+		}
+		if (CoefficientWidth > Model->Settings->MaxWidth || CoefficientHeight > Model->Settings->MaxHeight)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Vertex Coefficient data cannot be fit in a %ix%i texture."), Model->Settings->MaxHeight, Model->Settings->MaxWidth);
+			return false;
+		}
+		AddDeduplicatedBytes(CoefficientRowsPerFrame * CoefficientWidth, PrecisionBytesPerTexel);
+
+		// Reorder Basis Data
+		if (GetOptimizedVertexTexels(OptimizedIndices, MeshIndices, NumVertices, Width, Model->VertexRowsPerFrame[LODIndex], VertexTexels))
+		{
+			FVATVertexReorder::ScatterElements(DeltaBasis, NumVertices, VertexTexels);
+			FVATVertexReorder::ScatterElements(NormalBasis, NumVertices, VertexTexels);
+		}
+
+		// Normalize Basis Data. Each block (mean and basis) has its own range, so low energy basis keep their precision.
+		// Ranges are stored in a full precision table, one row per block: delta min, delta size, normal min, normal size.
+		const int32 NumBlocks = BasisInfo.NumBasis + 1;
+		const int32 RangeWidth = 4;
+		TArray<FVector4f> BasisRanges;
+		BasisRanges.SetNumZeroed(NumBlocks * RangeWidth);
+
+		TArray<FVector3f> NormalizedDeltaBasis;
+		TArray<FVector3f> NormalizedNormalBasis;
+		NormalizedDeltaBasis.Reserve(DeltaBasis.Num());
+		NormalizedNormalBasis.Reserve(NormalBasis.Num());
+		for (int32 Block = 0; Block < NumBlocks; Block++)
+		{
+			const TArray<FVector3f> BlockDeltas(DeltaBasis.GetData() + Block * NumVertices, NumVertices);
+			const TArray<FVector3f> BlockNormals(NormalBasis.GetData() + Block * NumVertices, NumVertices);
+
+			FVector3f MinBBox, SizeBBox, NormalMinBBox, NormalSizeBBox;
+			ComputeBoundingBox(BlockDeltas, MinBBox, SizeBBox);
+			ComputeBoundingBox(BlockNormals, NormalMinBBox, NormalSizeBBox);
+
+			TArray<FVector3f> NormalizedBlock;
+			NormalizeVectors(BlockDeltas, MinBBox, SizeBBox, NormalizedBlock);
+			NormalizedDeltaBasis.Append(NormalizedBlock);
+			NormalizeVectors(BlockNormals, NormalMinBBox, NormalSizeBBox, NormalizedBlock);
+			NormalizedNormalBasis.Append(NormalizedBlock);
+
+			BasisRanges[Block * RangeWidth + 0] = FVector4f(MinBBox, 0.f);
+			BasisRanges[Block * RangeWidth + 1] = FVector4f(SizeBBox, 0.f);
+			BasisRanges[Block * RangeWidth + 2] = FVector4f(NormalMinBBox, 0.f);
+			BasisRanges[Block * RangeWidth + 3] = FVector4f(NormalSizeBBox, 0.f);
+
+			if (Block == 0)
+			{
+				BasisInfo.MinBBox = MinBBox;
+				BasisInfo.SizeBBox = SizeBBox;
+				BasisInfo.NormalMinBBox = NormalMinBBox;
+				BasisInfo.NormalSizeBBox = NormalSizeBBox;
+			}
+		}
+
+		// Normalize and Pack Coefficients. Each coefficient column has its own range, stored next to its basis range.
+		TArray<FVector4f> NormalizedCoefficients;
+		NormalizedCoefficients.SetNumZeroed(NumKeyframes * NumCoefficientTexels);
+		for (int32 Basis = 0; Basis < BasisInfo.NumBasis; Basis++)
+		{
+			float CoefficientMin = TNumericLimits<float>::Max();
+			float CoefficientMax = TNumericLimits<float>::Lowest();
+			for (int32 Frame = 0; Frame < NumKeyframes; Frame++)
+			{
+				CoefficientMin = FMath::Min(CoefficientMin, Coefficients[Frame * BasisInfo.NumBasis + Basis]);
+				CoefficientMax = FMath::Max(CoefficientMax, Coefficients[Frame * BasisInfo.NumBasis + Basis]);
+			}
+			const float CoefficientSize = CoefficientMax - CoefficientMin;
+			const float CoefficientNormFactor = CoefficientSize > UE_SMALL_NUMBER ? 1.f / CoefficientSize : 0.f;
+
+			for (int32 Frame = 0; Frame < NumKeyframes; Frame++)
+			{
+				const float Coefficient = Coefficients[Frame * BasisInfo.NumBasis + Basis];
+				NormalizedCoefficients[Frame * NumCoefficientTexels + Basis / 4][Basis % 4] = (Coefficient - CoefficientMin) * CoefficientNormFactor;
+			}
+
+			BasisRanges[(Basis + 1) * RangeWidth + 0].W = CoefficientMin;
+			BasisRanges[(Basis + 1) * RangeWidth + 1].W = CoefficientSize;
+		}
+
+		// Resolution for Basis Ranges. One row per block, addressed directly by the shader.
+		const int32 RangeHeight = Model->Settings->bEnforcePowerOfTwo ? (int32)FMath::RoundUpToPowerOfTwo((uint32)NumBlocks) : NumBlocks;
+
+		// Write Textures
+		if (Model->Settings->Precision == EVATPrecision::SixteenBits)
+		{
+			FVATUtils::WriteVectorsToTexture<FVector3f, FHighPrecision>(NormalizedDeltaBasis, BasisInfo.NumBasis + 1, Model->VertexRowsPerFrame[LODIndex], Height, Width, Model->GetVertexBasisTexture(LODIndex));
+			FVATUtils::WriteVectorsToTexture<FVector3f, FHighPrecision>(NormalizedNormalBasis, BasisInfo.NumBasis + 1, Model->VertexRowsPerFrame[LODIndex], Height, Width, Model->GetVertexNormalBasisTexture(LODIndex));
+			FVATUtils::WriteVectorsToTexture<FVector4f, FHighPrecision>(NormalizedCoefficients, NumKeyframes, CoefficientRowsPerFrame, CoefficientHeight, CoefficientWidth, Model->GetVertexCoefficientTexture(LODIndex));
+		}
+		else
+		{
+			FVATUtils::WriteVectorsToTexture<FVector3f, FLowPrecision>(NormalizedDeltaBasis, BasisInfo.NumBasis + 1, Model->VertexRowsPerFrame[LODIndex], Height, Width, Model->GetVertexBasisTexture(LODIndex));
+			FVATUtils::WriteVectorsToTexture<FVector3f, FLowPrecision>(NormalizedNormalBasis, BasisInfo.NumBasis + 1, Model->VertexRowsPerFrame[LODIndex], Height, Width, Model->GetVertexNormalBasisTexture(LODIndex));
+			FVATUtils::WriteVectorsToTexture<FVector4f, FLowPrecision>(NormalizedCoefficients, NumKeyframes, CoefficientRowsPerFrame, CoefficientHeight, CoefficientWidth, Model->GetVertexCoefficientTexture(LODIndex));
+		}
+		FVATUtils::WriteVectorsToTexture<FVector4f, FFullPrecision>(BasisRanges, 1, NumBlocks, RangeHeight, RangeWidth, Model->GetVertexBasisRangeTexture(LODIndex));
+
+		UE_LOG(LogTemp, Log, TEXT("LOD: %d Num Basis: %d RMS Error: %f Texels: %d (Uncompressed: %d)"), LODIndex,
+			BasisInfo.NumBasis, BasisInfo.Error,
+			Height * Width + CoefficientHeight * CoefficientWidth + RangeHeight * RangeWidth,
+			Model->NumFrames * NumVertices);
+
+		// Add Vertex UVChannel
+		CreateUVChannel(Model->GetStaticMesh(), LODIndex, Model->UVChannel, Height, Width, VertexTexels);
+
+		// Update Bounds with the uncompressed deltas
+		ComputeBoundingBox(VertexDeltas, Model->VertexMinBBox, Model->VertexSizeBBox);
+		SetBoundsExtensions(Model->GetStaticMesh(), (FVector)Model->VertexMinBBox, (FVector)Model->VertexSizeBBox);
+
+		// Done with StaticMesh
+		Model->GetStaticMesh()->PostEditChange();
+	}
+
+	// ---------------------------------------------------------------------------
+	
+	if (Model->Mode == EVATModelMode::Bone || Model->Mode == EVATModelMode::SkinningDecomposition)
+	{
+		// Find Best Resolution for Bone Data
+		int32 Height, Width;
+
+		// Dual Quaternions are kept for validating the encoding against the skin weights
+		TArray<FQuat4f> BoneReals;
+		TArray<FQuat4f> BoneDuals;
+		TArray<FVector4f> NormalizedBoneReals;
+		TArray<FVector4f> NormalizedBoneDuals;
+
+		// Write Bone Matrix Texture
+		if (Model->Settings->BoneEncoding == EVATBoneEncoding::MatrixPalette)
+		{
+			// Three rows per bone. The RefPose is folded into the matrices
+			if (!FindBestResolution(NumKeyframes, Model->NumBones * 3,
+				Height, Width, Model->BoneRowsPerFrame[LODIndex],
+				Model->Settings->MaxHeight, Model->Settings->MaxWidth, Model->Settings->bEnforcePowerOfTwo, Model->Settings->bMinimizePaddedTextureSize))
+			{
+				UE_LOG(LogTemp, Warning, TEXT("Bone Matrix data cannot be fit in a %ix%i texture."), Model->Settings->MaxHeight, Model->Settings->MaxWidth);
+				return false;
+			}
+
+			TArray<FVector4f> NormalizedBoneMatrixRows;
+			NormalizeBoneMatrices(
+				BonePositions, BoneRotations, Model->NumBones,
+				Model->BoneMinBBox, Model->BoneSizeBBox,
+				NormalizedBoneMatrixRows);
+
+			// Rotation entries need 16 bits regardless of Precision
+			FVATUtils::WriteVectorsToTexture<FVector4f, FHighPrecision>(NormalizedBoneMatrixRows, NumKeyframes, Model->BoneRowsPerFrame[LODIndex], Height, Width, Model->GetBoneMatrixTexture());
+
+			// Update Bounds with the Bone Positions
+			FVector3f MinBBox, SizeBBox;
+			ComputeBoundingBox(BonePositions, MinBBox, SizeBBox);
+			SetBoundsExtensions(Model->GetStaticMesh(), (FVector)MinBBox, (FVector)SizeBBox);
+		}
+
+		// Write Bone Real and Dual Textures
+		else if (Model->Settings->BoneEncoding == EVATBoneEncoding::DualQuaternion)
+		{
+			// The RefPose is folded into the quaternions
+			if (!FindBestResolution(NumKeyframes, Model->NumBones,
+				Height, Width, Model->BoneRowsPerFrame[LODIndex],
+				Model->Settings->MaxHeight, Model->Settings->MaxWidth, Model->Settings->bEnforcePowerOfTwo, Model->Settings->bMinimizePaddedTextureSize))
+			{
+				UE_LOG(LogTemp, Warning, TEXT("Bone DualQuaternion data cannot be fit in a %ix%i texture."), Model->Settings->MaxHeight, Model->Settings->MaxWidth);
+				return false;
+			}
+
+			GetBoneDualQuaternions(BonePositions, BoneRotations, Model->NumBones, BoneReals, BoneDuals);
+			NormalizeBoneDualQuaternions(BoneReals, BoneDuals,
+				Model->BoneMinBBox, Model->BoneSizeBBox,
+				NormalizedBoneReals, NormalizedBoneDuals);
+
+			// Quaternion components need 16 bits regardless of Precision
+			FVATUtils::WriteVectorsToTexture<FVector4f, FHighPrecision>(NormalizedBoneReals, NumKeyframes, Model->BoneRowsPerFrame[LODIndex], Height, Width, Model->GetBoneRealTexture());
+			FVATUtils::WriteVectorsToTexture<FVector4f, FHighPrecision>(NormalizedBoneDuals, NumKeyframes, Model->BoneRowsPerFrame[LODIndex], Height, Width, Model->GetBoneDualTexture());
+
+			// Update Bounds with the Bone Positions
+			FVector3f MinBBox, SizeBBox;
+			ComputeBoundingBox(BonePositions, MinBBox, SizeBBox);
+			SetBoundsExtensions(Model->GetStaticMesh(), (FVector)MinBBox, (FVector)SizeBBox);
+		}
+
+		// Write Bone Position and Rotation Textures
+		else
+		{
+			// Note we are adding +1 frame for the ref pose
+			TArray<FIntPoint> FramePages;
+			if (Model->Settings->UsesPagedTextures())
+			{
+				// RefPose is copied to the start of every page, so it belongs to no animation
+				TArray<int32> BoneFrameGroups;
+				BoneFrameGroups.Add(INDEX_NONE);
+				BoneFrameGroups.Append(FrameGroups);
+
+				if (!FindBestPagedResolution(NumKeyframes + 1, Model->NumBones, bPagePerAnimation ? BoneFrameGroups : TArray<int32>(), 1,
+					Height, Width, Model->BoneRowsPerFrame[LODIndex], FramePages, Model->NumPages[LODIndex],
+					Model->Settings->MaxHeight, Model->Settings->MaxWidth, Model->Settings->bEnforcePowerOfTwo, Model->Settings->bMinimizePaddedTextureSize))
+				{
+					UE_LOG(LogTemp, Warning, TEXT("Bone Animation data cannot be paged in %ix%i textures."), Model->Settings->MaxHeight, Model->Settings->MaxWidth);
+					return false;
+				}
+
+				if (LODIndex == 0)
+				{
+					SetAnimationPages(Model, BoneFrameGroups, FramePages);
+				}
+			}
+			else if (!FindBestResolution(NumKeyframes + 1, Model->NumBones,
+				Height, Width, Model->BoneRowsPerFrame[LODIndex],
+				Model->Settings->MaxHeight, Model->Settings->MaxWidth, Model->Settings->bEnforcePowerOfTwo, Model->Settings->bMinimizePaddedTextureSize))
+			{
+				UE_LOG(LogTemp, Warning, TEXT("Bone Animation data cannot be fit in a %ix%i texture."), Model->Settings->MaxHeight, Model->Settings->MaxWidth);
+				return false;
+			}
+
+			// Position and Rotation textures are shared by all LODs
+			if (LODIndex == 0)
+			{
+				AddDeduplicatedBytes(Model->BoneRowsPerFrame[LODIndex] * Width * 2, PrecisionBytesPerTexel);
+			}
+
+			// Normalize Bone Data
+			TArray<FVector3f> NormalizedBonePositions;
+			TArray<FVector4f> NormalizedBoneRotations;
+			NormalizeBoneData(
+				BonePositions, BoneRotations,
+				Model->BoneMinBBox, Model->BoneSizeBBox,
+				NormalizedBonePositions, NormalizedBoneRotations);
+
+
+			// Write Textures
+			if (Model->Settings->UsesPagedTextures())
+			{
+				const int32 NumPages = Model->NumPages[LODIndex];
+
+				// Every page starts with a copy of the RefPose, so pages don't depend on each other
+				TArray<FIntPoint> RefPoseFramePages = FramePages;
+				const TArray<FVector3f> RefPosePositions(NormalizedBonePositions.GetData(), Model->NumBones);
+				const TArray<FVector4f> RefPoseRotations(NormalizedBoneRotations.GetData(), Model->NumBones);
+				for (int32 Page = 1; Page < NumPages; Page++)
+				{
+					RefPoseFramePages.Add(FIntPoint(Page, 0));
+					NormalizedBonePositions.Append(RefPosePositions);
+					NormalizedBoneRotations.Append(RefPoseRotations);
+				}
+
+				const int32 NumPageFrames = NumKeyframes + NumPages;
+				if (Model->Settings->Precision == EVATPrecision::SixteenBits)
+				{
+					FVATUtils::WriteVectorsToTextureArray<FVector3f, FHighPrecision>(NormalizedBonePositions, NumPageFrames, Model->BoneRowsPerFrame[LODIndex], Height, Width, RefPoseFramePages, NumPages, Model->GetBonePositionPageTexture());
+					FVATUtils::WriteVectorsToTextureArray<FVector4f, FHighPrecision>(NormalizedBoneRotations, NumPageFrames, Model->BoneRowsPerFrame[LODIndex], Height, Width, RefPoseFramePages, NumPages, Model->GetBoneRotationPageTexture());
+				}
+				else
+				{
+					FVATUtils::WriteVectorsToTextureArray<FVector3f, FLowPrecision>(NormalizedBonePositions, NumPageFrames, Model->BoneRowsPerFrame[LODIndex], Height, Width, RefPoseFramePages, NumPages, Model->GetBonePositionPageTexture());
+					FVATUtils::WriteVectorsToTextureArray<FVector4f, FLowPrecision>(NormalizedBoneRotations, NumPageFrames, Model->BoneRowsPerFrame[LODIndex], Height, Width, RefPoseFramePages, NumPages, Model->GetBoneRotationPageTexture());
+				}
+
+				if (!WritePageTable(Model, LODIndex, FramePages))
+				{
+					return false;
+				}
+			}
+			// Up to date Animation Libraries already store the same Bone data
+			else if (AnimationLibrary && AnimationLibrary->BakeKey == AnimationLibraryKey)
+			{
+				UE_LOG(LogTemp, Log, TEXT("LOD: %d Reusing Bone textures of Animation Library: %s"), LODIndex, *AnimationLibrary->GetName());
+			}
+			else if (Model->Settings->Precision == EVATPrecision::SixteenBits)
+			{
+				FVATUtils::WriteVectorsToTexture<FVector3f, FHighPrecision>(NormalizedBonePositions, NumKeyframes + 1, Model->BoneRowsPerFrame[LODIndex], Height, Width, Model->GetBonePositionTexture());
+				FVATUtils::WriteVectorsToTexture<FVector4f, FHighPrecision>(NormalizedBoneRotations, NumKeyframes + 1, Model->BoneRowsPerFrame[LODIndex], Height, Width, Model->GetBoneRotationTexture());
+			}
+			else
+			{
+				FVATUtils::WriteVectorsToTexture<FVector3f, FLowPrecision>(NormalizedBonePositions, NumKeyframes + 1, Model->BoneRowsPerFrame[LODIndex], Height, Width, Model->GetBonePositionTexture());
+				FVATUtils::WriteVectorsToTexture<FVector4f, FLowPrecision>(NormalizedBoneRotations, NumKeyframes + 1, Model->BoneRowsPerFrame[LODIndex], Height, Width, Model->GetBoneRotationTexture());
+			}
+
+			// Stamp the Animation Library. CheckDataAsset only lets unbaked libraries get here with another key
+			if (AnimationLibrary && AnimationLibrary->BakeKey != AnimationLibraryKey)
+			{
+				AnimationLibrary->BakeKey = AnimationLibraryKey;
+				AnimationLibrary->BakedBy = Model->GetName();
+				AnimationLibrary->NumFrames = Model->NumFrames;
+				AnimationLibrary->NumBones = Model->NumBones;
+				AnimationLibrary->MarkPackageDirty();
+			}
+
+			// Update Bounds
+			SetBoundsExtensions(Model->GetStaticMesh(), (FVector)Model->BoneMinBBox, (FVector)Model->BoneSizeBBox);
+		}
+
+		// ---------------------------------------------------------------------------
+		
+		// Write Weights Texture
+		{
+			// Find Best Resolution for Bone Weights Texture. Integer indices are stored in their own texture.
+			// Skin Weights stored in UVChannels and Rigid Binding don't need a texture.
+			const bool bIntegerBoneIndices = Model->Settings->bIntegerBoneIndices;
+			const bool bSkinWeightsInUVs = Model->Settings->bSkinWeightsInUVs;
+			const bool bWeightsTexture = !bSkinWeightsInUVs && SocketIndex == INDEX_NONE;
+			if (bWeightsTexture && !FindBestResolution(bIntegerBoneIndices ? 1 : 2, NumVertices,
+				Height, Width, Model->BoneWeightRowsPerFrame[LODIndex],
+				Model->Settings->MaxHeight, Model->Settings->MaxWidth, Model->Settings->bEnforcePowerOfTwo, Model->Settings->bMinimizePaddedTextureSize))
+			{
+				UE_LOG(LogTemp, Warning, TEXT("Weights Data cannot be fit in a %ix%i texture."), Model->Settings->MaxHeight, Model->Settings->MaxWidth);
+				return false;
+			}
+
+			TArray<TVertexSkinWeight<4>> SkinWeights;
+
+			// Fitted Weights
+			if (Model->Mode == EVATModelMode::SkinningDecomposition)
+			{
+				SkinWeights = DecompositionSkinWeights;
+			}
+			// Reduce BoneWeights to 4 Influences.
+			else if (SocketIndex == INDEX_NONE)
+			{
+				// Project SkinWeights from SkeletalMesh to StaticMesh
+				TArray<VertexSkinWeightMax> StaticMeshSkinWeights;
+				Mapping.ProjectSkinWeights(StaticMeshSkinWeights);
+
+				// Reduce Weights to 4 highest influences.
+				FVATSkeletalMeshUtilities::ReduceSkinWeights(StaticMeshSkinWeights, SkinWeights);
+			}
+			// If Valid Socket, all vertices follow the socket with a single influence.
+			else
+			{
+				SkinWeights.SetNumUninitialized(NumVertices);
+				for (TVertexSkinWeight<4>& SkinWeight : SkinWeights)
+				{
+					SkinWeight.BoneWeights = TStaticArray<uint8, 4>(InPlace, 0);
+					SkinWeight.MeshBoneIndices = TStaticArray<uint16, 4>(InPlace, SocketIndex);
+					SkinWeight.BoneWeights[0] = 255;
+				}
+			}
+
+			// Remap Skeleton bone indices to the baked bones
+			if (Model->BoneMap.Num())
+			{
+				TArray<int32> SkeletonToBone;
+				SkeletonToBone.Init(INDEX_NONE, FVATSkeletalMeshUtilities::GetNumBones(Model->GetSkeletalMesh()));
+				for (int32 BoneIndex = 0; BoneIndex < Model->BoneMap.Num(); ++BoneIndex)
+				{
+					SkeletonToBone[Model->BoneMap[BoneIndex]] = BoneIndex;
+				}
+
+				for (VertexSkinWeightFour& SkinWeight : SkinWeights)
+				{
+					for (int32 Index = 0; Index < 4; ++Index)
+					{
+						SkinWeight.MeshBoneIndices[Index] = FMath::Max(SkeletonToBone[SkinWeight.MeshBoneIndices[Index]], 0);
+					}
+				}
+			}
+
+			// Collapse the less important bones of following LODs. Bones under the threshold are a suffix of the baked bones
+			if (Model->Mode == EVATModelMode::Bone && Model->Settings->bReduceBoneLODs)
+			{
+				const float Threshold = LODIndex > 0 ? Model->Settings->BoneLODImportanceThreshold * (float)(1 << (LODIndex - 1)) : 0.f;
+
+				int32 NumLODBones = 1;
+				while (NumLODBones < BoneImportances.Num() && BoneImportances[NumLODBones] >= Threshold)
+				{
+					NumLODBones++;
+				}
+
+				if (NumLODBones < Model->NumBones)
+				{
+					CollapseSkinWeights(Model, NumLODBones, SkinWeights);
+				}
+
+				Model->NumLODBones[LODIndex] = NumLODBones;
+				UE_LOG(LogTemp, Log, TEXT("LOD: %d Skinned Bones: %d / %d"), LODIndex, NumLODBones, Model->NumBones);
+			}
+
+			// Prune light influences. Weights are always sorted, so skinning stops at the first empty influence
+			{
+				int32 MaxNumInfluences = 0;
+				const float AverageNumInfluences = FVATSkeletalMeshUtilities::GetAverageNumInfluences(SkinWeights, MaxNumInfluences);
+
+				FVATSkeletalMeshUtilities::PruneSkinWeights(SkinWeights, Model->Settings->bPruneInfluences ? Model->Settings->InfluencePruningThreshold : 0.f);
+
+				const float PrunedAverageNumInfluences = FVATSkeletalMeshUtilities::GetAverageNumInfluences(SkinWeights, MaxNumInfluences);
+				Model->MaxNumInfluences[LODIndex] = MaxNumInfluences;
+				UE_LOG(LogTemp, Log, TEXT("LOD: %d Average Influences: %.2f -> %.2f (Max %d)"), LODIndex, AverageNumInfluences, PrunedAverageNumInfluences, MaxNumInfluences);
+			}
+
+			UE_LOG(LogTemp, Log, TEXT("SkinWeightsNum: %d"), SkinWeights.Num());
+
+			// Validate the Dual Quaternion textures with the CPU reference
+			if (Model->Settings->BoneEncoding == EVATBoneEncoding::DualQuaternion)
+			{
+				LogDualQuaternionError(Model->GetStaticMesh(), LODIndex, SkinWeights, Model->NumBones,
+					BoneReals, BoneDuals, NormalizedBoneReals, NormalizedBoneDuals,
+					Model->BoneMinBBox, Model->BoneSizeBBox);
+			}
+
+			// Sections following a single bone store it in the UVChannel
+			TArray<int32> SectionBones;
+			if (Model->Settings->UsesRigidSections())
+			{
+				const int32 NumRigidSections = GetRigidSectionBones(Model->GetStaticMesh(), LODIndex, SkinWeights, SectionBones);
+				UE_LOG(LogTemp, Log, TEXT("LOD: %d Rigid Sections: %d / %d"), LODIndex, NumRigidSections, SectionBones.Num());
+			}
+
+			// Vertex Sections. Vertices of sections baked in Vertex Mode store their deltas and normals in the Vertex textures,
+			// and (-U, V) in the UVChannel. Their skin weights are kept but never read
+			TMap<int32, FVector2D> SectionVertexUVs;
+			if (Model->Mode == EVATModelMode::Bone && Model->Settings->UsesVertexSections())
+			{
+				TArray<int32> SectionVertices;
+				GetSectionVertices(Model->GetStaticMesh(), LODIndex, Model->Settings->VertexSections, SectionVertices);
+				const int32 NumSectionVertices = SectionVertices.Num();
+				Model->NumVertexSectionVertices[LODIndex] = NumSectionVertices;
+
+				UE_LOG(LogTemp, Log, TEXT("LOD: %d Vertex Section Vertices: %d / %d"), LODIndex, NumSectionVertices, NumVertices);
+
+				// Vertex Sections are never rigid
+				for (const int32 Section : Model->Settings->VertexSections)
+				{
+					if (SectionBones.IsValidIndex(Section))
+					{
+						SectionBones[Section] = INDEX_NONE;
+					}
+				}
+
+				if (NumSectionVertices)
+				{
+					TArray<FVector3f> SectionDeltas = GatherFrameElements(VertexDeltas, NumVertices, SectionVertices);
+					TArray<FVector3f> SectionNormals = GatherFrameElements(VertexNormals, NumVertices, SectionVertices);
+
+					int32 VertexHeight, VertexWidth;
+					if (!FindBestResolution(NumKeyframes, NumSectionVertices,
+						VertexHeight, VertexWidth, Model->VertexRowsPerFrame[LODIndex],
+						Model->Settings->MaxHeight, Model->Settings->MaxWidth, Model->Settings->bEnforcePowerOfTwo, Model->Settings->bMinimizePaddedTextureSize))
+					{
+						UE_LOG(LogTemp, Warning, TEXT("Vertex Section data cannot be fit in a %ix%i texture."), Model->Settings->MaxHeight, Model->Settings->MaxWidth);
+						return false;
+					}
+					AddDeduplicatedBytes(Model->VertexRowsPerFrame[LODIndex] * VertexWidth * 2, PrecisionBytesPerTexel);
+
+					// Reorder Vertex Section Data
+					TArray<int32> SectionTexels;
+					if (GetOptimizedVertexTexels(GatherIndices(OptimizedIndices, SectionVertices, NumVertices),
+						GatherIndices(MeshIndices, SectionVertices, NumVertices), NumSectionVertices,
+						VertexWidth, Model->VertexRowsPerFrame[LODIndex], SectionTexels))
+					{
+						FVATVertexReorder::ScatterElements(SectionDeltas, NumSectionVertices, SectionTexels);
+						FVATVertexReorder::ScatterElements(SectionNormals, NumSectionVertices, SectionTexels);
+					}
+
+					TArray<FVector3f> NormalizedSectionDeltas;
+					TArray<FVector3f> NormalizedSectionNormals;
+					NormalizeVertexData(SectionDeltas, SectionNormals,
+						Model->VertexMinBBox, Model->VertexSizeBBox,
+						NormalizedSectionDeltas, NormalizedSectionNormals);
+
+					if (Model->Settings->Precision == EVATPrecision::SixteenBits)
+					{
+						FVATUtils::WriteVectorsToTexture<FVector3f, FHighPrecision>(NormalizedSectionDeltas, NumKeyframes, Model->VertexRowsPerFrame[LODIndex], VertexHeight, VertexWidth, Model->GetVertexPositionTexture(LODIndex));
+						FVATUtils::WriteVectorsToTexture<FVector3f, FHighPrecision>(NormalizedSectionNormals, NumKeyframes, Model->VertexRowsPerFrame[LODIndex], VertexHeight, VertexWidth, Model->GetVertexNormalTexture(LODIndex));
+					}
+					else
+					{
+						FVATUtils::WriteVectorsToTexture<FVector3f, FLowPrecision>(NormalizedSectionDeltas, NumKeyframes, Model->VertexRowsPerFrame[LODIndex], VertexHeight, VertexWidth, Model->GetVertexPositionTexture(LODIndex));
+						FVATUtils::WriteVectorsToTexture<FVector3f, FLowPrecision>(NormalizedSectionNormals, NumKeyframes, Model->VertexRowsPerFrame[LODIndex], VertexHeight, VertexWidth, Model->GetVertexNormalTexture(LODIndex));
+					}
+
+					for (int32 Element = 0; Element < NumSectionVertices; Element++)
+					{
+						const int32 Texel = SectionTexels.Num() ? SectionTexels[Element] : Element;
+						const float U = (0.5f + (float)(Texel % VertexWidth)) / (float)VertexWidth;
+						const float V = (0.5f + (float)(Texel / VertexWidth)) / (float)VertexHeight;
+						SectionVertexUVs.Add(SectionVertices[Element], FVector2D(-U, V));
+					}
+				}
+			}
+
+			// Hybrid Bone Mode. Residuals of the vertices over the threshold are stored in a sparse texture,
+			// the ResidualIndex texture stores the residual slot (+ 1) of each vertex.
+			// Slots are split in two 16bit float channels (X + Y * 2048), which are exact up to 2048 each
+			TArray<FVector4f> ResidualIndices;
+			if (Model->Mode == EVATModelMode::Bone && Model->Settings->bBakeResiduals)
+			{
+				TArray<FVector3f> RestVertices;
+				Mapping.GetSourceVertices(RestVertices);
+
+				TArray<FVector3f> Residuals;
+				TArray<float> MaxResiduals;
+				GetBoneResiduals(RestVertices, VertexDeltas, SkinWeights, BonePositions, BoneRotations, BoneReals, BoneDuals,
+					Model->NumBones, NumKeyframes, Residuals, MaxResiduals);
+
+				TArray<int32> ResidualVertices;
+				ResidualIndices.Init(FVector4f::Zero(), NumVertices);
+				for (int32 VertexIndex = 0; VertexIndex < NumVertices; VertexIndex++)
+				{
+					if (MaxResiduals[VertexIndex] > Model->Settings->ResidualThreshold)
+					{
+						ResidualVertices.Add(VertexIndex);
+						const int32 SlotIndex = ResidualVertices.Num();
+						ResidualIndices[VertexIndex].X = (float)(SlotIndex % 2048);
+						ResidualIndices[VertexIndex].Y = (float)(SlotIndex / 2048);
+					}
+				}
+				const int32 NumResidualVertices = ResidualVertices.Num();
+				Model->NumResidualVertices[LODIndex] = NumResidualVertices;
+
+				UE_LOG(LogTemp, Log, TEXT("LOD: %d Residual Vertices: %d / %d (%.1f%%)"), LODIndex, NumResidualVertices, NumVertices,
+					100.f * (float)NumResidualVertices / (float)NumVertices);
+
+				// Residuals per stored frame. A single empty slot is kept when no vertex is over the threshold
+				TArray<FVector3f> SparseResiduals;
+				SparseResiduals.Init(FVector3f::ZeroVector, NumKeyframes * FMath::Max(NumResidualVertices, 1));
+				for (int32 Frame = 0; Frame < NumKeyframes; Frame++)
+				{
+					for (int32 Slot = 0; Slot < NumResidualVertices; Slot++)
+					{
+						SparseResiduals[Frame * NumResidualVertices + Slot] = Residuals[Frame * NumVertices + ResidualVertices[Slot]];
+					}
+				}
+
+				int32 ResidualHeight, ResidualWidth;
+				if (!FindBestResolution(NumKeyframes, FMath::Max(NumResidualVertices, 1),
+					ResidualHeight, ResidualWidth, Model->ResidualRowsPerFrame[LODIndex],
+					Model->Settings->MaxHeight, Model->Settings->MaxWidth, Model->Settings->bEnforcePowerOfTwo, Model->Settings->bMinimizePaddedTextureSize))
+				{
+					UE_LOG(LogTemp, Warning, TEXT("Residual data cannot be fit in a %ix%i texture."), Model->Settings->MaxHeight, Model->Settings->MaxWidth);
+					return false;
+				}
+				AddDeduplicatedBytes(Model->ResidualRowsPerFrame[LODIndex] * ResidualWidth, 4);
+
+				TArray<FVector3f> NormalizedResiduals;
+				ComputeBoundingBox(SparseResiduals, Model->ResidualMinBBox[LODIndex], Model->ResidualSizeBBox[LODIndex]);
+				NormalizeVectors(SparseResiduals, Model->ResidualMinBBox[LODIndex], Model->ResidualSizeBBox[LODIndex], NormalizedResiduals);
+
+				FVATUtils::WriteVectorsToTexture<FVector3f, FLowPrecision>(NormalizedResiduals, NumKeyframes, Model->ResidualRowsPerFrame[LODIndex],
+					ResidualHeight, ResidualWidth, Model->GetResidualTexture(LODIndex));
+			}
+
+			// Write Skin Weights to UVChannels
+			if (bSkinWeightsInUVs)
+			{
+				if (!CreateSkinWeightUVChannels(Model->GetStaticMesh(), LODIndex, Model->UVChannel, SkinWeights))
+				{
+					return false;
+				}
+			}
+			// Rigid Binding is a bone transform table, every section follows the socket
+			else if (!bWeightsTexture)
+			{
+				CreateUVChannel(Model->GetStaticMesh(), LODIndex, Model->UVChannel, 1, 1, TArray<int32>(), SectionBones);
+			}
+			else
+			{
+				// Reorder Weights
+				if (GetOptimizedVertexTexels(OptimizedIndices, MeshIndices, NumVertices, Width, Model->BoneWeightRowsPerFrame[LODIndex], VertexTexels))
+				{
+					FVATVertexReorder::ScatterElements(SkinWeights, NumVertices, VertexTexels);
+					if (ResidualIndices.Num())
+					{
+						FVATVertexReorder::ScatterElements(ResidualIndices, NumVertices, VertexTexels);
+					}
+				}
+
+				// Write Residual Index Texture. Same texels as the first block of the Bone Weights Texture
+				if (ResidualIndices.Num())
+				{
+					FVATUtils::WriteVectorsToTexture<FVector4f, FIndexPrecision>(ResidualIndices, 1, Model->BoneWeightRowsPerFrame[LODIndex],
+						Model->BoneWeightRowsPerFrame[LODIndex], Width, Model->GetResidualIndexTexture(LODIndex));
+				}
+
+				// Write Bone Weights Texture
+				if (Model->Settings->Precision == EVATPrecision::SixteenBits)
+				{
+					FVATUtils::WriteSkinWeightsToTexture<FHighPrecision>(SkinWeights, Model->NumBones,
+						Model->BoneWeightRowsPerFrame[LODIndex], Height, Width, Model->GetBoneWeightTexture(LODIndex), !bIntegerBoneIndices);
+				}
+				else
+				{
+					FVATUtils::WriteSkinWeightsToTexture<FLowPrecision>(SkinWeights, Model->NumBones,
+						Model->BoneWeightRowsPerFrame[LODIndex], Height, Width, Model->GetBoneWeightTexture(LODIndex), !bIntegerBoneIndices);
+				}
+
+				// Write Bone Indices Texture
+				if (bIntegerBoneIndices)
+				{
+					FVATUtils::WriteBoneIndicesToTexture(SkinWeights, Height, Width, Model->GetBoneIndexTexture(LODIndex));
+				}
+
+				// Add Vertex UVChannel
+				CreateUVChannel(Model->GetStaticMesh(), LODIndex, Model->UVChannel, Height, Width, VertexTexels, SectionBones, SectionVertexUVs);
+			}
+		}
+
+		// Done with StaticMesh
+		Model->GetStaticMesh()->PostEditChange();
+	}
+
+	// ---------------------------------------------------------------------------
+	// Mark Packages dirty
 	//
 	Model->MarkPackageDirty();
 	
@@ -856,10 +2047,30 @@ void FVATModelEditorToolkit::UpdateMaterialInstanceFromDataAsset(const UVATModel
 		UMaterialEditingLibrary::SetMaterialInstanceScalarParameterValue(MaterialInstance, VATParamNames::RowsPerFrame, Model->VertexRowsPerFrame[LODIndex], MaterialParameterAssociation);
 		UMaterialEditingLibrary::SetMaterialInstanceTextureParameterValue(MaterialInstance, VATParamNames::VertexPositionTexture, Model->GetVertexPositionTexture(LODIndex), MaterialParameterAssociation);
 		UMaterialEditingLibrary::SetMaterialInstanceTextureParameterValue(MaterialInstance, VATParamNames::VertexNormalTexture, Model->GetVertexNormalTexture(LODIndex), MaterialParameterAssociation);
+
+		if (Model->Settings->UsesPagedTextures())
+		{
+			UMaterialEditingLibrary::SetMaterialInstanceTextureParameterValue(MaterialInstance, VATParamNames::VertexPositionTexture, Model->GetVertexPositionPageTexture(LODIndex), MaterialParameterAssociation);
+			UMaterialEditingLibrary::SetMaterialInstanceTextureParameterValue(MaterialInstance, VATParamNames::VertexNormalTexture, Model->GetVertexNormalPageTexture(LODIndex), MaterialParameterAssociation);
+		}
+	}
+
+	// Update CompressedVertex Params
+	else if (Model->Mode == EVATModelMode::CompressedVertex)
+	{
+		const FVATBasisInfo& BasisInfo = Model->BasisInfos[LODIndex];
+		UMaterialEditingLibrary::SetMaterialInstanceScalarParameterValue(MaterialInstance, VATParamNames::NumBasis, BasisInfo.NumBasis, MaterialParameterAssociation);
+		UMaterialEditingLibrary::SetMaterialInstanceVectorParameterValue(MaterialInstance, VATParamNames::MinBBox, FLinearColor(BasisInfo.MinBBox), MaterialParameterAssociation);
+		UMaterialEditingLibrary::SetMaterialInstanceVectorParameterValue(MaterialInstance, VATParamNames::SizeBBox, FLinearColor(BasisInfo.SizeBBox), MaterialParameterAssociation);
+		UMaterialEditingLibrary::SetMaterialInstanceScalarParameterValue(MaterialInstance, VATParamNames::RowsPerFrame, Model->VertexRowsPerFrame[LODIndex], MaterialParameterAssociation);
+		UMaterialEditingLibrary::SetMaterialInstanceTextureParameterValue(MaterialInstance, VATParamNames::BasisTexture, Model->GetVertexBasisTexture(LODIndex), MaterialParameterAssociation);
+		UMaterialEditingLibrary::SetMaterialInstanceTextureParameterValue(MaterialInstance, VATParamNames::NormalBasisTexture, Model->GetVertexNormalBasisTexture(LODIndex), MaterialParameterAssociation);
+		UMaterialEditingLibrary::SetMaterialInstanceTextureParameterValue(MaterialInstance, VATParamNames::CoefficientTexture, Model->GetVertexCoefficientTexture(LODIndex), MaterialParameterAssociation);
+		UMaterialEditingLibrary::SetMaterialInstanceTextureParameterValue(MaterialInstance, VATParamNames::BasisRangeTexture, Model->GetVertexBasisRangeTexture(LODIndex), MaterialParameterAssociation);
 	}
 
 	// Update Bone Params
-	else if (Model->Mode == EVATModelMode::Bone)
+	else if (Model->Mode == EVATModelMode::Bone || Model->Mode == EVATModelMode::SkinningDecomposition)
 	{
 		UMaterialEditingLibrary::SetMaterialInstanceScalarParameterValue(MaterialInstance, VATParamNames::NumBones, Model->NumBones, MaterialParameterAssociation);
 		UMaterialEditingLibrary::SetMaterialInstanceVectorParameterValue(MaterialInstance, VATParamNames::MinBBox, FLinearColor(Model->BoneMinBBox), MaterialParameterAssociation);
@@ -868,10 +2079,61 @@ void FVATModelEditorToolkit::UpdateMaterialInstanceFromDataAsset(const UVATModel
 		UMaterialEditingLibrary::SetMaterialInstanceScalarParameterValue(MaterialInstance, VATParamNames::BoneWeightRowsPerFrame, Model->BoneWeightRowsPerFrame[LODIndex], MaterialParameterAssociation);
 		UMaterialEditingLibrary::SetMaterialInstanceTextureParameterValue(MaterialInstance, VATParamNames::BonePositionTexture, Model->GetBonePositionTexture(), MaterialParameterAssociation);
 		UMaterialEditingLibrary::SetMaterialInstanceTextureParameterValue(MaterialInstance, VATParamNames::BoneRotationTexture, Model->GetBoneRotationTexture(), MaterialParameterAssociation);
-		UMaterialEditingLibrary::SetMaterialInstanceTextureParameterValue(MaterialInstance, VATParamNames::BoneWeightsTexture, Model->GetBoneWeightTexture(LODIndex), MaterialParameterAssociation);
+		const bool bWeightsTexture = !Model->Settings->bSkinWeightsInUVs && !Model->Settings->UsesSocketBinding();
+		if (bWeightsTexture)
+		{
+			UMaterialEditingLibrary::SetMaterialInstanceTextureParameterValue(MaterialInstance, VATParamNames::BoneWeightsTexture, Model->GetBoneWeightTexture(LODIndex), MaterialParameterAssociation);
+		}
 
-		// Num Influences
-		switch (Model->Settings->NumBoneInfluences)
+		if (Model->Settings->bIntegerBoneIndices && bWeightsTexture)
+		{
+			UMaterialEditingLibrary::SetMaterialInstanceTextureParameterValue(MaterialInstance, VATParamNames::BoneIndicesTexture, Model->GetBoneIndexTexture(LODIndex), MaterialParameterAssociation);
+		}
+
+		if (Model->Settings->BoneEncoding == EVATBoneEncoding::MatrixPalette)
+		{
+			UMaterialEditingLibrary::SetMaterialInstanceTextureParameterValue(MaterialInstance, VATParamNames::BoneMatrixTexture, Model->GetBoneMatrixTexture(), MaterialParameterAssociation);
+		}
+		else if (Model->Settings->BoneEncoding == EVATBoneEncoding::DualQuaternion)
+		{
+			UMaterialEditingLibrary::SetMaterialInstanceTextureParameterValue(MaterialInstance, VATParamNames::BoneRealTexture, Model->GetBoneRealTexture(), MaterialParameterAssociation);
+			UMaterialEditingLibrary::SetMaterialInstanceTextureParameterValue(MaterialInstance, VATParamNames::BoneDualTexture, Model->GetBoneDualTexture(), MaterialParameterAssociation);
+		}
+
+		if (Model->Settings->bBakeResiduals && Model->Mode == EVATModelMode::Bone)
+		{
+			UMaterialEditingLibrary::SetMaterialInstanceTextureParameterValue(MaterialInstance, VATParamNames::ResidualTexture, Model->GetResidualTexture(LODIndex), MaterialParameterAssociation);
+			UMaterialEditingLibrary::SetMaterialInstanceTextureParameterValue(MaterialInstance, VATParamNames::ResidualIndexTexture, Model->GetResidualIndexTexture(LODIndex), MaterialParameterAssociation);
+			UMaterialEditingLibrary::SetMaterialInstanceVectorParameterValue(MaterialInstance, VATParamNames::ResidualMinBBox, FLinearColor(Model->ResidualMinBBox[LODIndex]), MaterialParameterAssociation);
+			UMaterialEditingLibrary::SetMaterialInstanceVectorParameterValue(MaterialInstance, VATParamNames::ResidualSizeBBox, FLinearColor(Model->ResidualSizeBBox[LODIndex]), MaterialParameterAssociation);
+			UMaterialEditingLibrary::SetMaterialInstanceScalarParameterValue(MaterialInstance, VATParamNames::ResidualRowsPerFrame, Model->ResidualRowsPerFrame[LODIndex], MaterialParameterAssociation);
+		}
+
+		if (Model->Settings->UsesVertexSections() && Model->Mode == EVATModelMode::Bone)
+		{
+			UMaterialEditingLibrary::SetMaterialInstanceTextureParameterValue(MaterialInstance, VATParamNames::VertexPositionTexture, Model->GetVertexPositionTexture(LODIndex), MaterialParameterAssociation);
+			UMaterialEditingLibrary::SetMaterialInstanceTextureParameterValue(MaterialInstance, VATParamNames::VertexNormalTexture, Model->GetVertexNormalTexture(LODIndex), MaterialParameterAssociation);
+			UMaterialEditingLibrary::SetMaterialInstanceVectorParameterValue(MaterialInstance, VATParamNames::VertexMinBBox, FLinearColor(Model->VertexMinBBox), MaterialParameterAssociation);
+			UMaterialEditingLibrary::SetMaterialInstanceVectorParameterValue(MaterialInstance, VATParamNames::VertexSizeBBox, FLinearColor(Model->VertexSizeBBox), MaterialParameterAssociation);
+			UMaterialEditingLibrary::SetMaterialInstanceScalarParameterValue(MaterialInstance, VATParamNames::VertexRowsPerFrame, Model->VertexRowsPerFrame[LODIndex], MaterialParameterAssociation);
+		}
+
+		if (Model->Settings->UsesPagedTextures())
+		{
+			UMaterialEditingLibrary::SetMaterialInstanceTextureParameterValue(MaterialInstance, VATParamNames::BonePositionTexture, Model->GetBonePositionPageTexture(), MaterialParameterAssociation);
+			UMaterialEditingLibrary::SetMaterialInstanceTextureParameterValue(MaterialInstance, VATParamNames::BoneRotationTexture, Model->GetBoneRotationPageTexture(), MaterialParameterAssociation);
+		}
+
+		// Num Influences. Pruned LODs only enable the influences they use
+		EVATNumBoneInfluences NumBoneInfluences = Model->Settings->NumBoneInfluences;
+		if (Model->Settings->bPruneInfluences && Model->MaxNumInfluences.IsValidIndex(LODIndex))
+		{
+			const EVATNumBoneInfluences NeededInfluences = Model->MaxNumInfluences[LODIndex] <= 1 ? EVATNumBoneInfluences::One
+				: Model->MaxNumInfluences[LODIndex] == 2 ? EVATNumBoneInfluences::Two : EVATNumBoneInfluences::Four;
+			NumBoneInfluences = FMath::Min(NumBoneInfluences, NeededInfluences);
+		}
+
+		switch (NumBoneInfluences)
 		{
 			case EVATNumBoneInfluences::One:
 				UMaterialEditingLibrary::SetMaterialInstanceStaticSwitchParameterValue(MaterialInstance, VATParamNames::UseTwoInfluences, false, MaterialParameterAssociation);
@@ -888,6 +2150,30 @@ void FVATModelEditorToolkit::UpdateMaterialInstanceFromDataAsset(const UVATModel
 		}
 	}
 
+	// Frame Remap
+	if (Model->Settings->UsesFrameRemap())
+	{
+		UMaterialEditingLibrary::SetMaterialInstanceTextureParameterValue(MaterialInstance, VATParamNames::FrameRemapTexture, Model->GetFrameRemapTexture(LODIndex), MaterialParameterAssociation);
+	}
+
+	// Page Table
+	if (Model->Settings->UsesPagedTextures())
+	{
+		UMaterialEditingLibrary::SetMaterialInstanceTextureParameterValue(MaterialInstance, VATParamNames::PageTableTexture, Model->GetPageTableTexture(LODIndex), MaterialParameterAssociation);
+	}
+
+	// Interleaved Frames and Temporal Mips
+	if (Model->Settings->UsesInterleavedFrames() || Model->Settings->bTemporalMips)
+	{
+		UMaterialEditingLibrary::SetMaterialInstanceScalarParameterValue(MaterialInstance, VATParamNames::NumStoredFrames, Model->NumKeyframes[LODIndex], MaterialParameterAssociation);
+	}
+
+	if (Model->Settings->bTemporalMips)
+	{
+		UMaterialEditingLibrary::SetMaterialInstanceScalarParameterValue(MaterialInstance, VATParamNames::NumTemporalMips, Model->NumTemporalMips[LODIndex], MaterialParameterAssociation);
+		UMaterialEditingLibrary::SetMaterialInstanceScalarParameterValue(MaterialInstance, VATParamNames::TemporalMipDistance, Model->Settings->TemporalMipDistance, MaterialParameterAssociation);
+	}
+
 	// AutoPlay
 	UMaterialEditingLibrary::SetMaterialInstanceStaticSwitchParameterValue(MaterialInstance, VATParamNames::AutoPlay, Model->Settings->bAutoPlay, MaterialParameterAssociation);
 	if (Model->Settings->bAutoPlay)
@@ -913,98 +2199,212 @@ void FVATModelEditorToolkit::UpdateMaterialInstanceFromDataAsset(const UVATModel
 			UE_LOG(LogTemp, Warning, TEXT("Frame out of range: %i"), Model->Settings->Frame);
 		}
 	}
-	
-	// NumFrames
-	UMaterialEditingLibrary::SetMaterialInstanceScalarParameterValue(MaterialInstance, VATParamNames::NumFrames, Model->NumFrames, MaterialParameterAssociation);
-
-	// SampleRate
-	UMaterialEditingLibrary::SetMaterialInstanceScalarParameterValue(MaterialInstance, VATParamNames::SampleRate, Model->Settings->SampleRate, MaterialParameterAssociation);
-
-	// Update Material
-	UMaterialEditingLibrary::UpdateMaterialInstance(MaterialInstance);
+	
+	// NumFrames
+	UMaterialEditingLibrary::SetMaterialInstanceScalarParameterValue(MaterialInstance, VATParamNames::NumFrames, Model->NumFrames, MaterialParameterAssociation);
+
+	// SampleRate. Animations can have their own rate.
+	const float SampleRate = Model->Animations.IsValidIndex(Model->Settings->AnimationIndex) ?
+		Model->Animations[Model->Settings->AnimationIndex].SampleRate : Model->Settings->SampleRate;
+	UMaterialEditingLibrary::SetMaterialInstanceScalarParameterValue(MaterialInstance, VATParamNames::SampleRate, SampleRate, MaterialParameterAssociation);
+
+	// Update Material
+	UMaterialEditingLibrary::UpdateMaterialInstance(MaterialInstance);
+
+	// Rebuild Material
+	UMaterialEditingLibrary::RebuildMaterialInstanceEditors(MaterialInstance->GetMaterial());
+
+	// Set Preview Mesh
+	if (Model->GetStaticMesh())
+	{
+		MaterialInstance->PreviewMesh = Model->GetStaticMesh();
+	}
+
+	MaterialInstance->MarkPackageDirty();
+	
+}
+
+bool FVATModelEditorToolkit::CheckDataAsset(const UVATModel* Model, const int32 LODIndex, int32& OutSocketIndex,
+                                            TArray<FVATAnimSequenceInfo>& OutAnimSequences)
+{
+	// Check StaticMesh
+	if (!Model->GetStaticMesh())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Invalid StaticMesh"));
+		return false;
+	}
+
+	// Check SkeletalMesh
+	if (!Model->GetSkeletalMesh())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Invalid SkeletalMesh"));
+		return false;
+	}
+
+	// Check Skeleton
+	if (!Model->GetSkeletalMesh()->GetSkeleton())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Invalid SkeletalMesh. No valid Skeleton found"));
+		return false;
+	}
+
+	// Check Socket
+	OutSocketIndex = INDEX_NONE;
+	if (Model->Settings->UsesSocketBinding())
+	{
+		if (Model->Mode != EVATModelMode::Bone)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("AttachToSocket is only supported on Bone Mode"));
+			return false;
+		}
+
+		// Get Bone Names (no virtual)
+		TArray<FName> BoneNames;
+		FVATSkeletalMeshUtilities::GetBoneNames(Model->GetSkeletalMesh(), BoneNames);
+
+		// Check if Socket is in BoneNames. The socket is the only baked bone, so its index always fits the skin weights
+		OutSocketIndex = BoneNames.Find(Model->Settings->AttachToSocket);
+		if (OutSocketIndex == INDEX_NONE)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Socket: %s not found in Raw Bone List"), *Model->Settings->AttachToSocket.ToString());
+			return false;
+		}
+	}
+
+	// Check if UVChannel is being used by the Lightmap UV
+	Model->GetStaticMesh()->Build();
+	const FStaticMeshSourceModel& SourceModel = Model->GetStaticMesh()->GetSourceModel(LODIndex);
+	
+	if (SourceModel.BuildSettings.bGenerateLightmapUVs &&
+		SourceModel.BuildSettings.DstLightmapIndex == Model->UVChannel)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Invalid StaticMesh UVChannel: %i. Already used by LightMap"), Model->UVChannel);
+		return false;
+	}
+
+	// Check Skin Weights UVChannels
+	if (Model->Settings->bSkinWeightsInUVs && Model->UVChannel + 1 >= MAX_MESH_TEXTURE_COORDS_MD)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Invalid StaticMesh UVChannel: %i. Skin Weights need two UVChannels"), Model->UVChannel);
+		return false;
+	}
+
+	// Check if NumBones > 256. Integer Bone Indices are exact up to 2048 bones.
+	int32 NumBones = FVATSkeletalMeshUtilities::GetNumBones(Model->GetSkeletalMesh());
+	if (OutSocketIndex != INDEX_NONE)
+	{
+		NumBones = 1;
+	}
+	else if (Model->Mode == EVATModelMode::Bone && Model->Settings->bCullUnusedBones)
+	{
+		TArray<int32> BoneMap;
+		TArray<float> BoneImportances;
+		GetBoneMap(Model, BoneMap, BoneImportances);
+		NumBones = BoneMap.Num();
+	}
+	if (Model->Mode == EVATModelMode::Bone && Model->Settings->bIntegerBoneIndices)
+	{
+		if (NumBones > 2048)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Too many Bones: %i. There is a maximum of 2048 bones for Integer Bone Indices"), NumBones);
+			return false;
+		}
+	}
+	else if (Model->Mode == EVATModelMode::Bone &&
+		Model->Settings->Precision == EVATPrecision::EightBits &&
+		!Model->Settings->bSkinWeightsInUVs &&
+		NumBones > 256)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Too many Bones: %i. There is a maximum of 256 bones for 8bit Precision"), NumBones);
+		return false;
+	}
+	
+	// Check Paged Textures
+	if (Model->Mode == EVATModelMode::CompressedVertex && Model->Settings->UsesPagedTextures())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Paged Texture Layouts are not supported on CompressedVertex Mode"));
+		return false;
+	}
 
-	// Rebuild Material
-	UMaterialEditingLibrary::RebuildMaterialInstanceEditors(MaterialInstance->GetMaterial());
-
-	// Set Preview Mesh
-	if (Model->GetStaticMesh())
+	// Deduplicated frames can point to frames of other animations, which would need their pages resident too
+	if (Model->Settings->TextureLayout == EVATTextureLayout::PerAnimation && Model->Settings->bDeduplicateFrames)
 	{
-		MaterialInstance->PreviewMesh = Model->GetStaticMesh();
+		UE_LOG(LogTemp, Warning, TEXT("Frame Deduplication is not supported with a PerAnimation Texture Layout"));
+		return false;
 	}
 
-	MaterialInstance->MarkPackageDirty();
-	
-}
-
-bool FVATModelEditorToolkit::CheckDataAsset(const UVATModel* Model, const int32 LODIndex, int32& OutSocketIndex,
-                                            TArray<FVATAnimSequenceInfo>& OutAnimSequences)
-{
-	// Check StaticMesh
-	if (!Model->GetStaticMesh())
+	if ((Model->Mode == EVATModelMode::Bone || Model->Mode == EVATModelMode::SkinningDecomposition) &&
+		Model->Settings->BoneEncoding != EVATBoneEncoding::AxisAngle &&
+		Model->Settings->TextureLayout != EVATTextureLayout::Single)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("Invalid StaticMesh"));
+		UE_LOG(LogTemp, Warning, TEXT("MatrixPalette and DualQuaternion Bone Encodings are only supported with a Single Texture Layout"));
 		return false;
 	}
 
-	// Check SkeletalMesh
-	if (!Model->GetSkeletalMesh())
+	// Residuals are addressed with the BoneWeight texels
+	if (Model->Settings->bBakeResiduals && Model->Mode == EVATModelMode::Bone &&
+		(Model->Settings->bSkinWeightsInUVs || Model->Settings->UsesRigidSections()))
 	{
-		UE_LOG(LogTemp, Warning, TEXT("Invalid SkeletalMesh"));
+		UE_LOG(LogTemp, Warning, TEXT("Bake Residuals is not supported with Skin Weights in UVs, Rigid Sections or AttachToSocket"));
 		return false;
 	}
 
-	// Check Skeleton
-	if (!Model->GetSkeletalMesh()->GetSkeleton())
+	// Vertex Sections replace the skin weights of their vertices in the UVChannel
+	if (Model->Settings->UsesVertexSections() && Model->Mode == EVATModelMode::Bone &&
+		(Model->Settings->bSkinWeightsInUVs || Model->Settings->UsesSocketBinding() || Model->Settings->bBakeResiduals ||
+			Model->Settings->TextureLayout != EVATTextureLayout::Single))
 	{
-		UE_LOG(LogTemp, Warning, TEXT("Invalid SkeletalMesh. No valid Skeleton found"));
+		UE_LOG(LogTemp, Warning, TEXT("Vertex Sections are only supported with a Single Texture Layout, without Skin Weights in UVs, AttachToSocket or Bake Residuals"));
 		return false;
 	}
 
-	// Check Socket.
-	/*
-	OutSocketIndex = INDEX_NONE;
-	if (Model->AttachToSocket.IsValid() && !Model->AttachToSocket.IsNone())
+	if (Model->Mode != EVATModelMode::Vertex && Model->Settings->UsesInterleavedFrames())
 	{
-		// Get Bone Names (no virtual)
-		TArray<FName> BoneNames;
-		GetBoneNames(Model->GetSkeletalMesh(), BoneNames);
+		UE_LOG(LogTemp, Warning, TEXT("Interleaved Texture Layout is only supported on Vertex Mode"));
+		return false;
+	}
 
-		// Check if Socket is in BoneNames
-		if (!BoneNames.Find(Model->AttachToSocket, OutSocketIndex))
+	if (Model->Settings->bTemporalMips)
+	{
+		if (Model->Mode != EVATModelMode::Vertex || Model->Settings->TextureLayout != EVATTextureLayout::Single)
 		{
-			UE_LOG(LogTemp, Warning, TEXT("Socket: %s not found in Raw Bone List"), *Model->AttachToSocket.ToString());
+			UE_LOG(LogTemp, Warning, TEXT("Temporal Mips are only supported on Vertex Mode with a Single Texture Layout"));
 			return false;
 		}
-		else
+		if (!Model->Settings->bEnforcePowerOfTwo)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Temporal Mips require EnforcePowerOfTwo"));
+			return false;
+		}
+		// Mips subsample the stored frames, which must match the animation frames
+		if (Model->Settings->UsesFrameRemap())
 		{
-			// TODO: SocketIndex can only be < TNumericLimits<uint16>::Max()
+			UE_LOG(LogTemp, Warning, TEXT("Temporal Mips are not supported with Keyframe Reduction or Frame Deduplication"));
+			return false;
 		}
 	}
-	*/
 
-	// Check if UVChannel is being used by the Lightmap UV
-	Model->GetStaticMesh()->Build();
-	const FStaticMeshSourceModel& SourceModel = Model->GetStaticMesh()->GetSourceModel(LODIndex);
-	
-	if (SourceModel.BuildSettings.bGenerateLightmapUVs &&
-		SourceModel.BuildSettings.DstLightmapIndex == Model->UVChannel)
+	// Check Animations
+	// Animation Libraries bake the Bone textures of every VATModel of the Skeleton, so the bones can't depend on the mesh
+	const UVATAnimationLibrary* AnimationLibrary = Model->Mode == EVATModelMode::Bone ? Model->AnimationLibrary.Get() : nullptr;
+	if (AnimationLibrary)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("Invalid StaticMesh UVChannel: %i. Already used by LightMap"), Model->UVChannel);
-		return false;
-	}
+		if (AnimationLibrary->Skeleton != Model->GetSkeletalMesh()->GetSkeleton())
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Invalid Animation Library: %s. Skeleton doesn't match the SkeletalMesh Skeleton"), *AnimationLibrary->GetName());
+			return false;
+		}
 
-	// Check if NumBones > 256
-	const int32 NumBones = FVATSkeletalMeshUtilities::GetNumBones(Model->GetSkeletalMesh());
-	if (Model->Settings->Precision == EVATPrecision::EightBits &&
-		NumBones > 256)
-	{
-		UE_LOG(LogTemp, Warning, TEXT("Too many Bones: %i. There is a maximum of 256 bones for 8bit Precision"), NumBones);
-		return false;
+		if (Model->Settings->BoneEncoding != EVATBoneEncoding::AxisAngle || Model->Settings->TextureLayout != EVATTextureLayout::Single ||
+			Model->Settings->bCullUnusedBones || Model->Settings->bReduceBoneLODs || OutSocketIndex != INDEX_NONE)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Animation Libraries are only supported with the AxisAngle Bone Encoding and a Single Texture Layout, without Cull Unused Bones, Reduce Bone LODs or AttachToSocket"));
+			return false;
+		}
 	}
-	
-	// Check Animations
+
 	OutAnimSequences.Reset();
-	for (const FVATAnimSequenceInfo& AnimSequenceInfo : Model->AnimSequences)
+	for (const FVATAnimSequenceInfo& AnimSequenceInfo : AnimationLibrary ? AnimationLibrary->AnimSequences : Model->AnimSequences)
 	{
 		const UAnimSequence* AnimSequence = AnimSequenceInfo.AnimSequence;
 
@@ -1027,6 +2427,13 @@ bool FVATModelEditorToolkit::CheckDataAsset(const UVATModel* Model, const int32
 				return false;
 			}
 
+			// Check SampleRate
+			if (AnimSequenceInfo.bUseCustomSampleRate && AnimSequenceInfo.SampleRate <= 0.f)
+			{
+				UE_LOG(LogTemp, Warning, TEXT("Invalid SampleRate for AnimSequence: %s"), *AnimSequence->GetName());
+				return false;
+			}
+
 			// Store Valid AnimSequenceInfo
 			OutAnimSequences.Add(AnimSequenceInfo);
 		}
@@ -1038,6 +2445,21 @@ bool FVATModelEditorToolkit::CheckDataAsset(const UVATModel* Model, const int32
 		return false;
 	}
 
+	// Baked Animation Libraries are shared. Rebaking them with other data would break the VATModels already using them.
+	if (AnimationLibrary && !AnimationLibrary->BakeKey.IsEmpty())
+	{
+		TArray<FVector3f> BoneRefPositions;
+		TArray<FVector4f> BoneRefRotations;
+		GetRefBonePositionsAndRotations(Model->GetSkeletalMesh(), BoneRefPositions, BoneRefRotations);
+
+		if (GetAnimationLibraryKey(Model, OutAnimSequences, BoneRefPositions, BoneRefRotations) != AnimationLibrary->BakeKey)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Invalid Animation Library: %s. It was baked by %s with other animations, settings or RefPose. Use another Animation Library, or delete its textures to rebake it."),
+				*AnimationLibrary->GetName(), *AnimationLibrary->BakedBy);
+			return false;
+		}
+	}
+
 	// All Good !
 	return true;
 	
@@ -1068,6 +2490,39 @@ int32 FVATModelEditorToolkit::GetAnimationFrameRange(const FVATAnimSequenceInfo&
 	return OutEndFrame - OutStartFrame + 1;
 }
 
+FString FVATModelEditorToolkit::GetAnimationLibraryKey(const UVATModel* Model, const TArray<FVATAnimSequenceInfo>& AnimSequences,
+	const TArray<FVector3f>& BoneRefPositions, const TArray<FVector4f>& BoneRefRotations)
+{
+	check(Model && Model->Settings);
+	const UVATModelSettings* Settings = Model->Settings;
+
+	FString Key = Model->GetSkeletalMesh()->GetSkeleton()->GetPathName();
+
+	// Animations
+	for (const FVATAnimSequenceInfo& AnimSequenceInfo : AnimSequences)
+	{
+		int32 StartFrame, EndFrame;
+		GetAnimationFrameRange(AnimSequenceInfo, StartFrame, EndFrame);
+		Key += FString::Printf(TEXT("|%s %d %d %f"), *AnimSequenceInfo.AnimSequence->GetPathName(), StartFrame, EndFrame,
+			AnimSequenceInfo.bUseCustomSampleRate ? AnimSequenceInfo.SampleRate : Settings->SampleRate);
+	}
+
+	// Settings changing the Bone data or its layout
+	Key += FString::Printf(TEXT("|%s|%d %f %f|%d %d %d %d %d|%d %f %d|%d %f"), *Settings->RootTransform.ToString(),
+		(int32)Settings->bAutoSampleRate, Settings->MinSampleRate, Settings->SampleRateErrorTolerance,
+		(int32)Settings->Precision, Settings->MaxHeight, Settings->MaxWidth, (int32)Settings->bEnforcePowerOfTwo, (int32)Settings->bMinimizePaddedTextureSize,
+		(int32)Settings->bReduceKeyframes, Settings->KeyframeErrorTolerance, (int32)Settings->bTrimStaticFrames,
+		(int32)Settings->bDeduplicateFrames, Settings->FrameDeduplicationTolerance);
+
+	// RefPose of the SkeletalMesh. Meshes with other proportions can't share the Bone data
+	for (int32 BoneIndex = 0; BoneIndex < BoneRefPositions.Num(); BoneIndex++)
+	{
+		Key += FString::Printf(TEXT("|%s %s"), *BoneRefPositions[BoneIndex].ToString(), *BoneRefRotations[BoneIndex].ToString());
+	}
+
+	return FMD5::HashAnsiString(*Key);
+}
+
 void FVATModelEditorToolkit::GetVertexDeltasAndNormals(const USkeletalMeshComponent* SkeletalMeshComponent,
 	const int32 LODIndex, const FSourceMeshToDriverMesh& SourceMeshToDriverMesh, const FTransform RootTransform,
 	TArray<FVector3f>& OutVertexDeltas, TArray<FVector3f>& OutVertexNormals)
@@ -1128,55 +2583,344 @@ int32 FVATModelEditorToolkit::GetRefBonePositionsAndRotations(const USkeletalMes
 	return NumBones;
 }
 
-int32 FVATModelEditorToolkit::GetBonePositionsAndRotations(const USkeletalMeshComponent* SkeletalMeshComponent,
-	const TArray<FVector3f>& BoneRefPositions, TArray<FVector3f>& BonePositions, TArray<FVector4f>& BoneRotations)
+int32 FVATModelEditorToolkit::GetBonePositionsAndRotations(const USkeletalMeshComponent* SkeletalMeshComponent,
+	const TArray<FVector3f>& BoneRefPositions, TArray<FVector3f>& BonePositions, TArray<FVector4f>& BoneRotations)
+{
+	check(SkeletalMeshComponent);
+
+	BonePositions.Reset();
+	BoneRotations.Reset();
+
+	// Get Relative Transforms
+	// Note: Size is of Raw bones in SkeletalMesh. These are the original/raw bones of the asset, without Virtual Bones.
+	TArray<FMatrix44f> RefToLocals;
+	SkeletalMeshComponent->CacheRefToLocalMatrices(RefToLocals);
+	const int32 NumBones = RefToLocals.Num();
+
+	// check size
+	check(NumBones == BoneRefPositions.Num());
+
+	// Get Component Space Transforms
+	// Note returns all transforms, including VirtualBones
+	const TArray<FTransform>& CompSpaceTransforms = SkeletalMeshComponent->GetComponentSpaceTransforms();
+	check(CompSpaceTransforms.Num() >= RefToLocals.Num());
+
+	// Allocate
+	BonePositions.SetNumUninitialized(NumBones);
+	BoneRotations.SetNumUninitialized(NumBones);
+
+	for (int32 BoneIndex = 0; BoneIndex < NumBones; BoneIndex++)
+	{
+		// Decompose Transformation (ComponentSpace)
+		const FTransform& CompSpaceTransform = CompSpaceTransforms[BoneIndex];
+		FVector3f BonePosition;
+		FVector4f BoneRotation;
+		FVATSkeletalMeshUtilities::DecomposeTransformation(CompSpaceTransform, BonePosition, BoneRotation);
+
+		// Position Delta (from RefPose)
+		const FVector3f Delta = BonePosition - BoneRefPositions[BoneIndex];
+
+		// Decompose Transformation (Relative to RefPose)
+		FVector3f BoneRelativePosition;
+		FVector4f BoneRelativeRotation;
+		const FMatrix RefToLocalMatrix(RefToLocals[BoneIndex]);
+		const FTransform RelativeTransform(RefToLocalMatrix);
+		FVATSkeletalMeshUtilities::DecomposeTransformation(RelativeTransform, BoneRelativePosition, BoneRelativeRotation);
+
+		BonePositions[BoneIndex] = Delta;
+		BoneRotations[BoneIndex] = BoneRelativeRotation;
+	}
+
+	return NumBones;
+}
+
+void FVATModelEditorToolkit::GetBoneMap(const UVATModel* Model, TArray<int32>& OutBoneMap, TArray<float>& OutBoneImportances)
+{
+	const USkeletalMesh* SkeletalMesh = Model->GetSkeletalMesh();
+	check(SkeletalMesh);
+
+	const FReferenceSkeleton& RefSkeleton = SkeletalMesh->GetRefSkeleton();
+	const int32 NumBones = FVATSkeletalMeshUtilities::GetNumBones(SkeletalMesh);
+	TBitArray<> UsedBones(false, NumBones);
+	TArray<float> Importances;
+	Importances.Init(0.f, NumBones);
+	float TotalWeight = 0.f;
+
+	// Projected skin weights are interpolated from the SkeletalMesh weights.
+	// Driver LODs (mapping and forced LOD) are within [0, LODRange.Y]
+	for (int32 LODIndex = 0; LODIndex <= (int32)Model->LODRange.Y; ++LODIndex)
+	{
+		TArray<VertexSkinWeightMax> SkinWeights;
+		FVATSkeletalMeshUtilities::GetSkinWeights(SkeletalMesh, LODIndex, SkinWeights);
+
+		for (const VertexSkinWeightMax& SkinWeight : SkinWeights)
+		{
+			for (int32 Index = 0; Index < MAX_TOTAL_INFLUENCES; ++Index)
+			{
+				if (SkinWeight.BoneWeights[Index] > 0 && SkinWeight.MeshBoneIndices[Index] < NumBones)
+				{
+					UsedBones[SkinWeight.MeshBoneIndices[Index]] = true;
+
+					// Importance is measured on the first LOD
+					if (LODIndex == 0)
+					{
+						Importances[SkinWeight.MeshBoneIndices[Index]] += SkinWeight.BoneWeights[Index];
+						TotalWeight += SkinWeight.BoneWeights[Index];
+					}
+				}
+			}
+		}
+	}
+
+	// Add the importance of the children. Raw bones are sorted, so children come after their parents
+	for (int32 BoneIndex = NumBones - 1; BoneIndex > 0; --BoneIndex)
+	{
+		const int32 ParentIndex = RefSkeleton.GetRawParentIndex(BoneIndex);
+		if (ParentIndex != INDEX_NONE)
+		{
+			Importances[ParentIndex] += Importances[BoneIndex];
+		}
+	}
+
+	// Bones needed without skinned vertices
+	TArray<FName> BoneNames;
+	FVATSkeletalMeshUtilities::GetBoneNames(SkeletalMesh, BoneNames);
+
+	TArray<FName> KeepBones = Model->Settings->KeepBones;
+	KeepBones.Add(Model->Settings->AttachToSocket);
+	for (const FName& KeepBone : KeepBones)
+	{
+		const int32 BoneIndex = KeepBone.IsNone() ? INDEX_NONE : BoneNames.Find(KeepBone);
+		if (BoneIndex != INDEX_NONE)
+		{
+			UsedBones[BoneIndex] = true;
+		}
+	}
+
+	OutBoneMap.Reset();
+	for (int32 BoneIndex = 0; BoneIndex < NumBones; ++BoneIndex)
+	{
+		if (UsedBones[BoneIndex] || !Model->Settings->bCullUnusedBones)
+		{
+			OutBoneMap.Add(BoneIndex);
+		}
+	}
+
+	// Keep at least the root
+	if (!OutBoneMap.Num())
+	{
+		OutBoneMap.Add(0);
+	}
+
+	// Parents are at least as important as their children, so the stable sort keeps them first
+	if (Model->Settings->bReduceBoneLODs)
+	{
+		OutBoneMap.StableSort([&Importances](const int32 BoneA, const int32 BoneB)
+		{
+			return Importances[BoneA] > Importances[BoneB];
+		});
+	}
+
+	OutBoneImportances.Reset();
+	for (const int32 BoneIndex : OutBoneMap)
+	{
+		OutBoneImportances.Add(TotalWeight > 0.f ? Importances[BoneIndex] / TotalWeight : 0.f);
+	}
+}
+
+void FVATModelEditorToolkit::CollapseSkinWeights(const UVATModel* Model, const int32 NumLODBones, TArray<VertexSkinWeightFour>& InOutSkinWeights)
+{
+	const FReferenceSkeleton& RefSkeleton = Model->GetSkeletalMesh()->GetRefSkeleton();
+	const TArray<int32>& BoneMap = Model->BoneMap;
+
+	TArray<int32> SkeletonToBone;
+	SkeletonToBone.Init(INDEX_NONE, FVATSkeletalMeshUtilities::GetNumBones(Model->GetSkeletalMesh()));
+	for (int32 BoneIndex = 0; BoneIndex < BoneMap.Num(); ++BoneIndex)
+	{
+		SkeletonToBone[BoneMap[BoneIndex]] = BoneIndex;
+	}
+
+	// Closest kept parent of each baked bone. Bones without a kept parent are kept
+	TArray<uint16> BoneToLODBone;
+	BoneToLODBone.SetNumUninitialized(BoneMap.Num());
+	for (int32 BoneIndex = 0; BoneIndex < BoneMap.Num(); ++BoneIndex)
+	{
+		int32 LODBoneIndex = BoneIndex;
+		int32 SkeletonBoneIndex = BoneMap[BoneIndex];
+		while (LODBoneIndex == INDEX_NONE || LODBoneIndex >= NumLODBones)
+		{
+			SkeletonBoneIndex = RefSkeleton.GetRawParentIndex(SkeletonBoneIndex);
+			if (SkeletonBoneIndex == INDEX_NONE)
+			{
+				LODBoneIndex = BoneIndex;
+				break;
+			}
+			LODBoneIndex = SkeletonToBone[SkeletonBoneIndex];
+		}
+		BoneToLODBone[BoneIndex] = LODBoneIndex;
+	}
+
+	for (VertexSkinWeightFour& SkinWeight : InOutSkinWeights)
+	{
+		// Merge influences collapsed into the same bone
+		VertexSkinWeightFour Collapsed;
+		Collapsed.MeshBoneIndices = TStaticArray<uint16, 4>(InPlace, 0);
+		Collapsed.BoneWeights = TStaticArray<uint8, 4>(InPlace, 0);
+		int32 NumInfluences = 0;
+
+		for (int32 Index = 0; Index < 4; ++Index)
+		{
+			if (SkinWeight.BoneWeights[Index] == 0)
+			{
+				continue;
+			}
+
+			const uint16 LODBoneIndex = BoneToLODBone[SkinWeight.MeshBoneIndices[Index]];
+			int32 Influence = 0;
+			while (Influence < NumInfluences && Collapsed.MeshBoneIndices[Influence] != LODBoneIndex)
+			{
+				Influence++;
+			}
+
+			Collapsed.MeshBoneIndices[Influence] = LODBoneIndex;
+			Collapsed.BoneWeights[Influence] += SkinWeight.BoneWeights[Index];
+			NumInfluences = FMath::Max(NumInfluences, Influence + 1);
+		}
+
+		// Keep the heaviest influences first
+		for (int32 Index = 1; Index < NumInfluences; ++Index)
+		{
+			for (int32 Other = Index; Other > 0 && Collapsed.BoneWeights[Other] > Collapsed.BoneWeights[Other - 1]; --Other)
+			{
+				Swap(Collapsed.BoneWeights[Other], Collapsed.BoneWeights[Other - 1]);
+				Swap(Collapsed.MeshBoneIndices[Other], Collapsed.MeshBoneIndices[Other - 1]);
+			}
+		}
+
+		SkinWeight = Collapsed;
+	}
+}
+
+void FVATModelEditorToolkit::GetDynamicVertices(const TArray<FVector3f>& VertexDeltas, const int32 NumVertices, const int32 NumFrames,
+	const float Tolerance, TArray<int32>& OutDynamicVertices)
+{
+	check(VertexDeltas.Num() == NumVertices * NumFrames);
+
+	TArray<float> MaxDeltas;
+	MaxDeltas.Init(0.f, NumVertices);
+	for (int32 Frame = 0; Frame < NumFrames; Frame++)
+	{
+		for (int32 VertexIndex = 0; VertexIndex < NumVertices; VertexIndex++)
+		{
+			MaxDeltas[VertexIndex] = FMath::Max(MaxDeltas[VertexIndex], VertexDeltas[Frame * NumVertices + VertexIndex].Size());
+		}
+	}
+
+	OutDynamicVertices.Reset();
+	for (int32 VertexIndex = 0; VertexIndex < NumVertices; VertexIndex++)
+	{
+		if (MaxDeltas[VertexIndex] > Tolerance)
+		{
+			OutDynamicVertices.Add(VertexIndex);
+		}
+	}
+
+	// Keep the most moving vertex, so textures are never empty
+	if (!OutDynamicVertices.Num() && NumVertices)
+	{
+		int32 MaxIndex = 0;
+		FMath::Max(MaxDeltas, &MaxIndex);
+		OutDynamicVertices.Add(MaxIndex);
+	}
+}
+
+void FVATModelEditorToolkit::GetSectionVertices(const UStaticMesh* StaticMesh, const int32 LODIndex,
+	const TArray<int32>& Sections, TArray<int32>& OutVertices)
+{
+	check(StaticMesh);
+	OutVertices.Reset();
+
+	const FMeshDescription* MeshDescription = StaticMesh->GetMeshDescription(LODIndex);
+	if (!MeshDescription)
+	{
+		return;
+	}
+
+	TArray<bool> bSectionVertices;
+	bSectionVertices.Init(false, MeshDescription->Vertices().GetArraySize());
+
+	for (const FPolygonGroupID PolygonGroupID : MeshDescription->PolygonGroups().GetElementIDs())
+	{
+		if (!Sections.Contains(PolygonGroupID.GetValue()))
+		{
+			continue;
+		}
+
+		for (const FTriangleID TriangleID : MeshDescription->GetPolygonGroupTriangles(PolygonGroupID))
+		{
+			for (const FVertexID VertexID : MeshDescription->GetTriangleVertices(TriangleID))
+			{
+				bSectionVertices[VertexID.GetValue()] = true;
+			}
+		}
+	}
+
+	for (int32 VertexIndex = 0; VertexIndex < bSectionVertices.Num(); VertexIndex++)
+	{
+		if (bSectionVertices[VertexIndex])
+		{
+			OutVertices.Add(VertexIndex);
+		}
+	}
+}
+
+int32 FVATModelEditorToolkit::GetRigidSectionBones(const UStaticMesh* StaticMesh, const int32 LODIndex,
+	const TArray<VertexSkinWeightFour>& SkinWeights, TArray<int32>& OutSectionBones)
 {
-	check(SkeletalMeshComponent);
-
-	BonePositions.Reset();
-	BoneRotations.Reset();
-
-	// Get Relative Transforms
-	// Note: Size is of Raw bones in SkeletalMesh. These are the original/raw bones of the asset, without Virtual Bones.
-	TArray<FMatrix44f> RefToLocals;
-	SkeletalMeshComponent->CacheRefToLocalMatrices(RefToLocals);
-	const int32 NumBones = RefToLocals.Num();
-
-	// check size
-	check(NumBones == BoneRefPositions.Num());
+	check(StaticMesh);
+	OutSectionBones.Reset();
 
-	// Get Component Space Transforms
-	// Note returns all transforms, including VirtualBones
-	const TArray<FTransform>& CompSpaceTransforms = SkeletalMeshComponent->GetComponentSpaceTransforms();
-	check(CompSpaceTransforms.Num() >= RefToLocals.Num());
+	const FMeshDescription* MeshDescription = StaticMesh->GetMeshDescription(LODIndex);
+	if (!MeshDescription)
+	{
+		return 0;
+	}
 
-	// Allocate
-	BonePositions.SetNumUninitialized(NumBones);
-	BoneRotations.SetNumUninitialized(NumBones);
+	int32 NumRigidSections = 0;
+	OutSectionBones.Init(INDEX_NONE, MeshDescription->PolygonGroups().GetArraySize());
 
-	for (int32 BoneIndex = 0; BoneIndex < NumBones; BoneIndex++)
+	for (const FPolygonGroupID PolygonGroupID : MeshDescription->PolygonGroups().GetElementIDs())
 	{
-		// Decompose Transformation (ComponentSpace)
-		const FTransform& CompSpaceTransform = CompSpaceTransforms[BoneIndex];
-		FVector3f BonePosition;
-		FVector4f BoneRotation;
-		FVATSkeletalMeshUtilities::DecomposeTransformation(CompSpaceTransform, BonePosition, BoneRotation);
-
-		// Position Delta (from RefPose)
-		const FVector3f Delta = BonePosition - BoneRefPositions[BoneIndex];
+		// Weights are pruned and sorted, so single bone vertices have a full first influence
+		int32 SectionBone = INDEX_NONE;
+		bool bRigid = true;
+		for (const FTriangleID TriangleID : MeshDescription->GetPolygonGroupTriangles(PolygonGroupID))
+		{
+			for (const FVertexID VertexID : MeshDescription->GetTriangleVertices(TriangleID))
+			{
+				const VertexSkinWeightFour& SkinWeight = SkinWeights[VertexID.GetValue()];
+				if (SkinWeight.BoneWeights[0] != 255 || (SectionBone != INDEX_NONE && SectionBone != SkinWeight.MeshBoneIndices[0]))
+				{
+					bRigid = false;
+					break;
+				}
+				SectionBone = SkinWeight.MeshBoneIndices[0];
+			}
 
-		// Decompose Transformation (Relative to RefPose)
-		FVector3f BoneRelativePosition;
-		FVector4f BoneRelativeRotation;
-		const FMatrix RefToLocalMatrix(RefToLocals[BoneIndex]);
-		const FTransform RelativeTransform(RefToLocalMatrix);
-		FVATSkeletalMeshUtilities::DecomposeTransformation(RelativeTransform, BoneRelativePosition, BoneRelativeRotation);
+			if (!bRigid)
+			{
+				break;
+			}
+		}
 
-		BonePositions[BoneIndex] = Delta;
-		BoneRotations[BoneIndex] = BoneRelativeRotation;
+		if (bRigid && SectionBone != INDEX_NONE)
+		{
+			OutSectionBones[PolygonGroupID.GetValue()] = SectionBone;
+			NumRigidSections++;
+		}
 	}
 
-	return NumBones;
+	return NumRigidSections;
 }
 
 void FVATModelEditorToolkit::NormalizeVertexData(const TArray<FVector3f>& Deltas, const TArray<FVector3f>& Normals,
@@ -1233,6 +2977,44 @@ void FVATModelEditorToolkit::NormalizeVertexData(const TArray<FVector3f>& Deltas
 
 }
 
+void FVATModelEditorToolkit::ComputeBoundingBox(const TArray<FVector3f>& Vectors, FVector3f& OutMinBBox,
+	FVector3f& OutSizeBBox)
+{
+	if (Vectors.IsEmpty())
+	{
+		OutMinBBox = FVector3f::ZeroVector;
+		OutSizeBBox = FVector3f::ZeroVector;
+		return;
+	}
+
+	OutMinBBox = { TNumericLimits<float>::Max(), TNumericLimits<float>::Max(), TNumericLimits<float>::Max() };
+	FVector3f MaxBBox = { TNumericLimits<float>::Lowest(), TNumericLimits<float>::Lowest(), TNumericLimits<float>::Lowest() };
+
+	for (const FVector3f& Vector : Vectors)
+	{
+		OutMinBBox = OutMinBBox.ComponentMin(Vector);
+		MaxBBox = MaxBBox.ComponentMax(Vector);
+	}
+
+	OutSizeBBox = MaxBBox - OutMinBBox;
+}
+
+void FVATModelEditorToolkit::NormalizeVectors(const TArray<FVector3f>& Vectors, const FVector3f& MinBBox,
+	const FVector3f& SizeBBox, TArray<FVector3f>& OutNormalizedVectors)
+{
+	// Flat axis are stored as 0
+	const FVector3f NormFactor = {
+		SizeBBox.X > UE_SMALL_NUMBER ? 1.f / SizeBBox.X : 0.f,
+		SizeBBox.Y > UE_SMALL_NUMBER ? 1.f / SizeBBox.Y : 0.f,
+		SizeBBox.Z > UE_SMALL_NUMBER ? 1.f / SizeBBox.Z : 0.f };
+
+	OutNormalizedVectors.SetNumUninitialized(Vectors.Num());
+	for (int32 Index = 0; Index < Vectors.Num(); ++Index)
+	{
+		OutNormalizedVectors[Index] = (Vectors[Index] - MinBBox) * NormFactor;
+	}
+}
+
 void FVATModelEditorToolkit::NormalizeBoneData(const TArray<FVector3f>& Positions, const TArray<FVector4f>& Rotations,
 	FVector3f& OutMinBBox, FVector3f& OutSizeBBox, TArray<FVector3f>& OutNormalizedPositions,
 	TArray<FVector4f>& OutNormalizedRotations)
@@ -1257,66 +3039,544 @@ void FVATModelEditorToolkit::NormalizeBoneData(const TArray<FVector3f>& Position
 		MaxBBox.Z = FMath::Max(Position.Z, MaxBBox.Z);
 	}
 
-	OutSizeBBox = MaxBBox - OutMinBBox;
+	OutSizeBBox = MaxBBox - OutMinBBox;
+
+	// ---------------------------------------------------------------------------
+	// Normalize Bone Position.
+	// Basically we want all positions to be between [0, 1]
+
+	// Compute Normalization Factor per-axis.
+	const FVector3f NormFactor = {
+		1.f / static_cast<float>(OutSizeBBox.X),
+		1.f / static_cast<float>(OutSizeBBox.Y),
+		1.f / static_cast<float>(OutSizeBBox.Z) };
+
+	OutNormalizedPositions.SetNumUninitialized(Positions.Num());
+	for (int32 Index = 0; Index < Positions.Num(); ++Index)
+	{
+		OutNormalizedPositions[Index] = (Positions[Index] - OutMinBBox) * NormFactor;
+	}
+
+	// ---------------------------------------------------------------------------
+	// Normalize Rotations
+	// And move them to [0, 1]
+	OutNormalizedRotations.SetNumUninitialized(Rotations.Num());
+	for (int32 Index = 0; Index < Rotations.Num(); ++Index)
+	{
+		const FVector4f Axis = Rotations[Index];
+		const float Angle = Rotations[Index].W; // Angle are returned in radians and they go from [0-pi*2]
+
+		OutNormalizedRotations[Index] = (Axis.GetSafeNormal() + FVector3f::OneVector) * 0.5f;
+		OutNormalizedRotations[Index].W = Angle / (PI * 2.f);
+	}
+}
+
+void FVATModelEditorToolkit::NormalizeBoneMatrices(const TArray<FVector3f>& Positions, const TArray<FVector4f>& Rotations,
+	const int32 NumBones, FVector3f& OutMinBBox, FVector3f& OutSizeBBox, TArray<FVector4f>& OutNormalizedMatrixRows)
+{
+	check(Positions.Num() == Rotations.Num());
+	check(NumBones > 0 && Positions.Num() % NumBones == 0);
+
+	// RefPose is the first frame. It is folded into the matrices and not stored.
+	const int32 NumFrames = Positions.Num() / NumBones - 1;
+
+	// ---------------------------------------------------------------------------
+	// Build RefToLocal matrices.
+	// Position' = Rotation * (Position - RefPosition) + RefPosition + Delta
+	//           = Rotation * Position + Translation
+	TArray<FMatrix44f> Matrices;
+	TArray<FVector3f> Translations;
+	Matrices.SetNumUninitialized(NumFrames * NumBones);
+	Translations.SetNumUninitialized(NumFrames * NumBones);
+
+	for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		for (int32 BoneIndex = 0; BoneIndex < NumBones; ++BoneIndex)
+		{
+			const int32 Index = (Frame + 1) * NumBones + BoneIndex;
+			const FVector3f& RefPosition = Positions[BoneIndex];
+			const FVector3f Axis = FVector3f(Rotations[Index]).GetSafeNormal();
+			const FQuat4f Rotation = Axis.IsZero() ? FQuat4f::Identity : FQuat4f(Axis, Rotations[Index].W);
+
+			const int32 MatrixIndex = Frame * NumBones + BoneIndex;
+			Matrices[MatrixIndex] = Rotation.ToMatrix();
+			Translations[MatrixIndex] = RefPosition + Positions[Index] - Rotation.RotateVector(RefPosition);
+		}
+	}
+
+	// ---------------------------------------------------------------------------
+	// Normalize Translations with Bounding Box
+	ComputeBoundingBox(Translations, OutMinBBox, OutSizeBBox);
+
+	TArray<FVector3f> NormalizedTranslations;
+	NormalizeVectors(Translations, OutMinBBox, OutSizeBBox, NormalizedTranslations);
+
+	// ---------------------------------------------------------------------------
+	// Store Rows. Matrices are row-vector (V * M), so row R of the column-vector matrix is column R.
+	OutNormalizedMatrixRows.SetNumUninitialized(NumFrames * NumBones * 3);
+	for (int32 MatrixIndex = 0; MatrixIndex < Matrices.Num(); ++MatrixIndex)
+	{
+		const FMatrix44f& Matrix = Matrices[MatrixIndex];
+		for (int32 Row = 0; Row < 3; ++Row)
+		{
+			const FVector3f Rotation(Matrix.M[0][Row], Matrix.M[1][Row], Matrix.M[2][Row]);
+			OutNormalizedMatrixRows[MatrixIndex * 3 + Row] = FVector4f((Rotation + FVector3f::OneVector) * 0.5f, NormalizedTranslations[MatrixIndex][Row]);
+		}
+	}
+}
+
+void FVATModelEditorToolkit::GetBoneDualQuaternions(const TArray<FVector3f>& Positions, const TArray<FVector4f>& Rotations,
+	const int32 NumBones, TArray<FQuat4f>& OutReals, TArray<FQuat4f>& OutDuals)
+{
+	check(Positions.Num() == Rotations.Num());
+	check(NumBones > 0 && Positions.Num() % NumBones == 0);
+
+	// RefPose is the first frame. It is folded into the quaternions and not stored.
+	const int32 NumFrames = Positions.Num() / NumBones - 1;
+
+	OutReals.SetNumUninitialized(NumFrames * NumBones);
+	OutDuals.SetNumUninitialized(NumFrames * NumBones);
+
+	for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		for (int32 BoneIndex = 0; BoneIndex < NumBones; ++BoneIndex)
+		{
+			const int32 Index = (Frame + 1) * NumBones + BoneIndex;
+			const FVector3f& RefPosition = Positions[BoneIndex];
+			const FVector3f Axis = FVector3f(Rotations[Index]).GetSafeNormal();
+			FQuat4f Rotation = Axis.IsZero() ? FQuat4f::Identity : FQuat4f(Axis, Rotations[Index].W);
+
+			// Keep the sign of the previous frame, so frames interpolate along the shortest path
+			if (Frame > 0 && (Rotation | OutReals[(Frame - 1) * NumBones + BoneIndex]) < 0.f)
+			{
+				Rotation = Rotation * -1.f;
+			}
+
+			// Position' = Rotation * (Position - RefPosition) + RefPosition + Delta
+			const FVector3f Translation = RefPosition + Positions[Index] - Rotation.RotateVector(RefPosition);
+
+			const int32 QuatIndex = Frame * NumBones + BoneIndex;
+			FVATSkeletalMeshUtilities::GetDualQuaternion(Rotation, Translation, OutReals[QuatIndex], OutDuals[QuatIndex]);
+		}
+	}
+}
+
+void FVATModelEditorToolkit::NormalizeBoneDualQuaternions(const TArray<FQuat4f>& Reals, const TArray<FQuat4f>& Duals,
+	FVector3f& OutMinBBox, FVector3f& OutSizeBBox, TArray<FVector4f>& OutNormalizedReals, TArray<FVector4f>& OutNormalizedDuals)
+{
+	check(Reals.Num() == Duals.Num());
+
+	// Dual components share a symmetric range
+	float Range = 0.f;
+	for (const FQuat4f& Dual : Duals)
+	{
+		Range = FMath::Max(Range, FMath::Max(FMath::Max(FMath::Abs(Dual.X), FMath::Abs(Dual.Y)), FMath::Max(FMath::Abs(Dual.Z), FMath::Abs(Dual.W))));
+	}
+
+	OutMinBBox = FVector3f(-Range);
+	OutSizeBBox = FVector3f(Range * 2.f);
+
+	// Flat range is stored as 0.5
+	const float NormFactor = Range > UE_SMALL_NUMBER ? 0.5f / Range : 0.f;
+
+	const FVector4f Half(0.5f, 0.5f, 0.5f, 0.5f);
+	OutNormalizedReals.SetNumUninitialized(Reals.Num());
+	OutNormalizedDuals.SetNumUninitialized(Duals.Num());
+	for (int32 Index = 0; Index < Reals.Num(); ++Index)
+	{
+		const FQuat4f& Real = Reals[Index];
+		const FQuat4f& Dual = Duals[Index];
+		OutNormalizedReals[Index] = FVector4f(Real.X, Real.Y, Real.Z, Real.W) * 0.5f + Half;
+		OutNormalizedDuals[Index] = FVector4f(Dual.X, Dual.Y, Dual.Z, Dual.W) * NormFactor + Half;
+	}
+}
+
+void FVATModelEditorToolkit::LogDualQuaternionError(const UStaticMesh* StaticMesh, const int32 LODIndex,
+	const TArray<VertexSkinWeightFour>& SkinWeights, const int32 NumBones,
+	const TArray<FQuat4f>& Reals, const TArray<FQuat4f>& Duals,
+	const TArray<FVector4f>& NormalizedReals, const TArray<FVector4f>& NormalizedDuals,
+	const FVector3f& MinBBox, const FVector3f& SizeBBox)
+{
+	TArray<FVector3f> Vertices;
+	TArray<FVector3f> Normals;
+	const int32 NumVertices = FVATSkeletalMeshUtilities::GetVertices(StaticMesh, LODIndex, Vertices, Normals);
+	if (NumVertices != SkinWeights.Num() || !NumBones)
+	{
+		return;
+	}
+
+	// Decode the values stored in 16 bit textures
+	auto Quantize = [](const FVector4f& Value)
+	{
+		return FVector4f(
+			FMath::RoundToFloat(FMath::Clamp(Value.X, 0.f, 1.f) * 65535.f),
+			FMath::RoundToFloat(FMath::Clamp(Value.Y, 0.f, 1.f) * 65535.f),
+			FMath::RoundToFloat(FMath::Clamp(Value.Z, 0.f, 1.f) * 65535.f),
+			FMath::RoundToFloat(FMath::Clamp(Value.W, 0.f, 1.f) * 65535.f)) / 65535.f;
+	};
+
+	const FVector4f One(1.f, 1.f, 1.f, 1.f);
+	TArray<FQuat4f> DecodedReals;
+	TArray<FQuat4f> DecodedDuals;
+	DecodedReals.SetNumUninitialized(Reals.Num());
+	DecodedDuals.SetNumUninitialized(Duals.Num());
+	for (int32 Index = 0; Index < Reals.Num(); ++Index)
+	{
+		const FVector4f Real = Quantize(NormalizedReals[Index]) * 2.f - One;
+		const FVector4f Dual = Quantize(NormalizedDuals[Index]) * SizeBBox.X + One * MinBBox.X;
+		DecodedReals[Index] = FQuat4f(Real.X, Real.Y, Real.Z, Real.W);
+		DecodedDuals[Index] = FQuat4f(Dual.X, Dual.Y, Dual.Z, Dual.W);
+	}
+
+	const int32 NumFrames = Reals.Num() / NumBones;
+	float MaxError = 0.f;
+	for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		const int32 Offset = Frame * NumBones;
+		for (int32 VertexIndex = 0; VertexIndex < NumVertices; ++VertexIndex)
+		{
+			FVector3f Normal;
+			const FVector3f Reference = FVATSkeletalMeshUtilities::DualQuaternionSkinning(Vertices[VertexIndex], Normals[VertexIndex],
+				MakeArrayView(&Reals[Offset], NumBones), MakeArrayView(&Duals[Offset], NumBones), SkinWeights[VertexIndex], Normal);
+			const FVector3f Decoded = FVATSkeletalMeshUtilities::DualQuaternionSkinning(Vertices[VertexIndex], Normals[VertexIndex],
+				MakeArrayView(&DecodedReals[Offset], NumBones), MakeArrayView(&DecodedDuals[Offset], NumBones), SkinWeights[VertexIndex], Normal);
+
+			MaxError = FMath::Max(MaxError, FVector3f::Distance(Reference, Decoded));
+		}
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("DualQuaternion Max Vertex Error: %f cm"), MaxError);
+}
+
+void FVATModelEditorToolkit::GetBoneResiduals(const TArray<FVector3f>& RestVertices, const TArray<FVector3f>& VertexDeltas,
+	const TArray<VertexSkinWeightFour>& SkinWeights,
+	const TArray<FVector3f>& Positions, const TArray<FVector4f>& Rotations,
+	const TArray<FQuat4f>& Reals, const TArray<FQuat4f>& Duals, const int32 NumBones, const int32 NumFrames,
+	TArray<FVector3f>& OutResiduals, TArray<float>& OutMaxResiduals)
+{
+	const int32 NumVertices = RestVertices.Num();
+	check(SkinWeights.Num() == NumVertices);
+	check(VertexDeltas.Num() == NumVertices * NumFrames);
+	check(Positions.Num() == NumBones * (NumFrames + 1) && Rotations.Num() == NumBones * (NumFrames + 1));
+
+	OutResiduals.SetNumUninitialized(NumVertices * NumFrames);
+	OutMaxResiduals.Init(0.f, NumVertices);
+
+	const bool bDualQuaternions = Reals.Num() == NumBones * NumFrames && Duals.Num() == NumBones * NumFrames;
+
+	TArray<FQuat4f> FrameRotations;
+	FrameRotations.SetNumUninitialized(NumBones);
+
+	for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		// Bone frames start after the RefPose
+		const int32 Offset = (Frame + 1) * NumBones;
+		for (int32 BoneIndex = 0; BoneIndex < NumBones; ++BoneIndex)
+		{
+			const FVector4f& Rotation = Rotations[Offset + BoneIndex];
+			FrameRotations[BoneIndex] = FQuat4f(FVector3f(Rotation).GetSafeNormal(UE_SMALL_NUMBER, FVector3f::ZAxisVector), Rotation.W);
+		}
+
+		for (int32 VertexIndex = 0; VertexIndex < NumVertices; ++VertexIndex)
+		{
+			const FVector3f& Position = RestVertices[VertexIndex];
+			const VertexSkinWeightFour& SkinWeight = SkinWeights[VertexIndex];
+
+			FVector3f Skinned = FVector3f::ZeroVector;
+			if (bDualQuaternions)
+			{
+				FVector3f Normal;
+				Skinned = FVATSkeletalMeshUtilities::DualQuaternionSkinning(Position, FVector3f::ZAxisVector,
+					MakeArrayView(&Reals[Frame * NumBones], NumBones), MakeArrayView(&Duals[Frame * NumBones], NumBones), SkinWeight, Normal);
+			}
+			else
+			{
+				// Linear blending, as VATSkinBones (and the blended matrices of the MatrixPalette encoding)
+				for (int32 Index = 0; Index < 4; ++Index)
+				{
+					const float Weight = (float)SkinWeight.BoneWeights[Index] / 255.f;
+					if (Weight <= 0.f)
+					{
+						break;
+					}
+
+					const int32 BoneIndex = SkinWeight.MeshBoneIndices[Index];
+					const FVector3f& RefPosition = Positions[BoneIndex];
+					Skinned += Weight * (FrameRotations[BoneIndex].RotateVector(Position - RefPosition) + RefPosition + Positions[Offset + BoneIndex]);
+				}
+			}
+
+			const FVector3f Residual = Position + VertexDeltas[Frame * NumVertices + VertexIndex] - Skinned;
+			OutResiduals[Frame * NumVertices + VertexIndex] = Residual;
+			OutMaxResiduals[VertexIndex] = FMath::Max(OutMaxResiduals[VertexIndex], Residual.Size());
+		}
+	}
+}
+
+bool FVATModelEditorToolkit::FindBestResolution(const int32 NumFrames, const int32 NumElements, int32& OutHeight,
+	int32& OutWidth, int32& OutRowsPerFrame, const int32 MaxHeight, const int32 MaxWidth, bool bEnforcePowerOfTwo, bool bMinimizePaddedSize)
+{
+	check(NumFrames > 0 && NumElements > 0);
+
+	// Search all Widths (or power of two Widths). RowsPerFrame and Height follow from the Width.
+	int64 BestCost = MAX_int64;
+	int64 BestTexels = MAX_int64;
+	bool bValidResolution = false;
+
+	for (int32 Width = bEnforcePowerOfTwo ? 2 : 1; Width <= MaxWidth; Width = bEnforcePowerOfTwo ? Width * 2 : Width + 1)
+	{
+		const int32 RowsPerFrame = FMath::DivideAndRoundUp(NumElements, Width);
+
+		// A narrower Width with the same RowsPerFrame has less padding
+		if (!bEnforcePowerOfTwo && Width > 1 && FMath::DivideAndRoundUp(NumElements, Width - 1) == RowsPerFrame)
+		{
+			continue;
+		}
+
+		int64 Height = (int64)NumFrames * RowsPerFrame;
+		if (bEnforcePowerOfTwo)
+		{
+			Height = (int64)FMath::RoundUpToPowerOfTwo64((uint64)FMath::Max<int64>(Height, 2));
+		}
+		if (Height > MaxHeight)
+		{
+			continue;
+		}
+
+		// Padded size approximates GPU allocations, which round each dimension up to a power of two.
+		const int64 Texels = Width * Height;
+		const int64 Cost = bMinimizePaddedSize ?
+			(int64)FMath::RoundUpToPowerOfTwo64(Width) * (int64)FMath::RoundUpToPowerOfTwo64(Height) : Texels;
+
+		// Ties are broken with the unpadded size and then with the most square texture
+		const bool bBetter = Cost < BestCost ||
+			(Cost == BestCost && (Texels < BestTexels ||
+				(Texels == BestTexels && FMath::Max<int64>(Width, Height) < FMath::Max(OutWidth, OutHeight))));
+
+		if (bBetter)
+		{
+			BestCost = Cost;
+			BestTexels = Texels;
+			OutWidth = Width;
+			OutHeight = (int32)Height;
+			OutRowsPerFrame = RowsPerFrame;
+			bValidResolution = true;
+		}
+	}
+
+	if (bValidResolution)
+	{
+		UE_LOG(LogTemp, Log, TEXT("Resolution: %ix%i RowsPerFrame: %i Fill Ratio: %.1f%%"), OutWidth, OutHeight, OutRowsPerFrame,
+			100.f * (float)((int64)NumFrames * NumElements) / (float)BestTexels);
+	}
+
+	return bValidResolution;
+}
+
+void FVATModelEditorToolkit::LogResolutionSweep()
+{
+	// Vertex counts of typical crowd meshes, and bone counts (+ virtual bones) of typical skeletons
+	const int32 VertexCounts[] = { 800, 2500, 5000, 9000, 13000, 20000 };
+	const int32 BoneCounts[] = { 24, 67, 100, 160, 250 };
+	const int32 FrameCounts[] = { 30, 120, 300, 600 };
+	const int32 MaxSize = 4096;
+
+	for (const bool bEnforcePowerOfTwo : { false, true })
+	{
+		int64 TotalLegacyTexels = 0;
+		int64 TotalTexels = 0;
+
+		auto Sweep = [&](const TCHAR* Label, const int32 NumElements, const int32 NumFrames)
+		{
+			// Legacy layout: smallest RowsPerFrame at the max Width
+			int32 LegacyWidth, LegacyHeight;
+			if (bEnforcePowerOfTwo)
+			{
+				LegacyWidth = 2;
+				while (LegacyWidth < NumElements && LegacyWidth < MaxSize) { LegacyWidth *= 2; }
+				LegacyHeight = (int32)FMath::RoundUpToPowerOfTwo(NumFrames * FMath::DivideAndRoundUp(NumElements, LegacyWidth));
+			}
+			else
+			{
+				const int32 LegacyRowsPerFrame = FMath::DivideAndRoundUp(NumElements, MaxSize);
+				LegacyWidth = FMath::DivideAndRoundUp(NumElements, LegacyRowsPerFrame);
+				LegacyHeight = NumFrames * LegacyRowsPerFrame;
+			}
+
+			int32 Width, Height, RowsPerFrame;
+			if (LegacyHeight > MaxSize || !FindBestResolution(NumFrames, NumElements, Height, Width, RowsPerFrame, MaxSize, MaxSize, bEnforcePowerOfTwo))
+			{
+				return;
+			}
+
+			const int64 LegacyTexels = (int64)LegacyWidth * LegacyHeight;
+			const int64 Texels = (int64)Width * Height;
+			TotalLegacyTexels += LegacyTexels;
+			TotalTexels += Texels;
+
+			// 8 bytes per texel (FHighPrecision)
+			UE_LOG(LogTemp, Log, TEXT("%s %i x %i Frames: %ix%i -> %ix%i (%lld bytes saved)"), Label, NumElements, NumFrames,
+				LegacyWidth, LegacyHeight, Width, Height, (LegacyTexels - Texels) * 8);
+		};
+
+		UE_LOG(LogTemp, Log, TEXT("Resolution Sweep. EnforcePowerOfTwo: %i"), bEnforcePowerOfTwo);
+		for (const int32 NumFrames : FrameCounts)
+		{
+			for (const int32 NumVertices : VertexCounts)
+			{
+				Sweep(TEXT("Vertices"), NumVertices, NumFrames);
+			}
+			for (const int32 NumBones : BoneCounts)
+			{
+				// Bone data stores the RefPose in the first frame
+				Sweep(TEXT("Bones"), NumBones, NumFrames + 1);
+			}
+		}
+		UE_LOG(LogTemp, Log, TEXT("Total: %lld -> %lld Texels (%lld bytes saved)"), TotalLegacyTexels, TotalTexels, (TotalLegacyTexels - TotalTexels) * 8);
+	}
+}
+
+static FAutoConsoleCommand ResolutionSweepCommand(
+	TEXT("FastVAT.ResolutionSweep"),
+	TEXT("Logs the VAT texture sizes of the resolution search against the legacy layout."),
+	FConsoleCommandDelegate::CreateStatic(&FVATModelEditorToolkit::LogResolutionSweep));
+
+bool FVATModelEditorToolkit::FindBestPagedResolution(const int32 NumFrames, const int32 NumElements, const TArray<int32>& FrameGroups, const int32 NumHeaderFrames,
+	int32& OutHeight, int32& OutWidth, int32& OutRowsPerFrame, TArray<FIntPoint>& OutFramePages, int32& OutNumPages,
+	const int32 MaxHeight, const int32 MaxWidth, bool bEnforcePowerOfTwo, bool bMinimizePaddedSize)
+{
+	// Pages stay within the platform limits
+	const int32 MaxDimension = (int32)GetMax2DTextureDimension();
+	const int32 PageMaxWidth = FMath::Min(MaxWidth, MaxDimension);
+	int32 PageMaxHeight = FMath::Min(MaxHeight, MaxDimension);
+	if (bEnforcePowerOfTwo)
+	{
+		PageMaxHeight = (int32)FMath::RoundDownToPowerOfTwo((uint32)PageMaxHeight);
+	}
+
+	// Find Page Width. A frame never spans two pages.
+	if (!FindBestResolution(1, NumElements, OutHeight, OutWidth, OutRowsPerFrame, PageMaxHeight, PageMaxWidth, bEnforcePowerOfTwo, bMinimizePaddedSize))
+	{
+		return false;
+	}
+
+	// Header frames are stored at the start of every page
+	const int32 FramesPerPage = PageMaxHeight / OutRowsPerFrame - NumHeaderFrames;
+	if (FramesPerPage <= 0)
+	{
+		return false;
+	}
 
-	// ---------------------------------------------------------------------------
-	// Normalize Bone Position.
-	// Basically we want all positions to be between [0, 1]
+	OutFramePages.SetNumUninitialized(NumFrames);
+	for (int32 Frame = 0; Frame < FMath::Min(NumHeaderFrames, NumFrames); Frame++)
+	{
+		OutFramePages[Frame] = FIntPoint(0, Frame);
+	}
 
-	// Compute Normalization Factor per-axis.
-	const FVector3f NormFactor = {
-		1.f / static_cast<float>(OutSizeBBox.X),
-		1.f / static_cast<float>(OutSizeBBox.Y),
-		1.f / static_cast<float>(OutSizeBBox.Z) };
+	// Runs of consecutive frames of the same group
+	TArray<FIntPoint> Runs;
+	for (int32 Frame = NumHeaderFrames; Frame < NumFrames; Frame++)
+	{
+		const bool bNewGroup = Frame > NumHeaderFrames && FrameGroups.IsValidIndex(Frame) && FrameGroups[Frame] != FrameGroups[Frame - 1];
+		if (Runs.IsEmpty() || bNewGroup)
+		{
+			Runs.Add(FIntPoint(Frame, 0));
+		}
+		Runs.Last().Y++;
+	}
 
-	OutNormalizedPositions.SetNumUninitialized(Positions.Num());
-	for (int32 Index = 0; Index < Positions.Num(); ++Index)
+	// Pages are sized to the largest run, so short runs don't pad every page to the page limit
+	int32 PageFrames = 0;
+	for (const FIntPoint& Run : Runs)
 	{
-		OutNormalizedPositions[Index] = (Positions[Index] - OutMinBBox) * NormFactor;
+		PageFrames = FMath::Max(PageFrames, Run.Y);
 	}
+	PageFrames = FMath::Min(PageFrames, FramesPerPage);
 
-	// ---------------------------------------------------------------------------
-	// Normalize Rotations
-	// And move them to [0, 1]
-	OutNormalizedRotations.SetNumUninitialized(Rotations.Num());
-	for (int32 Index = 0; Index < Rotations.Num(); ++Index)
+	// Fill Pages. Largest runs first, each into the first page with enough room.
+	// Runs larger than a page take consecutive new pages.
+	Runs.StableSort([](const FIntPoint& A, const FIntPoint& B) { return A.Y > B.Y; });
+
+	TArray<int32> PageUsage;
+	for (const FIntPoint& Run : Runs)
 	{
-		const FVector4f Axis = Rotations[Index];
-		const float Angle = Rotations[Index].W; // Angle are returned in radians and they go from [0-pi*2]
+		int32 Page = INDEX_NONE;
+		if (Run.Y <= PageFrames)
+		{
+			Page = PageUsage.IndexOfByPredicate([&Run, PageFrames](const int32 Usage) { return Usage + Run.Y <= PageFrames; });
+		}
+		if (Page == INDEX_NONE)
+		{
+			Page = PageUsage.Add(0);
+		}
 
-		OutNormalizedRotations[Index] = (Axis.GetSafeNormal() + FVector3f::OneVector) * 0.5f;
-		OutNormalizedRotations[Index].W = Angle / (PI * 2.f);
+		for (int32 Frame = Run.X; Frame < Run.X + Run.Y; Frame++)
+		{
+			if (PageUsage[Page] == PageFrames)
+			{
+				Page = PageUsage.Add(0);
+			}
+			OutFramePages[Frame] = FIntPoint(Page, NumHeaderFrames + PageUsage[Page]);
+			PageUsage[Page]++;
+		}
 	}
+	OutNumPages = FMath::Max(PageUsage.Num(), 1);
+
+	// Page Height fits the largest page. Texture2DArray slices share their dimensions.
+	const int32 TargetHeight = (NumHeaderFrames + PageFrames) * OutRowsPerFrame;
+	OutHeight = bEnforcePowerOfTwo ? (int32)FMath::RoundUpToPowerOfTwo((uint32)FMath::Max(TargetHeight, 2)) : TargetHeight;
+
+	UE_LOG(LogTemp, Log, TEXT("Paged Resolution: %ix%i Pages: %i"), OutWidth, OutHeight, OutNumPages);
+
+	return OutNumPages <= (int32)GetMaxTextureArrayLayers();
 }
 
-bool FVATModelEditorToolkit::FindBestResolution(const int32 NumFrames, const int32 NumElements, int32& OutHeight,
-	int32& OutWidth, int32& OutRowsPerFrame, const int32 MaxHeight, const int32 MaxWidth, bool bEnforcePowerOfTwo)
+void FVATModelEditorToolkit::SetAnimationPages(UVATModel* Model, const TArray<int32>& FrameGroups, const TArray<FIntPoint>& FramePages)
 {
-	if (bEnforcePowerOfTwo)
+	check(FrameGroups.Num() == FramePages.Num());
+
+	for (int32 AnimationIndex = 0; AnimationIndex < Model->Animations.Num(); AnimationIndex++)
 	{
-		OutWidth = 2;
-		while (OutWidth < NumElements && OutWidth < MaxWidth)
-		{
-			OutWidth *= 2;
-		}
-		OutRowsPerFrame = FMath::CeilToInt(NumElements / (float)OutWidth);
+		FVATAnimInfo& AnimInfo = Model->Animations[AnimationIndex];
+		int32 LastPage = INDEX_NONE;
+		AnimInfo.FirstPage = INDEX_NONE;
 
-		const int32 TargetHeight = NumFrames * OutRowsPerFrame;
-		OutHeight = 2;
-		while (OutHeight < TargetHeight)
+		for (int32 Frame = 0; Frame < FrameGroups.Num(); Frame++)
 		{
-			OutHeight *= 2;
+			if (FrameGroups[Frame] == AnimationIndex)
+			{
+				AnimInfo.FirstPage = AnimInfo.FirstPage == INDEX_NONE ? FramePages[Frame].X : AnimInfo.FirstPage;
+				LastPage = FramePages[Frame].X;
+			}
 		}
+
+		// Animations fully deduplicated into others have no pages
+		AnimInfo.FirstPage = FMath::Max(AnimInfo.FirstPage, 0);
+		AnimInfo.NumPages = LastPage != INDEX_NONE ? LastPage - AnimInfo.FirstPage + 1 : 0;
+
+		UE_LOG(LogTemp, Log, TEXT("Animation: %d Pages: %d - %d"), AnimationIndex, AnimInfo.FirstPage, AnimInfo.FirstPage + AnimInfo.NumPages - 1);
 	}
-	else
+}
+
+bool FVATModelEditorToolkit::WritePageTable(UVATModel* Model, const int32 LODIndex, const TArray<FIntPoint>& FramePages)
+{
+	int32 Height, Width, RowsPerFrame;
+	if (!FindBestResolution(1, FramePages.Num(),
+		Height, Width, RowsPerFrame,
+		Model->Settings->MaxHeight, Model->Settings->MaxWidth, Model->Settings->bEnforcePowerOfTwo, Model->Settings->bMinimizePaddedTextureSize))
 	{
-		OutRowsPerFrame = FMath::CeilToInt(NumElements / (float)MaxWidth);
-		OutWidth = FMath::CeilToInt(NumElements / (float)OutRowsPerFrame);
-		OutHeight = NumFrames * OutRowsPerFrame;
+		UE_LOG(LogTemp, Warning, TEXT("PageTable data cannot be fit in a %ix%i texture."), Model->Settings->MaxHeight, Model->Settings->MaxWidth);
+		return false;
 	}
 
-	const bool bValidResolution = OutWidth <= MaxWidth && OutHeight <= MaxHeight;
-	return bValidResolution;
+	TArray<FVector4f> PageTable;
+	PageTable.Reserve(FramePages.Num());
+	for (const FIntPoint& FramePage : FramePages)
+	{
+		PageTable.Add(FVector4f((float)FramePage.X, (float)FramePage.Y, 0.f, 0.f));
+	}
+
+	return FVATUtils::WriteVectorsToTexture<FVector4f, FFullPrecision>(PageTable, 1, RowsPerFrame, Height, Width, Model->GetPageTableTexture(LODIndex));
 }
 
 void FVATModelEditorToolkit::SetFullPrecisionUVs(UStaticMesh* StaticMesh, const int32 LODIndex, bool bFullPrecision)
@@ -1372,8 +3632,39 @@ void FVATModelEditorToolkit::SetBoundsExtensions(UStaticMesh* StaticMesh, const
 	StaticMesh->CalculateExtendedBounds();
 }
 
+bool FVATModelEditorToolkit::GetOptimizedVertexTexels(const TArray<int32>& Indices, const TArray<int32>& MeshIndices, const int32 NumVertices,
+	const int32 Width, const int32 RowsPerFrame, TArray<int32>& OutVertexTexels)
+{
+	OutVertexTexels.Reset();
+	if (!Indices.Num())
+	{
+		return false;
+	}
+
+	FVATVertexReorder::GetVertexTexels(Indices, NumVertices, Width, RowsPerFrame, TexelTileSize, OutVertexTexels);
+
+	// Cache Report. Vertices stored in order vs optimized, drawn in the mesh triangle order.
+	TArray<int32> IdentityTexels;
+	IdentityTexels.SetNumUninitialized(NumVertices);
+	for (int32 Vertex = 0; Vertex < NumVertices; Vertex++)
+	{
+		IdentityTexels[Vertex] = Vertex;
+	}
+
+	const int32 NumMissesBefore = FVATVertexReorder::SimulateTextureCacheMisses(MeshIndices, IdentityTexels, Width,
+		VertexCacheSize, TextureCacheLines, TextureCacheLineWidth, TextureCacheLineHeight);
+	const int32 NumMissesAfter = FVATVertexReorder::SimulateTextureCacheMisses(MeshIndices, OutVertexTexels, Width,
+		VertexCacheSize, TextureCacheLines, TextureCacheLineWidth, TextureCacheLineHeight);
+
+	UE_LOG(LogTemp, Log, TEXT("Vertex Order: %ix%i Texture Cache Misses: %d -> %d (%.1f%%)"), Width, RowsPerFrame,
+		NumMissesBefore, NumMissesAfter, NumMissesBefore ? 100.f * (float)NumMissesAfter / (float)NumMissesBefore : 100.f);
+
+	return true;
+}
+
 bool FVATModelEditorToolkit::CreateUVChannel(UStaticMesh* StaticMesh, const int32 LODIndex, const int32 UVChannelIndex,
-	const int32 Height, const int32 Width)
+	const int32 Height, const int32 Width, const TArray<int32>& VertexTexels, const TArray<int32>& SectionBones,
+	const TMap<int32, FVector2D>& VertexUVs)
 {
 	check(StaticMesh);
 
@@ -1389,18 +3680,8 @@ bool FVATModelEditorToolkit::CreateUVChannel(UStaticMesh* StaticMesh, const int3
 	check(MeshDescription);
 
 	// Add New UVChannel.
-	if (UVChannelIndex == StaticMesh->GetNumUVChannels(LODIndex))
-	{
-		if (!StaticMesh->InsertUVChannel(LODIndex, UVChannelIndex))
-		{
-			UE_LOG(LogTemp, Warning, TEXT("Unable to Add UVChannel"));
-			
-			return false;
-		}
-	}
-	else if (UVChannelIndex > StaticMesh->GetNumUVChannels(LODIndex))
+	if (!AddUVChannel(StaticMesh, LODIndex, UVChannelIndex))
 	{
-		UE_LOG(LogTemp, Warning, TEXT("UVChannel: %i Out of Range. Number of existing UVChannels: %i"), UVChannelIndex, StaticMesh->GetNumUVChannels(LODIndex));
 		return false;
 	}
 
@@ -1410,8 +3691,34 @@ bool FVATModelEditorToolkit::CreateUVChannel(UStaticMesh* StaticMesh, const int3
 
 	for (const FVertexInstanceID VertexInstanceID : MeshDescription->VertexInstances().GetElementIDs())
 	{
+		// Vertices addressing another texture
+		if (const FVector2D* VertexUV = VertexUVs.Find(MeshDescription->GetVertexInstanceVertex(VertexInstanceID).GetValue()))
+		{
+			TexCoords.Add(VertexInstanceID, *VertexUV);
+			continue;
+		}
+
+		// Rigid sections store the bone instead of the texel
+		if (SectionBones.Num())
+		{
+			const TArrayView<const FTriangleID> Triangles = MeshDescription->GetVertexInstanceConnectedTriangleIDs(VertexInstanceID);
+			const int32 SectionIndex = Triangles.Num() ? MeshDescription->GetTrianglePolygonGroup(Triangles[0]).GetValue() : INDEX_NONE;
+			if (SectionBones.IsValidIndex(SectionIndex) && SectionBones[SectionIndex] != INDEX_NONE)
+			{
+				TexCoords.Add(VertexInstanceID, FVector2D(SectionBones[SectionIndex], -1.f));
+				continue;
+			}
+		}
+
 		const FVertexID VertexID = MeshDescription->GetVertexInstanceVertex(VertexInstanceID);
-		const int32 VertexIndex = VertexID.GetValue();
+		const int32 VertexIndex = VertexTexels.Num() ? VertexTexels[VertexID.GetValue()] : VertexID.GetValue();
+
+		// Vertices without texels
+		if (VertexIndex == INDEX_NONE)
+		{
+			TexCoords.Add(VertexInstanceID, FVector2D(-1.f, -1.f));
+			continue;
+		}
 
 		// Instead
 		// 
@@ -1443,6 +3750,79 @@ bool FVATModelEditorToolkit::CreateUVChannel(UStaticMesh* StaticMesh, const int3
 	return false;
 }
 
+bool FVATModelEditorToolkit::AddUVChannel(UStaticMesh* StaticMesh, const int32 LODIndex, const int32 UVChannelIndex)
+{
+	check(StaticMesh);
+
+	if (UVChannelIndex == StaticMesh->GetNumUVChannels(LODIndex))
+	{
+		if (!StaticMesh->InsertUVChannel(LODIndex, UVChannelIndex))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Unable to Add UVChannel"));
+			
+			return false;
+		}
+	}
+	else if (UVChannelIndex > StaticMesh->GetNumUVChannels(LODIndex))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("UVChannel: %i Out of Range. Number of existing UVChannels: %i"), UVChannelIndex, StaticMesh->GetNumUVChannels(LODIndex));
+		return false;
+	}
+
+	return true;
+}
+
+bool FVATModelEditorToolkit::CreateSkinWeightUVChannels(UStaticMesh* StaticMesh, const int32 LODIndex, const int32 UVChannelIndex,
+	const TArray<VertexSkinWeightFour>& SkinWeights)
+{
+	check(StaticMesh);
+
+	if (!StaticMesh->IsSourceModelValid(LODIndex))
+	{
+		return false;
+	}
+
+	FMeshDescription* MeshDescription = StaticMesh->GetMeshDescription(LODIndex);
+	check(MeshDescription);
+
+	// Influences 0-1 and 2-3. Each UV component packs BoneIndex + BoneWeight / 256
+	TMap<FVertexInstanceID, FVector2D> TexCoords[2];
+
+	for (const FVertexInstanceID VertexInstanceID : MeshDescription->VertexInstances().GetElementIDs())
+	{
+		const FVertexID VertexID = MeshDescription->GetVertexInstanceVertex(VertexInstanceID);
+		const VertexSkinWeightFour& SkinWeight = SkinWeights[VertexID.GetValue()];
+
+		float Packed[4];
+		for (int32 Influence = 0; Influence < 4; Influence++)
+		{
+			Packed[Influence] = (float)SkinWeight.MeshBoneIndices[Influence] + (float)SkinWeight.BoneWeights[Influence] / 256.f;
+		}
+
+		TexCoords[0].Add(VertexInstanceID, FVector2D(Packed[0], Packed[1]));
+		TexCoords[1].Add(VertexInstanceID, FVector2D(Packed[2], Packed[3]));
+	}
+
+	// Set Full Precision UVs. Indices need more than 16 bit floats.
+	SetFullPrecisionUVs(StaticMesh, LODIndex, true);
+
+	for (int32 Channel = 0; Channel < 2; Channel++)
+	{
+		if (!AddUVChannel(StaticMesh, LODIndex, UVChannelIndex + Channel))
+		{
+			return false;
+		}
+
+		if (!StaticMesh->SetUVChannel(LODIndex, UVChannelIndex + Channel, TexCoords[Channel]))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Unable to Set UVChannel: %i. TexCoords: %i"), UVChannelIndex + Channel, TexCoords[Channel].Num());
+			return false;
+		}
+	}
+
+	return true;
+}
+
 void FVATModelEditorToolkit::ExecuteGenerateVAT()
 {
 	// TODO: start slow task, or should this be async
@@ -1528,6 +3908,10 @@ void FVATModelEditorToolkit::ExecuteGenerateVAT()
 	// Will duplicate these Material Instances per LOD
 	TMap<FString, UMaterialInstanceConstant*> SourceMatInstances;
 
+	// Layer shared by all the generated materials
+	UMaterialFunctionInterface* Layer = GetMaterialLayer();
+	check(Layer);
+
 	// All materials that are UMaterial* (not instances), must be converted to instances first.
 	int MaxIter = 500;
 	int CurIter = 0;
@@ -1584,20 +3968,6 @@ void FVATModelEditorToolkit::ExecuteGenerateVAT()
 				auto* MatAttrLayers = CreateMaterialExpression<UMaterialExpressionMaterialAttributeLayers>(CopiedMat, 650, 0);
 				check(MatAttrLayers);
 
-				// /AnimToTexture/Materials/ML_BoneAnimation.ML_BoneAnimation
-				// /AnimToTexture/Materials/ML_VertexAnimation.ML_VertexAnimation
-				FString MaterialLayerPath;
-				if(VATModel->Mode == EVATModelMode::Bone)
-				{
-					MaterialLayerPath = "/AnimToTexture/Materials/ML_BoneAnimation.ML_BoneAnimation";
-				}
-				else
-				{
-					MaterialLayerPath = "/AnimToTexture/Materials/ML_VertexAnimation.ML_VertexAnimation";
-				}
-				
-				UMaterialFunctionInterface* Layer = LoadObject<UMaterialFunctionMaterialLayer>(nullptr, *MaterialLayerPath);
-				
 				MatAttrLayers->DefaultLayers.Layers[0] = Layer;
 				MatAttrLayers->DefaultLayers.UnlinkLayerFromParent(0);
 				
@@ -1917,6 +4287,23 @@ void FVATModelEditorToolkit::ExecuteGenerateVAT()
 	VATModel->BoneRowsPerFrame.AddDefaulted(NumLODs);
 	VATModel->BoneWeightRowsPerFrame.AddDefaulted(NumLODs);
 	VATModel->VertexRowsPerFrame.AddDefaulted(NumLODs);
+	VATModel->BasisInfos.SetNum(NumLODs);
+	VATModel->DecompositionErrors.SetNum(NumLODs);
+	VATModel->NumKeyframes.SetNum(NumLODs);
+	VATModel->NumPages.Init(1, NumLODs);
+	VATModel->NumTemporalMips.Init(1, NumLODs);
+	VATModel->NumLODBones.Init(0, NumLODs);
+	VATModel->MaxNumInfluences.Init(4, NumLODs);
+	VATModel->NumResidualVertices.Init(0, NumLODs);
+	VATModel->NumStaticVertices.Init(0, NumLODs);
+	VATModel->NumVertexSectionVertices.Init(0, NumLODs);
+	VATModel->ResidualRowsPerFrame.Init(0, NumLODs);
+	VATModel->ResidualMinBBox.Init(FVector3f::ZeroVector, NumLODs);
+	VATModel->ResidualSizeBBox.Init(FVector3f::ZeroVector, NumLODs);
+	VATModel->VirtualBoneTransforms.Reset();
+	VATModel->VirtualBonePivots.Reset();
+	VATModel->DeduplicatedBytes = 0;
+	VATModel->AutoSampleSteps.Reset();
 	
 	// perform the AnimToTexture automation (fill data for the textures)
 	// per lod
@@ -1926,6 +4313,25 @@ void FVATModelEditorToolkit::ExecuteGenerateVAT()
 		AnimationToTexture(VATModel, i);
 	}
 
+	if (VATModel->Settings->bDeduplicateFrames)
+	{
+		UE_LOG(LogTemp, Log, TEXT("%s: Frame Deduplication saved %lld bytes"), *VATModel->GetName(), VATModel->DeduplicatedBytes);
+	}
+
+	// Pages are assigned with the first LOD and must survive the bake of the other LODs.
+	// Only deduplicated animations can be fully stored by others.
+	if (VATModel->Settings->UsesPagedTextures())
+	{
+		for (int32 AnimationIndex = 0; AnimationIndex < VATModel->Animations.Num(); AnimationIndex++)
+		{
+			const FVATAnimInfo& AnimInfo = VATModel->Animations[AnimationIndex];
+			if (AnimInfo.NumPages == 0 && AnimInfo.NumSharedFrames < AnimInfo.EndFrame - AnimInfo.StartFrame + 1)
+			{
+				UE_LOG(LogTemp, Warning, TEXT("%s: Animation %d has no pages after baking %d LODs"), *VATModel->GetName(), AnimationIndex, NumLODs);
+			}
+		}
+	}
+
 	// set material parameters
 
 	// LOD 0
@@ -1959,6 +4365,246 @@ void FVATModelEditorToolkit::ExecuteGenerateVAT()
 	}
 }
 
+UMaterialFunctionInterface* FVATModelEditorToolkit::GetMaterialLayer()
+{
+	// Stock layers can't remap frames, read pages, interleaved frames, static vertices, rigid sections, residuals, vertex sections or other bone encodings
+	if(VATModel->Settings->UsesFrameRemap() || VATModel->Settings->UsesPagedTextures() || VATModel->Settings->UsesInterleavedFrames() ||
+		VATModel->Settings->bTemporalMips || (VATModel->Settings->bSkipStaticVertices && VATModel->Mode == EVATModelMode::Vertex) ||
+		((VATModel->Settings->bIntegerBoneIndices || VATModel->Settings->bSkinWeightsInUVs || VATModel->Settings->UsesRigidSections() ||
+			VATModel->Settings->bBakeResiduals || VATModel->Settings->UsesVertexSections() ||
+			VATModel->Settings->BoneEncoding != EVATBoneEncoding::AxisAngle) &&
+			VATModel->Mode != EVATModelMode::Vertex && VATModel->Mode != EVATModelMode::CompressedVertex))
+	{
+		return CreateMaterialLayer();
+	}
+
+	// /AnimToTexture/Materials/ML_BoneAnimation.ML_BoneAnimation
+	// /AnimToTexture/Materials/ML_VertexAnimation.ML_VertexAnimation
+	if(VATModel->Mode == EVATModelMode::Bone || VATModel->Mode == EVATModelMode::SkinningDecomposition)
+	{
+		return LoadObject<UMaterialFunctionMaterialLayer>(nullptr, TEXT("/AnimToTexture/Materials/ML_BoneAnimation.ML_BoneAnimation"));
+	}
+	else if(VATModel->Mode == EVATModelMode::Vertex)
+	{
+		return LoadObject<UMaterialFunctionMaterialLayer>(nullptr, TEXT("/AnimToTexture/Materials/ML_VertexAnimation.ML_VertexAnimation"));
+	}
+
+	return CreateMaterialLayer();
+}
+
+UMaterialFunctionMaterialLayer* FVATModelEditorToolkit::CreateMaterialLayer()
+{
+	FVATMaterialLayerBuilder Builder(FString::Printf(TEXT("FastVAT %s Layer"), *UEnum::GetDisplayValueAsText(VATModel->Mode).ToString()));
+
+	// Common Inputs
+	Builder.AddInclude(TEXT("/Plugin/FastVAT/Private/VATCommon.ush"));
+	Builder.AddTexCoord(TEXT("VertexUV"), VATModel->UVChannel);
+	Builder.AddTime(TEXT("Time"));
+	Builder.AddStaticSwitchParameter(VATParamNames::AutoPlay, true);
+	Builder.AddScalarParameter(VATParamNames::Frame);
+	Builder.AddScalarParameter(VATParamNames::StartFrame);
+	Builder.AddScalarParameter(VATParamNames::EndFrame);
+	Builder.AddScalarParameter(VATParamNames::NumFrames, 1.f);
+	Builder.AddScalarParameter(VATParamNames::SampleRate, 30.f);
+	Builder.AddScalarParameter(VATParamNames::RowsPerFrame, 1.f);
+	Builder.AddVectorParameter(VATParamNames::MinBBox);
+	Builder.AddVectorParameter(VATParamNames::SizeBBox);
+
+	Builder.AddCode(TEXT("int Frame0, Frame1;"));
+	Builder.AddCode(TEXT("float Alpha;"));
+	Builder.AddCode(TEXT("VATGetFrames(Time, AutoPlay, Frame, StartFrame, EndFrame, NumFrames, SampleRate, Frame0, Frame1, Alpha);"));
+
+	// Frame Remap
+	if (VATModel->Settings->UsesFrameRemap())
+	{
+		Builder.AddTextureParameter(VATParamNames::FrameRemapTexture, VATModel->GetFrameRemapTexture(0));
+		Builder.AddCode(TEXT("VATRemapFrames(FrameRemapTexture, Frame0, Frame1, Alpha);"));
+	}
+
+	// Paged Textures. Frame textures are Texture2DArrays and a PageTable is passed to the shader functions.
+	const bool bPaged = VATModel->Settings->UsesPagedTextures();
+	if (bPaged)
+	{
+		Builder.AddDefine(TEXT("VAT_PAGED"), TEXT("1"));
+		Builder.AddTextureParameter(VATParamNames::PageTableTexture, VATModel->GetPageTableTexture(0));
+	}
+
+	if (VATModel->Mode == EVATModelMode::Vertex)
+	{
+		Builder.AddInclude(TEXT("/Plugin/FastVAT/Private/VATVertex.ush"));
+
+		// Static vertices have no texels and stay at rest
+		if (VATModel->Settings->bSkipStaticVertices)
+		{
+			Builder.AddLocalNormal(TEXT("LocalNormal"));
+			Builder.AddCode(TEXT("if (VATIsStaticVertex(VertexUV))"));
+			Builder.AddCode(TEXT("{"));
+			Builder.AddCode(TEXT("	Normal = LocalNormal;"));
+			Builder.AddCode(TEXT("	return 0.0f;"));
+			Builder.AddCode(TEXT("}"));
+		}
+
+		if (bPaged)
+		{
+			Builder.AddTextureParameter(VATParamNames::VertexPositionTexture, VATModel->GetVertexPositionPageTexture(0));
+			Builder.AddTextureParameter(VATParamNames::VertexNormalTexture, VATModel->GetVertexNormalPageTexture(0));
+		}
+		else
+		{
+			Builder.AddTextureParameter(VATParamNames::VertexPositionTexture, VATModel->GetVertexPositionTexture(0));
+			Builder.AddTextureParameter(VATParamNames::VertexNormalTexture, VATModel->GetVertexNormalTexture(0));
+		}
+
+		// Interleaved frames are blended with a single bilinear sample
+		if (VATModel->Settings->UsesInterleavedFrames())
+		{
+			Builder.AddScalarParameter(VATParamNames::NumStoredFrames, 1.f);
+			Builder.AddCode(TEXT("return VATVertexInterleaved(PositionTexture, PositionTextureSampler, NormalTexture, NormalTextureSampler,"));
+			Builder.AddCode(TEXT("	VertexUV, Frame0, Frame1, Alpha, RowsPerFrame, NumStoredFrames, MinBBox.xyz, SizeBBox.xyz, Normal);"));
+		}
+		// Temporal mip level is selected by camera distance
+		else if (VATModel->Settings->bTemporalMips)
+		{
+			Builder.AddCameraDistance(TEXT("CameraDistance"));
+			Builder.AddScalarParameter(VATParamNames::NumStoredFrames, 1.f);
+			Builder.AddScalarParameter(VATParamNames::NumTemporalMips, 1.f);
+			Builder.AddScalarParameter(VATParamNames::TemporalMipDistance, VATModel->Settings->TemporalMipDistance);
+			Builder.AddCode(TEXT("const float Level = VATGetTemporalMipLevel(CameraDistance, TemporalMipDistance, NumTemporalMips);"));
+			Builder.AddCode(TEXT("return VATVertexTemporalMip(PositionTexture, NormalTexture, VertexUV, Frame0, Frame1, Alpha, StartFrame, EndFrame,"));
+			Builder.AddCode(TEXT("	RowsPerFrame, NumStoredFrames, Level, MinBBox.xyz, SizeBBox.xyz, Normal);"));
+		}
+		else
+		{
+			Builder.AddCode(TEXT("return VATVertex(PositionTexture, NormalTexture, VAT_PAGE_TABLE_ARG VertexUV, Frame0, Frame1, Alpha,"));
+			Builder.AddCode(TEXT("	RowsPerFrame, MinBBox.xyz, SizeBBox.xyz, Normal);"));
+		}
+	}
+	else if (VATModel->Mode == EVATModelMode::Bone || VATModel->Mode == EVATModelMode::SkinningDecomposition)
+	{
+		Builder.AddInclude(TEXT("/Plugin/FastVAT/Private/VATBone.ush"));
+		Builder.AddLocalPosition(TEXT("LocalPosition"));
+		Builder.AddLocalNormal(TEXT("LocalNormal"));
+		const EVATBoneEncoding BoneEncoding = VATModel->Settings->BoneEncoding;
+		if (BoneEncoding == EVATBoneEncoding::MatrixPalette)
+		{
+			Builder.AddTextureParameter(VATParamNames::BoneMatrixTexture, VATModel->GetBoneMatrixTexture());
+		}
+		else if (BoneEncoding == EVATBoneEncoding::DualQuaternion)
+		{
+			Builder.AddTextureParameter(VATParamNames::BoneRealTexture, VATModel->GetBoneRealTexture());
+			Builder.AddTextureParameter(VATParamNames::BoneDualTexture, VATModel->GetBoneDualTexture());
+		}
+		else if (bPaged)
+		{
+			Builder.AddTextureParameter(VATParamNames::BonePositionTexture, VATModel->GetBonePositionPageTexture());
+			Builder.AddTextureParameter(VATParamNames::BoneRotationTexture, VATModel->GetBoneRotationPageTexture());
+		}
+		else
+		{
+			Builder.AddTextureParameter(VATParamNames::BonePositionTexture, VATModel->GetBonePositionTexture());
+			Builder.AddTextureParameter(VATParamNames::BoneRotationTexture, VATModel->GetBoneRotationTexture());
+		}
+		Builder.AddScalarParameter(VATParamNames::NumBones, 1.f);
+		Builder.AddStaticSwitchParameter(VATParamNames::UseTwoInfluences, false);
+		Builder.AddStaticSwitchParameter(VATParamNames::UseFourInfluences, true);
+		// Vertex Sections read the Vertex textures and skip skinning. Sections are drawn separately, so the branch is uniform
+		if (VATModel->Settings->UsesVertexSections() && VATModel->Mode == EVATModelMode::Bone)
+		{
+			Builder.AddInclude(TEXT("/Plugin/FastVAT/Private/VATVertex.ush"));
+			Builder.AddTextureParameter(VATParamNames::VertexPositionTexture, VATModel->GetVertexPositionTexture(0));
+			Builder.AddTextureParameter(VATParamNames::VertexNormalTexture, VATModel->GetVertexNormalTexture(0));
+			Builder.AddVectorParameter(VATParamNames::VertexMinBBox);
+			Builder.AddVectorParameter(VATParamNames::VertexSizeBBox);
+			Builder.AddScalarParameter(VATParamNames::VertexRowsPerFrame, 1.f);
+			Builder.AddCode(TEXT("BRANCH"));
+			Builder.AddCode(TEXT("if (VATIsVertexSection(VertexUV))"));
+			Builder.AddCode(TEXT("{"));
+			Builder.AddCode(TEXT("	return VATVertex(PositionTexture, NormalTexture, VAT_PAGE_TABLE_ARG float2(-VertexUV.x, VertexUV.y), Frame0, Frame1, Alpha,"));
+			Builder.AddCode(TEXT("		VertexRowsPerFrame, VertexMinBBox.xyz, VertexSizeBBox.xyz, Normal);"));
+			Builder.AddCode(TEXT("}"));
+		}
+
+		Builder.AddCode(TEXT("const float NumInfluences = UseFourInfluences > 0.5f ? 4.0f : (UseTwoInfluences > 0.5f ? 2.0f : 1.0f);"));
+		Builder.AddCode(TEXT("int4 Bones;"));
+		Builder.AddCode(TEXT("float4 Weights;"));
+
+		// Skin Weights packed in the VAT UVChannel (influences 0-1) and the next one (influences 2-3)
+		if (VATModel->Settings->bSkinWeightsInUVs)
+		{
+			Builder.AddTexCoord(TEXT("SkinWeightsUV"), VATModel->UVChannel + 1);
+			Builder.AddCode(TEXT("VATUnpackSkinWeights(float4(VertexUV, SkinWeightsUV), Bones, Weights);"));
+		}
+		// Rigid Binding follows the only baked bone
+		else if (VATModel->Settings->UsesSocketBinding())
+		{
+			Builder.AddCode(TEXT("Bones = 0;"));
+			Builder.AddCode(TEXT("Weights = float4(1.0f, 0.0f, 0.0f, 0.0f);"));
+		}
+		else
+		{
+			if (VATModel->Settings->UsesRigidSections())
+			{
+				Builder.AddDefine(TEXT("VAT_RIGID_SECTIONS"), TEXT("1"));
+			}
+			Builder.AddTextureParameter(VATParamNames::BoneWeightsTexture, VATModel->GetBoneWeightTexture(0));
+			Builder.AddScalarParameter(VATParamNames::BoneWeightRowsPerFrame, 1.f);
+			if (VATModel->Settings->bIntegerBoneIndices)
+			{
+				Builder.AddDefine(TEXT("VAT_INTEGER_BONE_INDICES"), TEXT("1"));
+				Builder.AddTextureParameter(VATParamNames::BoneIndicesTexture, VATModel->GetBoneIndexTexture(0));
+			}
+			Builder.AddCode(TEXT("VATGetSkinWeights(BoneWeightsTexture, VAT_BONE_INDICES_ARG VertexUV, NumBones, BoneWeightsRowsPerFrame, Bones, Weights);"));
+		}
+
+		// Hybrid Bone Mode adds the residuals on top of the skinned offset
+		const bool bResiduals = VATModel->Settings->bBakeResiduals && VATModel->Mode == EVATModelMode::Bone;
+		const FString Result = bResiduals ? TEXT("const float3 Offset = ") : TEXT("return ");
+
+		// Bone matrices are blended and applied without trigonometry
+		if (BoneEncoding == EVATBoneEncoding::MatrixPalette)
+		{
+			Builder.AddCode(Result + TEXT("VATBoneMatrixSkinned(BoneMatrixTexture, Bones, Weights, LocalPosition, LocalNormal,"));
+			Builder.AddCode(TEXT("	Frame0, Frame1, Alpha, NumInfluences, RowsPerFrame, MinBBox.xyz, SizeBBox.xyz, Normal) - LocalPosition;"));
+		}
+		// Dual Quaternions are blended and normalized, preserving volume
+		else if (BoneEncoding == EVATBoneEncoding::DualQuaternion)
+		{
+			Builder.AddCode(Result + TEXT("VATBoneDualQuatSkinned(BoneRealTexture, BoneDualTexture, Bones, Weights, LocalPosition, LocalNormal,"));
+			Builder.AddCode(TEXT("	Frame0, Frame1, Alpha, NumInfluences, RowsPerFrame, MinBBox.xyz, SizeBBox.xyz, Normal) - LocalPosition;"));
+		}
+		else
+		{
+			Builder.AddCode(Result + TEXT("VATBoneSkinned(BonePositionTexture, BoneRotationTexture, VAT_PAGE_TABLE_ARG Bones, Weights, LocalPosition, LocalNormal,"));
+			Builder.AddCode(TEXT("	Frame0, Frame1, Alpha, NumInfluences, RowsPerFrame, MinBBox.xyz, SizeBBox.xyz, Normal) - LocalPosition;"));
+		}
+
+		if (bResiduals)
+		{
+			Builder.AddTextureParameter(VATParamNames::ResidualTexture, VATModel->GetResidualTexture(0));
+			Builder.AddTextureParameter(VATParamNames::ResidualIndexTexture, VATModel->GetResidualIndexTexture(0));
+			Builder.AddVectorParameter(VATParamNames::ResidualMinBBox);
+			Builder.AddVectorParameter(VATParamNames::ResidualSizeBBox);
+			Builder.AddScalarParameter(VATParamNames::ResidualRowsPerFrame, 1.f);
+			Builder.AddCode(TEXT("return Offset + VATGetResidual(ResidualTexture, ResidualIndexTexture, BoneWeightsTexture, VertexUV, Frame0, Frame1, Alpha,"));
+			Builder.AddCode(TEXT("	ResidualRowsPerFrame, ResidualMinBBox.xyz, ResidualSizeBBox.xyz);"));
+		}
+	}
+	else if (VATModel->Mode == EVATModelMode::CompressedVertex)
+	{
+		Builder.AddInclude(TEXT("/Plugin/FastVAT/Private/VATCompressedVertex.ush"));
+		Builder.AddTextureParameter(VATParamNames::BasisTexture, VATModel->GetVertexBasisTexture(0));
+		Builder.AddTextureParameter(VATParamNames::NormalBasisTexture, VATModel->GetVertexNormalBasisTexture(0));
+		Builder.AddTextureParameter(VATParamNames::CoefficientTexture, VATModel->GetVertexCoefficientTexture(0));
+		Builder.AddTextureParameter(VATParamNames::BasisRangeTexture, VATModel->GetVertexBasisRangeTexture(0));
+		Builder.AddScalarParameter(VATParamNames::NumBasis);
+
+		Builder.AddCode(TEXT("return VATCompressedVertex(BasisTexture, NormalBasisTexture, CoefficientTexture, BasisRangeTexture,"));
+		Builder.AddCode(TEXT("	VertexUV, Frame0, Frame1, Alpha, NumBasis, RowsPerFrame, Normal);"));
+	}
+
+	return Builder.Build(GetOutDirectoryPath(), "ML_VAT_" + VATModel.GetName());
+}
+
 template <typename T>
 T* FVATModelEditorToolkit::CreateMaterialExpression(UMaterial* Material, int32 NodePosX, int32 NodePosY)
 {
@@ -1,6 +1,7 @@
 ﻿#include "VATSkeletalMeshUtilities.h"
 
 #include "MeshDescription.h"
+#include "Algo/Sort.h"
 #include "StaticMeshAttributes.h"
 #include "Rendering/SkeletalMeshLODRenderData.h"
 #include "Rendering/SkeletalMeshRenderData.h"
@@ -339,6 +340,92 @@ void FVATSkeletalMeshUtilities::ReduceSkinWeights(const TArray<VertexSkinWeightM
 	}
 }
 
+void FVATSkeletalMeshUtilities::PruneSkinWeights(TArray<VertexSkinWeightFour>& InOutSkinWeights, const float Threshold)
+{
+	const int32 MinWeight = FMath::Max(FMath::RoundToInt(Threshold * 255.f), 1);
+
+	for (VertexSkinWeightFour& SkinWeight : InOutSkinWeights)
+	{
+		// Merge repeated bones
+		TStaticArray<int32, 4> Weights;
+		for (int32 Index = 0; Index < 4; Index++)
+		{
+			Weights[Index] = SkinWeight.BoneWeights[Index];
+			for (int32 Other = 0; Other < Index; Other++)
+			{
+				if (Weights[Other] > 0 && SkinWeight.MeshBoneIndices[Other] == SkinWeight.MeshBoneIndices[Index])
+				{
+					Weights[Other] += Weights[Index];
+					Weights[Index] = 0;
+					break;
+				}
+			}
+		}
+
+		// Sort by descending weight
+		TStaticArray<int32, 4> Order;
+		for (int32 Index = 0; Index < 4; Index++)
+		{
+			Order[Index] = Index;
+		}
+		Algo::Sort(Order, [&Weights](const int32 A, const int32 B) { return Weights[A] > Weights[B]; });
+
+		// Drop light influences. The heaviest one is always kept
+		int32 TotalWeight = 0;
+		int32 NumInfluences = 0;
+		for (int32 Index = 0; Index < 4; Index++)
+		{
+			if (Index == 0 || Weights[Order[Index]] >= MinWeight)
+			{
+				TotalWeight += Weights[Order[Index]];
+				NumInfluences++;
+			}
+		}
+
+		// Renormalize. Rounding is added to the heaviest influence
+		VertexSkinWeightFour Pruned;
+		for (int32 Index = 0; Index < 4; Index++)
+		{
+			Pruned.MeshBoneIndices[Index] = 0;
+			Pruned.BoneWeights[Index] = 0;
+		}
+
+		int32 NormalizedWeight = 0;
+		for (int32 Index = 0; Index < NumInfluences; Index++)
+		{
+			Pruned.MeshBoneIndices[Index] = SkinWeight.MeshBoneIndices[Order[Index]];
+			Pruned.BoneWeights[Index] = TotalWeight > 0 ? (uint8)FMath::RoundToInt(255.f * Weights[Order[Index]] / TotalWeight) : 255;
+			NormalizedWeight += Pruned.BoneWeights[Index];
+		}
+		Pruned.BoneWeights[0] = (uint8)FMath::Clamp(Pruned.BoneWeights[0] + 255 - NormalizedWeight, 0, 255);
+
+		SkinWeight = Pruned;
+	}
+}
+
+float FVATSkeletalMeshUtilities::GetAverageNumInfluences(const TArray<VertexSkinWeightFour>& SkinWeights, int32& OutMaxNumInfluences)
+{
+	OutMaxNumInfluences = 0;
+	if (!SkinWeights.Num())
+	{
+		return 0.f;
+	}
+
+	int32 TotalNumInfluences = 0;
+	for (const VertexSkinWeightFour& SkinWeight : SkinWeights)
+	{
+		int32 NumInfluences = 0;
+		for (int32 Index = 0; Index < 4; Index++)
+		{
+			NumInfluences += SkinWeight.BoneWeights[Index] > 0 ? 1 : 0;
+		}
+		TotalNumInfluences += NumInfluences;
+		OutMaxNumInfluences = FMath::Max(OutMaxNumInfluences, NumInfluences);
+	}
+
+	return (float)TotalNumInfluences / (float)SkinWeights.Num();
+}
+
 void FVATSkeletalMeshUtilities::GetSkinnedVertices(const USkeletalMeshComponent* SkeletalMeshComponent, const int32 LODIndex,
 	TArray<FVector3f>& OutPositions)
 {
@@ -579,3 +666,53 @@ void FVATSkeletalMeshUtilities::DecomposeTransformations(const TArray<FTransform
 	}
 };
 
+void FVATSkeletalMeshUtilities::GetDualQuaternion(const FQuat4f& Rotation, const FVector3f& Translation,
+	FQuat4f& OutReal, FQuat4f& OutDual)
+{
+	OutReal = Rotation;
+
+	// Dual = 0.5 * Translation * Real
+	OutDual = FQuat4f(Translation.X, Translation.Y, Translation.Z, 0.f) * Rotation * 0.5f;
+}
+
+FVector3f FVATSkeletalMeshUtilities::DualQuaternionSkinning(const FVector3f& Position, const FVector3f& Normal,
+	TConstArrayView<FQuat4f> Reals, TConstArrayView<FQuat4f> Duals, const VertexSkinWeightFour& SkinWeight,
+	FVector3f& OutNormal)
+{
+	check(Reals.Num() == Duals.Num());
+
+	FQuat4f Real(0.f, 0.f, 0.f, 0.f);
+	FQuat4f Dual(0.f, 0.f, 0.f, 0.f);
+
+	for (int32 Index = 0; Index < 4; ++Index)
+	{
+		const float Weight = SkinWeight.BoneWeights[Index] / 255.f;
+		if (Weight > 0.f)
+		{
+			const int32 BoneIndex = SkinWeight.MeshBoneIndices[Index];
+
+			// q and -q are the same rotation. Blend along the shortest path
+			const float SignedWeight = (Real | Reals[BoneIndex]) < 0.f ? -Weight : Weight;
+			Real = Real + Reals[BoneIndex] * SignedWeight;
+			Dual = Dual + Duals[BoneIndex] * SignedWeight;
+		}
+	}
+
+	const float Length = Real.Size();
+	if (Length < UE_SMALL_NUMBER)
+	{
+		OutNormal = Normal;
+		return Position;
+	}
+
+	Real = Real * (1.f / Length);
+	Dual = Dual * (1.f / Length);
+
+	// Translation = 2 * Dual * Conjugate(Real)
+	const FVector3f RealVector(Real.X, Real.Y, Real.Z);
+	const FVector3f DualVector(Dual.X, Dual.Y, Dual.Z);
+	const FVector3f Translation = 2.f * (Real.W * DualVector - Dual.W * RealVector + FVector3f::CrossProduct(RealVector, DualVector));
+
+	OutNormal = Real.RotateVector(Normal);
+	return Real.RotateVector(Position) + Translation;
+}
@@ -0,0 +1,611 @@
+﻿#include "VATSkinningDecomposition.h"
+
+#include "VATCompressionUtilities.h"
+#include "Async/ParallelFor.h"
+
+namespace
+{
+	// Max number of frames used for clustering vertex trajectories
+	constexpr int32 MaxClusterFrames = 32;
+	constexpr int32 NumClusterIterations = 10;
+
+	float GetWeight(const VertexSkinWeightFour& SkinWeight, const int32 Index)
+	{
+		return (float)SkinWeight.BoneWeights[Index] / 255.f;
+	}
+
+	// Quantizes normalized weights to uint8, keeping the sum at 255
+	void QuantizeWeights(const TStaticArray<float, 4>& Weights, const TStaticArray<uint16, 4>& Indices, VertexSkinWeightFour& OutSkinWeight)
+	{
+		int32 Total = 0;
+		int32 MaxIndex = 0;
+		for (int32 Index = 0; Index < 4; Index++)
+		{
+			OutSkinWeight.BoneWeights[Index] = (uint8)FMath::Clamp(FMath::RoundToInt(Weights[Index] * 255.f), 0, 255);
+			OutSkinWeight.MeshBoneIndices[Index] = Indices[Index];
+			Total += OutSkinWeight.BoneWeights[Index];
+			MaxIndex = Weights[Index] > Weights[MaxIndex] ? Index : MaxIndex;
+		}
+
+		// Rounding error goes to the largest influence
+		OutSkinWeight.BoneWeights[MaxIndex] = (uint8)FMath::Clamp((int32)OutSkinWeight.BoneWeights[MaxIndex] + 255 - Total, 0, 255);
+	}
+
+	// Solves A * X = B in place with Gaussian elimination (partial pivoting). Returns false if singular
+	bool SolveLinearSystem(TArray<double>& A, TArray<double>& B, const int32 N)
+	{
+		for (int32 Column = 0; Column < N; Column++)
+		{
+			int32 Pivot = Column;
+			for (int32 Row = Column + 1; Row < N; Row++)
+			{
+				if (FMath::Abs(A[Row * N + Column]) > FMath::Abs(A[Pivot * N + Column]))
+				{
+					Pivot = Row;
+				}
+			}
+
+			if (FMath::Abs(A[Pivot * N + Column]) < 1e-12)
+			{
+				return false;
+			}
+
+			if (Pivot != Column)
+			{
+				for (int32 Index = 0; Index < N; Index++)
+				{
+					Swap(A[Pivot * N + Index], A[Column * N + Index]);
+				}
+				Swap(B[Pivot], B[Column]);
+			}
+
+			for (int32 Row = Column + 1; Row < N; Row++)
+			{
+				const double Factor = A[Row * N + Column] / A[Column * N + Column];
+				for (int32 Index = Column; Index < N; Index++)
+				{
+					A[Row * N + Index] -= Factor * A[Column * N + Index];
+				}
+				B[Row] -= Factor * B[Column];
+			}
+		}
+
+		for (int32 Row = N - 1; Row >= 0; Row--)
+		{
+			double Sum = B[Row];
+			for (int32 Index = Row + 1; Index < N; Index++)
+			{
+				Sum -= A[Row * N + Index] * B[Index];
+			}
+			B[Row] = Sum / A[Row * N + Row];
+		}
+
+		return true;
+	}
+
+	// Weighted Rigid Fit (Horn's quaternion method). 
+	// Returns the transform that best maps Sources to Targets.
+	FTransform3f FitRigidTransform(const FVector3f& SourceCentroid, const FVector3f& TargetCentroid, const FMatrix44f& Covariance)
+	{
+		// Covariance(a, b) = Sum(Weight * (Source_a - SourceCentroid_a) * (Target_b - TargetCentroid_b))
+		const double Sxx = Covariance.M[0][0], Sxy = Covariance.M[0][1], Sxz = Covariance.M[0][2];
+		const double Syx = Covariance.M[1][0], Syy = Covariance.M[1][1], Syz = Covariance.M[1][2];
+		const double Szx = Covariance.M[2][0], Szy = Covariance.M[2][1], Szz = Covariance.M[2][2];
+
+		const TArray<double> N = {
+			Sxx + Syy + Szz, Syz - Szy,        Szx - Sxz,        Sxy - Syx,
+			Syz - Szy,       Sxx - Syy - Szz,  Sxy + Syx,        Szx + Sxz,
+			Szx - Sxz,       Sxy + Syx,       -Sxx + Syy - Szz,  Syz + Szy,
+			Sxy - Syx,       Szx + Sxz,        Syz + Szy,       -Sxx - Syy + Szz };
+
+		TArray<double> EigenValues;
+		TArray<double> EigenVectors;
+		FVATCompressionUtilities::SymmetricEigenDecomposition(N, 4, EigenValues, EigenVectors);
+
+		// Largest EigenVector is the rotation (W, X, Y, Z)
+		FQuat4f Rotation((float)EigenVectors[1 * 4], (float)EigenVectors[2 * 4], (float)EigenVectors[3 * 4], (float)EigenVectors[0]);
+		if (Rotation.SizeSquared() < UE_SMALL_NUMBER)
+		{
+			Rotation = FQuat4f::Identity;
+		}
+		Rotation.Normalize();
+
+		const FVector3f Translation = TargetCentroid - Rotation.RotateVector(SourceCentroid);
+		return FTransform3f(Rotation, Translation);
+	}
+}
+
+float FVATSkinningDecomposition::Decompose(const TArray<FVector3f>& RestVertices, const TArray<FVector3f>& Deltas,
+	const int32 NumFrames, const int32 NumBones, const int32 NumInfluences,
+	const float ErrorTolerance, const int32 MaxIterations,
+	TArray<FTransform3f>& OutTransforms, TArray<VertexSkinWeightFour>& OutSkinWeights)
+{
+	const int32 NumVertices = RestVertices.Num();
+	check(Deltas.Num() == NumFrames * NumVertices);
+	check(NumBones > 0 && NumBones <= TNumericLimits<uint16>::Max());
+
+	// Rigid clusters, each vertex fully bound to a single bone
+	InitializeClusters(RestVertices, Deltas, NumFrames, NumBones, OutSkinWeights);
+
+	OutTransforms.Init(FTransform3f::Identity, NumFrames * NumBones);
+	SolveTransforms(RestVertices, Deltas, NumFrames, NumBones, OutSkinWeights, OutTransforms);
+
+	float Error = ComputeError(RestVertices, Deltas, NumFrames, NumBones, OutTransforms, OutSkinWeights);
+	UE_LOG(LogTemp, Log, TEXT("Skinning Decomposition. Initial RMS Error: %f"), Error);
+
+	// Alternate between Weights and Transforms
+	for (int32 Iteration = 0; Iteration < MaxIterations && Error > ErrorTolerance; Iteration++)
+	{
+		SolveSkinWeights(RestVertices, Deltas, NumFrames, NumBones, NumInfluences, OutTransforms, OutSkinWeights);
+		SolveTransforms(RestVertices, Deltas, NumFrames, NumBones, OutSkinWeights, OutTransforms);
+
+		const float PreviousError = Error;
+		Error = ComputeError(RestVertices, Deltas, NumFrames, NumBones, OutTransforms, OutSkinWeights);
+		UE_LOG(LogTemp, Log, TEXT("Skinning Decomposition. Iteration: %d RMS Error: %f"), Iteration, Error);
+
+		// Converged
+		if (PreviousError - Error < PreviousError * 1e-3f)
+		{
+			break;
+		}
+	}
+
+	// Final weights for the converged transforms
+	return SolveSkinWeights(RestVertices, Deltas, NumFrames, NumBones, NumInfluences, OutTransforms, OutSkinWeights);
+}
+
+void FVATSkinningDecomposition::InitializeClusters(const TArray<FVector3f>& RestVertices, const TArray<FVector3f>& Deltas,
+	const int32 NumFrames, const int32 NumBones, TArray<VertexSkinWeightFour>& OutSkinWeights)
+{
+	const int32 NumVertices = RestVertices.Num();
+	const int32 NumClusters = FMath::Min(NumBones, NumVertices);
+
+	// ---------------------------------------------------------------------------
+	// Trajectory Features. Rest position and a subset of the animated positions.
+	//
+	const int32 NumClusterFrames = FMath::Min(NumFrames, MaxClusterFrames);
+	const int32 NumFeatures = NumClusterFrames + 1;
+
+	TArray<FVector3f> Features;
+	Features.SetNumUninitialized(NumVertices * NumFeatures);
+
+	ParallelFor(NumVertices, [&](int32 VertexIndex)
+	{
+		FVector3f* Feature = &Features[VertexIndex * NumFeatures];
+		Feature[0] = RestVertices[VertexIndex];
+		for (int32 Index = 0; Index < NumClusterFrames; Index++)
+		{
+			const int32 Frame = (Index * NumFrames) / NumClusterFrames;
+			Feature[Index + 1] = RestVertices[VertexIndex] + Deltas[Frame * NumVertices + VertexIndex];
+		}
+	});
+
+	auto FeatureDistance = [&Features, NumFeatures](const FVector3f* Centroid, const int32 VertexIndex)
+	{
+		const FVector3f* Feature = &Features[VertexIndex * NumFeatures];
+		float Distance = 0.f;
+		for (int32 Index = 0; Index < NumFeatures; Index++)
+		{
+			Distance += FVector3f::DistSquared(Centroid[Index], Feature[Index]);
+		}
+		return Distance;
+	};
+
+	// ---------------------------------------------------------------------------
+	// Farthest Point Seeding (deterministic)
+	//
+	TArray<FVector3f> Centroids;
+	Centroids.SetNumUninitialized(NumClusters * NumFeatures);
+
+	TArray<float> MinDistances;
+	MinDistances.Init(TNumericLimits<float>::Max(), NumVertices);
+
+	int32 SeedVertex = 0;
+	for (int32 Cluster = 0; Cluster < NumClusters; Cluster++)
+	{
+		FMemory::Memcpy(&Centroids[Cluster * NumFeatures], &Features[SeedVertex * NumFeatures], NumFeatures * sizeof(FVector3f));
+
+		ParallelFor(NumVertices, [&](int32 VertexIndex)
+		{
+			MinDistances[VertexIndex] = FMath::Min(MinDistances[VertexIndex], FeatureDistance(&Centroids[Cluster * NumFeatures], VertexIndex));
+		});
+
+		SeedVertex = 0;
+		for (int32 VertexIndex = 1; VertexIndex < NumVertices; VertexIndex++)
+		{
+			if (MinDistances[VertexIndex] > MinDistances[SeedVertex])
+			{
+				SeedVertex = VertexIndex;
+			}
+		}
+	}
+
+	// ---------------------------------------------------------------------------
+	// KMeans
+	//
+	TArray<int32> Assignments;
+	Assignments.Init(0, NumVertices);
+
+	for (int32 Iteration = 0; Iteration < NumClusterIterations; Iteration++)
+	{
+		// Assign
+		ParallelFor(NumVertices, [&](int32 VertexIndex)
+		{
+			float BestDistance = TNumericLimits<float>::Max();
+			for (int32 Cluster = 0; Cluster < NumClusters; Cluster++)
+			{
+				const float Distance = FeatureDistance(&Centroids[Cluster * NumFeatures], VertexIndex);
+				if (Distance < BestDistance)
+				{
+					BestDistance = Distance;
+					Assignments[VertexIndex] = Cluster;
+				}
+			}
+		});
+
+		// Update
+		TArray<int32> ClusterSizes;
+		ClusterSizes.Init(0, NumClusters);
+		TArray<FVector3f> NewCentroids;
+		NewCentroids.Init(FVector3f::ZeroVector, NumClusters * NumFeatures);
+
+		for (int32 VertexIndex = 0; VertexIndex < NumVertices; VertexIndex++)
+		{
+			const int32 Cluster = Assignments[VertexIndex];
+			ClusterSizes[Cluster]++;
+			for (int32 Index = 0; Index < NumFeatures; Index++)
+			{
+				NewCentroids[Cluster * NumFeatures + Index] += Features[VertexIndex * NumFeatures + Index];
+			}
+		}
+
+		for (int32 Cluster = 0; Cluster < NumClusters; Cluster++)
+		{
+			// Keep empty clusters where they are
+			if (ClusterSizes[Cluster])
+			{
+				for (int32 Index = 0; Index < NumFeatures; Index++)
+				{
+					Centroids[Cluster * NumFeatures + Index] = NewCentroids[Cluster * NumFeatures + Index] / (float)ClusterSizes[Cluster];
+				}
+			}
+		}
+	}
+
+	// ---------------------------------------------------------------------------
+	// Rigid Weights
+	//
+	OutSkinWeights.SetNumUninitialized(NumVertices);
+	for (int32 VertexIndex = 0; VertexIndex < NumVertices; VertexIndex++)
+	{
+		VertexSkinWeightFour& SkinWeight = OutSkinWeights[VertexIndex];
+		SkinWeight.MeshBoneIndices = TStaticArray<uint16, 4>(InPlace, (uint16)Assignments[VertexIndex]);
+		SkinWeight.BoneWeights = TStaticArray<uint8, 4>(InPlace, 0);
+		SkinWeight.BoneWeights[0] = 255;
+	}
+}
+
+void FVATSkinningDecomposition::SolveTransforms(const TArray<FVector3f>& RestVertices, const TArray<FVector3f>& Deltas,
+	const int32 NumFrames, const int32 NumBones,
+	const TArray<VertexSkinWeightFour>& SkinWeights, TArray<FTransform3f>& InOutTransforms)
+{
+	const int32 NumVertices = RestVertices.Num();
+
+	// Vertices influenced by each bone
+	TArray<TArray<TPair<int32, float>>> BoneVertices;
+	BoneVertices.SetNum(NumBones);
+	for (int32 VertexIndex = 0; VertexIndex < NumVertices; VertexIndex++)
+	{
+		for (int32 Index = 0; Index < 4; Index++)
+		{
+			const float Weight = GetWeight(SkinWeights[VertexIndex], Index);
+			if (Weight > 0.f)
+			{
+				BoneVertices[SkinWeights[VertexIndex].MeshBoneIndices[Index]].Add({ VertexIndex, Weight });
+			}
+		}
+	}
+
+	// Frames are independent
+	ParallelFor(NumFrames, [&](int32 Frame)
+	{
+		const FVector3f* FrameDeltas = &Deltas[Frame * NumVertices];
+		FTransform3f* FrameTransforms = &InOutTransforms[Frame * NumBones];
+
+		// Skinned Vertices with the current transforms
+		TArray<FVector3f> SkinnedVertices;
+		SkinnedVertices.Init(FVector3f::ZeroVector, NumVertices);
+		for (int32 VertexIndex = 0; VertexIndex < NumVertices; VertexIndex++)
+		{
+			for (int32 Index = 0; Index < 4; Index++)
+			{
+				const float Weight = GetWeight(SkinWeights[VertexIndex], Index);
+				if (Weight > 0.f)
+				{
+					SkinnedVertices[VertexIndex] += FrameTransforms[SkinWeights[VertexIndex].MeshBoneIndices[Index]].TransformPosition(RestVertices[VertexIndex]) * Weight;
+				}
+			}
+		}
+
+		// Update one bone at a time, the others fixed.
+		// Each vertex target is what remains after removing the other bones contribution:
+		//   min Sum(Weight^2 * |T * Rest - (Target - Others) / Weight|^2)
+		for (int32 Bone = 0; Bone < NumBones; Bone++)
+		{
+			const TArray<TPair<int32, float>>& Vertices = BoneVertices[Bone];
+			if (Vertices.IsEmpty())
+			{
+				continue;
+			}
+
+			const FTransform3f& PreviousTransform = FrameTransforms[Bone];
+
+			double TotalWeight = 0.0;
+			FVector3f SourceCentroid = FVector3f::ZeroVector;
+			FVector3f TargetCentroid = FVector3f::ZeroVector;
+
+			TArray<FVector3f> Targets;
+			Targets.SetNumUninitialized(Vertices.Num());
+
+			for (int32 Index = 0; Index < Vertices.Num(); Index++)
+			{
+				const int32 VertexIndex = Vertices[Index].Key;
+				const float Weight = Vertices[Index].Value;
+				const FVector3f& Rest = RestVertices[VertexIndex];
+
+				const FVector3f Others = SkinnedVertices[VertexIndex] - PreviousTransform.TransformPosition(Rest) * Weight;
+				Targets[Index] = (Rest + FrameDeltas[VertexIndex] - Others) / Weight;
+
+				const float SquaredWeight = Weight * Weight;
+				TotalWeight += SquaredWeight;
+				SourceCentroid += Rest * SquaredWeight;
+				TargetCentroid += Targets[Index] * SquaredWeight;
+			}
+
+			if (TotalWeight < UE_SMALL_NUMBER)
+			{
+				continue;
+			}
+
+			SourceCentroid /= (float)TotalWeight;
+			TargetCentroid /= (float)TotalWeight;
+
+			FMatrix44f Covariance(EForceInit::ForceInitToZero);
+			for (int32 Index = 0; Index < Vertices.Num(); Index++)
+			{
+				const float SquaredWeight = Vertices[Index].Value * Vertices[Index].Value;
+				const FVector3f Source = RestVertices[Vertices[Index].Key] - SourceCentroid;
+				const FVector3f Target = Targets[Index] - TargetCentroid;
+
+				for (int32 Row = 0; Row < 3; Row++)
+				{
+					for (int32 Column = 0; Column < 3; Column++)
+					{
+						Covariance.M[Row][Column] += SquaredWeight * Source[Row] * Target[Column];
+					}
+				}
+			}
+
+			const FTransform3f NewTransform = FitRigidTransform(SourceCentroid, TargetCentroid, Covariance);
+
+			// Update Skinned Vertices with the new transform
+			for (int32 Index = 0; Index < Vertices.Num(); Index++)
+			{
+				const int32 VertexIndex = Vertices[Index].Key;
+				const float Weight = Vertices[Index].Value;
+				const FVector3f& Rest = RestVertices[VertexIndex];
+				SkinnedVertices[VertexIndex] += (NewTransform.TransformPosition(Rest) - PreviousTransform.TransformPosition(Rest)) * Weight;
+			}
+
+			FrameTransforms[Bone] = NewTransform;
+		}
+	});
+}
+
+float FVATSkinningDecomposition::SolveSkinWeights(const TArray<FVector3f>& RestVertices, const TArray<FVector3f>& Deltas,
+	const int32 NumFrames, const int32 NumBones, const int32 NumInfluences,
+	const TArray<FTransform3f>& Transforms, TArray<VertexSkinWeightFour>& OutSkinWeights)
+{
+	const int32 NumVertices = RestVertices.Num();
+	const int32 MaxInfluences = FMath::Clamp(NumInfluences, 1, 4);
+	check(Transforms.Num() == NumFrames * NumBones);
+
+	OutSkinWeights.SetNumUninitialized(NumVertices);
+
+	ParallelFor(NumVertices, [&](int32 VertexIndex)
+	{
+		const FVector3f& Rest = RestVertices[VertexIndex];
+
+		// ---------------------------------------------------------------------------
+		// Candidates: Bones that fit best on their own
+		//
+		TArray<TPair<double, int32>> BoneErrors;
+		BoneErrors.SetNumUninitialized(NumBones);
+		for (int32 Bone = 0; Bone < NumBones; Bone++)
+		{
+			double Error = 0.0;
+			for (int32 Frame = 0; Frame < NumFrames; Frame++)
+			{
+				const FVector3f Target = Rest + Deltas[Frame * NumVertices + VertexIndex];
+				Error += FVector3f::DistSquared(Transforms[Frame * NumBones + Bone].TransformPosition(Rest), Target);
+			}
+			BoneErrors[Bone] = { Error, Bone };
+		}
+		BoneErrors.Sort([](const TPair<double, int32>& A, const TPair<double, int32>& B) { return A.Key < B.Key; });
+
+		TArray<int32> Candidates;
+		for (int32 Index = 0; Index < FMath::Min(MaxInfluences, NumBones); Index++)
+		{
+			Candidates.Add(BoneErrors[Index].Value);
+		}
+
+		// ---------------------------------------------------------------------------
+		// Constrained Least Squares: min |A * W - Target|^2, Sum(W) = 1, W >= 0
+		// Negative weights are removed one at a time (active set)
+		//
+		TArray<double> Weights;
+		while (true)
+		{
+			const int32 NumCandidates = Candidates.Num();
+			const int32 N = NumCandidates + 1;
+
+			TArray<double> System;
+			TArray<double> RightHandSide;
+			System.SetNumZeroed(N * N);
+			RightHandSide.SetNumZeroed(N);
+
+			for (int32 Frame = 0; Frame < NumFrames; Frame++)
+			{
+				const FVector3f Target = Rest + Deltas[Frame * NumVertices + VertexIndex];
+
+				FVector3f Columns[4];
+				for (int32 Index = 0; Index < NumCandidates; Index++)
+				{
+					Columns[Index] = Transforms[Frame * NumBones + Candidates[Index]].TransformPosition(Rest);
+				}
+
+				for (int32 Row = 0; Row < NumCandidates; Row++)
+				{
+					for (int32 Column = 0; Column < NumCandidates; Column++)
+					{
+						System[Row * N + Column] += FVector3f::DotProduct(Columns[Row], Columns[Column]);
+					}
+					RightHandSide[Row] += FVector3f::DotProduct(Columns[Row], Target);
+				}
+			}
+
+			// Regularization and Sum(W) = 1 constraint (Lagrange multiplier)
+			for (int32 Index = 0; Index < NumCandidates; Index++)
+			{
+				System[Index * N + Index] += 1e-6 * NumFrames;
+				System[Index * N + NumCandidates] = 1.0;
+				System[NumCandidates * N + Index] = 1.0;
+			}
+			RightHandSide[NumCandidates] = 1.0;
+
+			if (!SolveLinearSystem(System, RightHandSide, N))
+			{
+				// Fallback to the best bone
+				Candidates.SetNum(1);
+				Weights = { 1.0 };
+				break;
+			}
+
+			int32 MinIndex = 0;
+			for (int32 Index = 1; Index < NumCandidates; Index++)
+			{
+				MinIndex = RightHandSide[Index] < RightHandSide[MinIndex] ? Index : MinIndex;
+			}
+
+			if (RightHandSide[MinIndex] >= 0.0 || NumCandidates == 1)
+			{
+				Weights = RightHandSide;
+				Weights.SetNum(NumCandidates);
+				break;
+			}
+
+			Candidates.RemoveAt(MinIndex);
+		}
+
+		// ---------------------------------------------------------------------------
+		// Store
+		//
+		TStaticArray<float, 4> FloatWeights(InPlace, 0.f);
+		TStaticArray<uint16, 4> Indices(InPlace, (uint16)Candidates[0]);
+		for (int32 Index = 0; Index < Candidates.Num(); Index++)
+		{
+			FloatWeights[Index] = FMath::Clamp((float)Weights[Index], 0.f, 1.f);
+			Indices[Index] = (uint16)Candidates[Index];
+		}
+
+		// Sorted by weight
+		for (int32 IndexA = 0; IndexA < 4; IndexA++)
+		{
+			for (int32 IndexB = IndexA + 1; IndexB < 4; IndexB++)
+			{
+				if (FloatWeights[IndexB] > FloatWeights[IndexA])
+				{
+					Swap(FloatWeights[IndexA], FloatWeights[IndexB]);
+					Swap(Indices[IndexA], Indices[IndexB]);
+				}
+			}
+		}
+
+		QuantizeWeights(FloatWeights, Indices, OutSkinWeights[VertexIndex]);
+	});
+
+	return ComputeError(RestVertices, Deltas, NumFrames, NumBones, Transforms, OutSkinWeights);
+}
+
+void FVATSkinningDecomposition::GetBonePivots(const TArray<FVector3f>& RestVertices, const TArray<VertexSkinWeightFour>& SkinWeights,
+	const int32 NumBones, TArray<FVector3f>& OutPivots)
+{
+	check(RestVertices.Num() == SkinWeights.Num());
+
+	TArray<float> TotalWeights;
+	TotalWeights.Init(0.f, NumBones);
+	OutPivots.Init(FVector3f::ZeroVector, NumBones);
+
+	for (int32 VertexIndex = 0; VertexIndex < RestVertices.Num(); VertexIndex++)
+	{
+		for (int32 Index = 0; Index < 4; Index++)
+		{
+			const float Weight = GetWeight(SkinWeights[VertexIndex], Index);
+			const int32 Bone = SkinWeights[VertexIndex].MeshBoneIndices[Index];
+			OutPivots[Bone] += RestVertices[VertexIndex] * Weight;
+			TotalWeights[Bone] += Weight;
+		}
+	}
+
+	for (int32 Bone = 0; Bone < NumBones; Bone++)
+	{
+		if (TotalWeights[Bone] > UE_SMALL_NUMBER)
+		{
+			OutPivots[Bone] /= TotalWeights[Bone];
+		}
+	}
+}
+
+float FVATSkinningDecomposition::ComputeError(const TArray<FVector3f>& RestVertices, const TArray<FVector3f>& Deltas,
+	const int32 NumFrames, const int32 NumBones,
+	const TArray<FTransform3f>& Transforms, const TArray<VertexSkinWeightFour>& SkinWeights)
+{
+	const int32 NumVertices = RestVertices.Num();
+	if (!NumVertices || !NumFrames)
+	{
+		return 0.f;
+	}
+
+	TArray<double> FrameErrors;
+	FrameErrors.SetNumZeroed(NumFrames);
+
+	ParallelFor(NumFrames, [&](int32 Frame)
+	{
+		double Error = 0.0;
+		for (int32 VertexIndex = 0; VertexIndex < NumVertices; VertexIndex++)
+		{
+			const FVector3f& Rest = RestVertices[VertexIndex];
+
+			FVector3f Skinned = FVector3f::ZeroVector;
+			for (int32 Index = 0; Index < 4; Index++)
+			{
+				const float Weight = GetWeight(SkinWeights[VertexIndex], Index);
+				if (Weight > 0.f)
+				{
+					Skinned += Transforms[Frame * NumBones + SkinWeights[VertexIndex].MeshBoneIndices[Index]].TransformPosition(Rest) * Weight;
+				}
+			}
+
+			Error += FVector3f::DistSquared(Skinned, Rest + Deltas[Frame * NumVertices + VertexIndex]);
+		}
+		FrameErrors[Frame] = Error;
+	});
+
+	double TotalError = 0.0;
+	for (const double Error : FrameErrors)
+	{
+		TotalError += Error;
+	}
+
+	return (float)FMath::Sqrt(TotalError / ((double)NumFrames * (double)NumVertices));
+}
@@ -0,0 +1,269 @@
+﻿#include "VATVertexReorder.h"
+
+#include "Engine/StaticMesh.h"
+#include "MeshDescription.h"
+
+namespace
+{
+	// Returns the next fanning vertex from the dead-end stack, or the next vertex (from Cursor) with live triangles
+	int32 SkipDeadEnd(const TArray<int32>& LiveTriangles, TArray<int32>& DeadEndStack, int32& Cursor)
+	{
+		while (DeadEndStack.Num())
+		{
+			const int32 Vertex = DeadEndStack.Pop(EAllowShrinking::No);
+			if (LiveTriangles[Vertex] > 0)
+			{
+				return Vertex;
+			}
+		}
+
+		for (; Cursor < LiveTriangles.Num(); Cursor++)
+		{
+			if (LiveTriangles[Cursor] > 0)
+			{
+				return Cursor;
+			}
+		}
+
+		return INDEX_NONE;
+	}
+
+	// Interleaves the bits of X and Y
+	uint32 MortonCode(uint32 X, uint32 Y)
+	{
+		auto Part1By1 = [](uint32 Value)
+		{
+			Value &= 0x0000ffff;
+			Value = (Value | (Value << 8)) & 0x00ff00ff;
+			Value = (Value | (Value << 4)) & 0x0f0f0f0f;
+			Value = (Value | (Value << 2)) & 0x33333333;
+			Value = (Value | (Value << 1)) & 0x55555555;
+			return Value;
+		};
+		return Part1By1(X) | (Part1By1(Y) << 1);
+	}
+}
+
+bool FVATVertexReorder::GetTriangleIndices(const UStaticMesh* StaticMesh, const int32 LODIndex, TArray<int32>& OutIndices, int32& OutNumVertices)
+{
+	check(StaticMesh);
+
+	const FMeshDescription* MeshDescription = StaticMesh->GetMeshDescription(LODIndex);
+	if (!MeshDescription)
+	{
+		return false;
+	}
+
+	OutNumVertices = MeshDescription->Vertices().Num();
+	OutIndices.Reset(MeshDescription->Triangles().Num() * 3);
+
+	for (const FTriangleID TriangleID : MeshDescription->Triangles().GetElementIDs())
+	{
+		for (const FVertexID VertexID : MeshDescription->GetTriangleVertices(TriangleID))
+		{
+			OutIndices.Add(VertexID.GetValue());
+		}
+	}
+
+	return true;
+}
+
+void FVATVertexReorder::OptimizeTriangleOrder(const TArray<int32>& Indices, const int32 NumVertices, const int32 CacheSize, TArray<int32>& OutIndices)
+{
+	const int32 NumTriangles = Indices.Num() / 3;
+
+	// Vertex -> Triangles Adjacency
+	TArray<int32> LiveTriangles;
+	LiveTriangles.Init(0, NumVertices);
+	for (const int32 Vertex : Indices)
+	{
+		LiveTriangles[Vertex]++;
+	}
+
+	TArray<int32> AdjacencyOffsets;
+	AdjacencyOffsets.SetNumUninitialized(NumVertices + 1);
+	AdjacencyOffsets[0] = 0;
+	for (int32 Vertex = 0; Vertex < NumVertices; Vertex++)
+	{
+		AdjacencyOffsets[Vertex + 1] = AdjacencyOffsets[Vertex] + LiveTriangles[Vertex];
+	}
+
+	TArray<int32> Adjacency;
+	Adjacency.SetNumUninitialized(Indices.Num());
+	{
+		TArray<int32> Offsets(AdjacencyOffsets);
+		for (int32 Index = 0; Index < Indices.Num(); Index++)
+		{
+			Adjacency[Offsets[Indices[Index]]++] = Index / 3;
+		}
+	}
+
+	// Cache TimeStamps of each vertex
+	TArray<int32> TimeStamps;
+	TimeStamps.Init(0, NumVertices);
+	TArray<bool> Emitted;
+	Emitted.Init(false, NumTriangles);
+
+	TArray<int32> DeadEndStack;
+	TArray<int32> Candidates;
+	int32 TimeStamp = CacheSize + 1;
+	int32 Cursor = 0;
+
+	OutIndices.Reset(Indices.Num());
+
+	int32 FanningVertex = SkipDeadEnd(LiveTriangles, DeadEndStack, Cursor);
+	while (FanningVertex != INDEX_NONE)
+	{
+		Candidates.Reset();
+
+		// Emit all the live triangles of the fanning vertex
+		for (int32 Offset = AdjacencyOffsets[FanningVertex]; Offset < AdjacencyOffsets[FanningVertex + 1]; Offset++)
+		{
+			const int32 Triangle = Adjacency[Offset];
+			if (Emitted[Triangle])
+			{
+				continue;
+			}
+
+			for (int32 Corner = 0; Corner < 3; Corner++)
+			{
+				const int32 Vertex = Indices[Triangle * 3 + Corner];
+				OutIndices.Add(Vertex);
+				DeadEndStack.Add(Vertex);
+				Candidates.Add(Vertex);
+				LiveTriangles[Vertex]--;
+
+				if (TimeStamp - TimeStamps[Vertex] > CacheSize)
+				{
+					TimeStamps[Vertex] = TimeStamp++;
+				}
+			}
+			Emitted[Triangle] = true;
+		}
+
+		// Next fanning vertex is the oldest candidate that stays in cache after its triangles are emitted
+		int32 NextVertex = INDEX_NONE;
+		int32 BestPriority = INDEX_NONE;
+		for (const int32 Vertex : Candidates)
+		{
+			if (LiveTriangles[Vertex] > 0)
+			{
+				int32 Priority = 0;
+				if (TimeStamp - TimeStamps[Vertex] + 2 * LiveTriangles[Vertex] <= CacheSize)
+				{
+					Priority = TimeStamp - TimeStamps[Vertex];
+				}
+				if (Priority > BestPriority)
+				{
+					BestPriority = Priority;
+					NextVertex = Vertex;
+				}
+			}
+		}
+
+		FanningVertex = NextVertex != INDEX_NONE ? NextVertex : SkipDeadEnd(LiveTriangles, DeadEndStack, Cursor);
+	}
+}
+
+void FVATVertexReorder::GetVertexTexels(const TArray<int32>& Indices, const int32 NumVertices, const int32 Width, const int32 RowsPerFrame,
+	const int32 TileSize, TArray<int32>& OutVertexTexels)
+{
+	check(Width * RowsPerFrame >= NumVertices);
+
+	// Texels in Morton ordered tiles. Texels past the last vertex are padding.
+	TArray<uint32> TileOrder;
+	for (int32 Y = 0; Y < TileSize; Y++)
+	{
+		for (int32 X = 0; X < TileSize; X++)
+		{
+			TileOrder.Add((uint32)(Y * TileSize + X));
+		}
+	}
+	TileOrder.Sort([TileSize](const uint32 A, const uint32 B)
+	{
+		return MortonCode(A % TileSize, A / TileSize) < MortonCode(B % TileSize, B / TileSize);
+	});
+
+	TArray<int32> TexelOrder;
+	TexelOrder.Reserve(NumVertices);
+	for (int32 TileY = 0; TileY < RowsPerFrame; TileY += TileSize)
+	{
+		for (int32 TileX = 0; TileX < Width; TileX += TileSize)
+		{
+			for (const uint32 TileTexel : TileOrder)
+			{
+				const int32 X = TileX + TileTexel % TileSize;
+				const int32 Y = TileY + TileTexel / TileSize;
+				const int32 Texel = Y * Width + X;
+				if (X < Width && Y < RowsPerFrame && Texel < NumVertices)
+				{
+					TexelOrder.Add(Texel);
+				}
+			}
+		}
+	}
+
+	// Vertices in first use order. Unreferenced vertices go last.
+	OutVertexTexels.Init(INDEX_NONE, NumVertices);
+	int32 NumAssigned = 0;
+	for (const int32 Vertex : Indices)
+	{
+		if (OutVertexTexels[Vertex] == INDEX_NONE)
+		{
+			OutVertexTexels[Vertex] = TexelOrder[NumAssigned++];
+		}
+	}
+	for (int32& VertexTexel : OutVertexTexels)
+	{
+		if (VertexTexel == INDEX_NONE)
+		{
+			VertexTexel = TexelOrder[NumAssigned++];
+		}
+	}
+}
+
+int32 FVATVertexReorder::SimulateTextureCacheMisses(const TArray<int32>& Indices, const TArray<int32>& VertexTexels, const int32 Width,
+	const int32 VertexCacheSize, const int32 NumCacheLines, const int32 LineWidth, const int32 LineHeight)
+{
+	TArray<int32> VertexCache;
+	TArray<int64> TextureCache;
+	VertexCache.Reserve(VertexCacheSize + 1);
+	TextureCache.Reserve(NumCacheLines + 1);
+
+	const int64 LinesPerRow = FMath::DivideAndRoundUp(Width, LineWidth);
+	int32 NumMisses = 0;
+
+	for (const int32 Vertex : Indices)
+	{
+		// FIFO post-transform cache. Only shaded vertices fetch texels.
+		if (VertexCache.Contains(Vertex))
+		{
+			continue;
+		}
+		VertexCache.Add(Vertex);
+		if (VertexCache.Num() > VertexCacheSize)
+		{
+			VertexCache.RemoveAt(0, 1, EAllowShrinking::No);
+		}
+
+		// LRU texture cache. Most recently used line is last.
+		const int32 Texel = VertexTexels[Vertex];
+		const int64 Line = (int64)(Texel / Width / LineHeight) * LinesPerRow + (Texel % Width) / LineWidth;
+		const int32 LineIndex = TextureCache.Find(Line);
+		if (LineIndex != INDEX_NONE)
+		{
+			TextureCache.RemoveAt(LineIndex, 1, EAllowShrinking::No);
+		}
+		else
+		{
+			NumMisses++;
+			if (TextureCache.Num() == NumCacheLines)
+			{
+				TextureCache.RemoveAt(0, 1, EAllowShrinking::No);
+			}
+		}
+		TextureCache.Add(Line);
+	}
+
+	return NumMisses;
+}
@@ -1,6 +1,7 @@
 ﻿#pragma once
 
 #include "CoreMinimal.h"
+#include "VATAtlasAssetTypeActions.h"
 #include "VATModelAssetTypeActions.h"
 #include "Modules/ModuleManager.h"
 
@@ -12,5 +13,6 @@ public:
 
 private:
 	TSharedPtr<FVATModelAssetTypeActions> VATModelAssetTypeActions;
+	TSharedPtr<FVATAtlasAssetTypeActions> VATAtlasAssetTypeActions;
 	
 };
@@ -0,0 +1,14 @@
+﻿#pragma once
+#include "CoreMinimal.h"
+#include "AssetTypeActions_Base.h"
+
+class FVATAtlasAssetTypeActions : public FAssetTypeActions_Base
+{
+public:
+	UClass* GetSupportedClass() const override;
+	FText GetName() const override;
+	FColor GetTypeColor() const override;
+	uint32 GetCategories() override;
+	bool HasActions(const TArray<UObject*>& InObjects) const override;
+	void GetActions(const TArray<UObject*>& InObjects, FToolMenuSection& Section) override;
+};
@@ -0,0 +1,48 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/SoftObjectPtr.h"
+
+class UMaterial;
+class UMaterialInstanceConstant;
+class UMaterialFunctionMaterialLayer;
+class UStaticMesh;
+class UTexture2D;
+class UVATAtlas;
+
+/* Packs the Vertex textures of the Atlas Models into shared textures and creates the shared material.
+*  Models must be generated on Vertex Mode with the same Precision, UVChannel and a Single texture layout */
+class FVATAtlasBuilder
+{
+public:
+
+	/* Generates the Atlas textures, Lookup table and materials in <Atlas>_GeneratedVAT.
+	*  Returns false if a model can't be packed */
+	static bool BuildAtlas(UVATAtlas* Atlas);
+
+private:
+
+	static bool CheckAtlas(const UVATAtlas* Atlas);
+
+	static FString GetOutDirectoryPath(const UVATAtlas* Atlas);
+
+	static UTexture2D* CreateTexture2DAsset(const FString& Path);
+
+	/* Stacks the source textures rows at RowOffsets. Texels past a source texture width keep the default color */
+	template<class TextureSettings>
+	static bool CopyTextureRows(const TArray<UTexture2D*>& SourceTextures, const TArray<int32>& RowOffsets,
+		const int32 Height, const int32 Width, UTexture2D* Texture);
+
+	static bool WriteLookupTexture(const UVATAtlas* Atlas, UTexture2D* Texture);
+
+	static UMaterialFunctionMaterialLayer* CreateMaterialLayer(const UVATAtlas* Atlas);
+
+	static UMaterial* CreateMaterial(const UVATAtlas* Atlas, UMaterialFunctionMaterialLayer* Layer);
+
+	/* Creates the per-LOD instances of the shared material */
+	static bool CreateMaterialInstances(const UVATAtlas* Atlas, UMaterial* Material, const FString& Prefix, const bool bUseVariants,
+		TArray<TSoftObjectPtr<UMaterialInstanceConstant>>& OutMaterialInstances);
+
+	/* Merges the model StaticMeshes, one section per model and LOD, and stores the model index in the VariantUVChannel */
+	static UStaticMesh* CreateMergedStaticMesh(const UVATAtlas* Atlas);
+};
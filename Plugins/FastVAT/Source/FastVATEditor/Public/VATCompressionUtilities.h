@@ -0,0 +1,28 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+class FVATCompressionUtilities
+{
+public:
+
+	/* Computes a PCA basis for the given vertex deltas (NumFrames x NumVertices).
+	*  The smallest number of basis vectors (up to MaxNumBasis) with an RMS vertex error under ErrorTolerance is kept.
+	*  OutDeltaBasis and OutNormalBasis are (NumBasis + 1) x NumVertices, with the mean stored first.
+	*  OutCoefficients are NumFrames x NumBasis. Normals are projected on the same coefficients.
+	*  Returns the Number of Basis */
+	static int32 ComputeBasis(const TArray<FVector3f>& Deltas, const TArray<FVector3f>& Normals,
+		const int32 NumFrames, const int32 NumVertices,
+		const int32 MaxNumBasis, const float ErrorTolerance,
+		TArray<FVector3f>& OutDeltaBasis, TArray<FVector3f>& OutNormalBasis, TArray<float>& OutCoefficients,
+		float& OutError);
+
+	/* Jacobi eigen decomposition of a symmetric N x N matrix (row major).
+	*  EigenValues are sorted in descending order and EigenVectors are stored in columns. */
+	static void SymmetricEigenDecomposition(const TArray<double>& Matrix, const int32 N,
+		TArray<double>& OutEigenValues, TArray<double>& OutEigenVectors);
+
+	/* Orthonormalizes the columns of a (column major) NumRows x NumColumns matrix with Modified Gram-Schmidt.
+	*  Degenerated columns are set to zero. */
+	static void OrthonormalizeColumns(TArray<float>& Matrix, const int32 NumRows, const int32 NumColumns);
+};
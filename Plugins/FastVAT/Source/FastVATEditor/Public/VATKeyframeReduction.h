@@ -0,0 +1,56 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "VATModelSettings.h"
+
+/* Error driven keyframe reduction.
+*  Frames that can be linearly interpolated from the kept keyframes (within a tolerance) are dropped.
+*  A FrameRemap table maps every baked frame to the kept keyframes:
+*    X: KeyA, Y: KeyB, Z: Alpha between KeyA and KeyB, W: Alpha increment per frame */
+class FVATKeyframeReduction
+{
+public:
+
+	/* Reduces frames for the given per-frame Points (NumFrames x NumPoints). 
+	*  The first and last frames of each animation are always kept, unless they belong to a static run being trimmed.
+	*  Returns the Number of Keyframes */
+	static int32 ReduceKeyframes(const TArray<FVector3f>& Points, const int32 NumPoints,
+		const TArray<FVATAnimInfo>& Animations, const float ErrorTolerance, const bool bTrimStaticFrames,
+		TArray<int32>& OutKeyframes, TArray<FVector4f>& OutFrameRemap);
+
+	/* Keeps every frame as a Keyframe. Used when frames are deduplicated without reduction.
+	*  Returns the Number of Keyframes */
+	static int32 GetFrameRemap(const TArray<FVATAnimInfo>& Animations, const int32 NumFrames,
+		TArray<int32>& OutKeyframes, TArray<FVector4f>& OutFrameRemap);
+
+	/* Merges Keyframes whose Points are all within Tolerance (across animations).
+	*  Keyframes are bucketed by their quantized centroid and only compared within neighbouring buckets.
+	*  The FrameRemap is updated to point to the unique Keyframes. Returns the Number of unique Keyframes */
+	static int32 DeduplicateKeyframes(const TArray<FVector3f>& Points, const int32 NumPoints, const float Tolerance,
+		TArray<int32>& InOutKeyframes, TArray<FVector4f>& InOutFrameRemap);
+
+	/* Returns the largest sample Step (up to MaxStep) for the Points of a single animation (NumFrames x NumPoints),
+	*  such that frames interpolated between every Step-th frame are within ErrorTolerance. */
+	static int32 FindSampleStep(const TArray<FVector3f>& Points, const int32 NumPoints, const int32 MaxStep, const float ErrorTolerance);
+
+	/* Returns three points around the pivot of each bone, transformed by the bone at every frame.
+	*  Bone data is measured with these points, so the vertex error tolerances (cm) of the settings apply to bones too.
+	*  Positions and Rotations have the RefPose at the first frame, followed by NumFrames of deltas and rotations */
+	static void GetBoneProxyPoints(const TArray<FVector3f>& Positions, const TArray<FVector4f>& Rotations,
+		const int32 NumBones, const int32 NumFrames, TArray<FVector3f>& OutPoints);
+
+	/* Gathers the Keyframes from per-frame data (NumElements per frame). 
+	*  FirstFrame allows skipping leading data (e.g. RefPose), which is kept as is. */
+	template<typename T>
+	static void GatherKeyframes(TArray<T>& InOutData, const int32 NumElements, const TArray<int32>& Keyframes, const int32 FirstFrame = 0)
+	{
+		TArray<T> Data;
+		Data.Reserve((Keyframes.Num() + FirstFrame) * NumElements);
+		Data.Append(InOutData.GetData(), FirstFrame * NumElements);
+		for (const int32 Keyframe : Keyframes)
+		{
+			Data.Append(&InOutData[(Keyframe + FirstFrame) * NumElements], NumElements);
+		}
+		InOutData = MoveTemp(Data);
+	}
+};
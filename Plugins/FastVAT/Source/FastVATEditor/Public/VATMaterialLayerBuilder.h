@@ -0,0 +1,83 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+class UMaterialFunctionMaterialLayer;
+class UTexture;
+
+/* Builds a MaterialLayer asset with a single Custom node driving WorldPositionOffset and Normal.
+*  The Custom node code returns the local space vertex offset and writes the local space normal to "Normal".
+*  The Normal goes through a VertexInterpolator, so the code only runs in the vertex shader.
+*  Inputs are exposed to the code with the same name as the parameter (or input). */
+class FVATMaterialLayerBuilder
+{
+public:
+
+	FVATMaterialLayerBuilder(const FString& InDescription);
+
+	/* Adds a .ush file to the Custom node, e.g. /Plugin/FastVAT/Private/VATCommon.ush */
+	void AddInclude(const FString& IncludeFilePath);
+
+	/* Adds a preprocessor define to the Custom node, e.g. VAT_PAGED 1 */
+	void AddDefine(const FString& Name, const FString& Value);
+
+	void AddScalarParameter(const FName Name, const float DefaultValue = 0.f);
+	void AddVectorParameter(const FName Name, const FLinearColor& DefaultValue = FLinearColor::Black);
+	void AddTextureParameter(const FName Name, UTexture* DefaultTexture);
+
+	/* Static Switches are passed to the code as a 1.0 / 0.0 float */
+	void AddStaticSwitchParameter(const FName Name, const bool bDefaultValue = false);
+
+	void AddTexCoord(const FName Name, const int32 CoordinateIndex);
+	void AddTime(const FName Name);
+
+	/* Vertex position and normal in local space (without offsets) */
+	void AddLocalPosition(const FName Name);
+	void AddLocalNormal(const FName Name);
+
+	/* Distance between the camera and the object position */
+	void AddCameraDistance(const FName Name);
+
+	/* Per Instance Custom Data of instanced static meshes, DefaultValue elsewhere */
+	void AddPerInstanceCustomData(const FName Name, const int32 DataIndex, const float DefaultValue = 0.f);
+
+	/* Appends a line of code to the Custom node */
+	void AddCode(const FString& Line);
+
+	/* Creates the MaterialLayer asset.
+	*  Returns nullptr if the asset could not be created */
+	UMaterialFunctionMaterialLayer* Build(const FString& PackagePath, const FString& AssetName) const;
+
+private:
+
+	enum class EInputType : uint8
+	{
+		Scalar,
+		Vector,
+		Texture,
+		StaticSwitch,
+		TexCoord,
+		Time,
+		LocalPosition,
+		LocalNormal,
+		CameraDistance,
+		PerInstanceCustomData,
+	};
+
+	struct FInput
+	{
+		EInputType Type;
+		FName Name;
+		float ScalarValue = 0.f;
+		FLinearColor VectorValue = FLinearColor::Black;
+		UTexture* TextureValue = nullptr;
+		int32 CoordinateIndex = 0;
+		int32 DataIndex = 0;
+	};
+
+	FString Description;
+	TArray<FString> IncludeFilePaths;
+	TArray<TPair<FString, FString>> Defines;
+	TArray<FInput> Inputs;
+	TArray<FString> CodeLines;
+};
@@ -18,6 +18,10 @@ public:
 	FText GetBaseToolkitName() const override;
 	FString GetWorldCentricTabPrefix() const override;
 	FLinearColor GetWorldCentricTabColorScale() const override;
+
+	/* Logs the texture sizes picked by FindBestResolution against the legacy max Width layout,
+	*  for a sweep of typical vertex, bone and frame counts. Runs with the FastVAT.ResolutionSweep command */
+	static void LogResolutionSweep();
 	
 protected:
 	void BindCommands();
@@ -29,8 +33,14 @@ protected:
 	// automation steps
 	void CreateTextures();
 
+	/* Returns the MaterialLayer used by the generated materials.
+	*  Stock AnimToTexture layers are used when possible, otherwise a layer is created with CreateMaterialLayer */
+	UMaterialFunctionInterface* GetMaterialLayer();
+	class UMaterialFunctionMaterialLayer* CreateMaterialLayer();
+
 	// helpers
 	UTexture2D* CreateTexture2DAsset(FString Path);
+	UTexture2DArray* CreateTexture2DArrayAsset(FString Path);
 	FString CreateTexture2DName(FString Name, const int32 LODIndex);
 	static UStaticMesh* ConvertSkeletalMeshToStaticMesh(USkeletalMesh* SkeletalMesh, const FString PackageName, const FVector2D LODRange);
 	
@@ -51,6 +61,10 @@ protected:
 	static int32 GetAnimationFrameRange(const FVATAnimSequenceInfo& Animation, 
 		int32& OutStartFrame, int32& OutEndFrame);
 
+	// Returns the hash of the Skeleton, animations, settings and RefPose the Bone data of an Animation Library depends on
+	static FString GetAnimationLibraryKey(const UVATModel* Model, const TArray<FVATAnimSequenceInfo>& AnimSequences,
+		const TArray<FVector3f>& BoneRefPositions, const TArray<FVector4f>& BoneRefRotations);
+
 	// Get Vertex and Normals from Current Pose
 	// The VertexDelta is returned from the RefPose
 	static void GetVertexDeltasAndNormals(const USkeletalMeshComponent* SkeletalMeshComponent, const int32 LODIndex, 
@@ -62,6 +76,28 @@ protected:
 	static int32 GetRefBonePositionsAndRotations(const USkeletalMesh* SkeletalMesh, 
 		TArray<FVector3f>& OutBoneRefPositions, TArray<FVector4f>& OutBoneRefRotations);
 
+	// Gets the Skeleton (raw) bone index of each bone to bake. With Cull Unused Bones, only bones with skin weights in the
+	// baked SkeletalMesh LODs, KeepBones and AttachToSocket. Parents stay before children.
+	// With Reduce Bone LODs, bones are sorted by descending importance (skin weight fraction of the bone and its children)
+	static void GetBoneMap(const UVATModel* Model, TArray<int32>& OutBoneMap, TArray<float>& OutBoneImportances);
+
+	// Collapses the influences of bones past NumLODBones into their closest kept parent, merging repeated bones.
+	// SkinWeights are indexed by baked bone
+	static void CollapseSkinWeights(const UVATModel* Model, const int32 NumLODBones, TArray<VertexSkinWeightFour>& InOutSkinWeights);
+
+	// Gets the vertices whose delta is over Tolerance in any frame. At least one vertex is returned
+	static void GetDynamicVertices(const TArray<FVector3f>& VertexDeltas, const int32 NumVertices, const int32 NumFrames,
+		const float Tolerance, TArray<int32>& OutDynamicVertices);
+
+	// Gets the vertices of the given StaticMesh sections (PolygonGroups), in order
+	static void GetSectionVertices(const UStaticMesh* StaticMesh, const int32 LODIndex,
+		const TArray<int32>& Sections, TArray<int32>& OutVertices);
+
+	// Gets the bone of each StaticMesh section (PolygonGroup) whose vertices all follow a single bone, or INDEX_NONE.
+	// Returns the number of rigid sections
+	static int32 GetRigidSectionBones(const UStaticMesh* StaticMesh, const int32 LODIndex,
+		const TArray<VertexSkinWeightFour>& SkinWeights, TArray<int32>& OutSectionBones);
+
 	// Gets Bone Position and Rotations for Current Pose.	
 	// The BonePosition is returned relative to the RefPose
 	static int32 GetBonePositionsAndRotations(const USkeletalMeshComponent* SkeletalMeshComponent, const TArray<FVector3f>& BoneRefPositions,
@@ -73,17 +109,76 @@ protected:
 		FVector3f& OutMinBBox, FVector3f& OutSizeBBox,
 		TArray<FVector3f>& OutNormalizedDeltas, TArray<FVector3f>& OutNormalizedNormals);
 
+	// Computes Bounding Box of Vectors
+	static void ComputeBoundingBox(const TArray<FVector3f>& Vectors, FVector3f& OutMinBBox, FVector3f& OutSizeBBox);
+
+	// Normalizes Vectors between [0-1] with Bounding Box
+	static void NormalizeVectors(const TArray<FVector3f>& Vectors, const FVector3f& MinBBox, const FVector3f& SizeBBox,
+		TArray<FVector3f>& OutNormalizedVectors);
+
 	// Normalizes Positions and Rotations between [0-1] with Bounding Box
 	static void NormalizeBoneData(
 		const TArray<FVector3f>& Positions, const TArray<FVector4f>& Rotations,
 		FVector3f& OutMinBBox, FVector3f& OutSizeBBox,
 		TArray<FVector3f>& OutNormalizedPositions, TArray<FVector4f>& OutNormalizedRotations);
 
+	// Converts Positions and Rotations (RefPose first) to the three RefToLocal matrix rows of each bone, per frame.
+	// Rotation entries are moved to [0-1] and translations (W) are normalized with Bounding Box
+	static void NormalizeBoneMatrices(
+		const TArray<FVector3f>& Positions, const TArray<FVector4f>& Rotations, const int32 NumBones,
+		FVector3f& OutMinBBox, FVector3f& OutSizeBBox,
+		TArray<FVector4f>& OutNormalizedMatrixRows);
+
+	// Converts Positions and Rotations (RefPose first) to the Dual Quaternions of each bone, per frame.
+	// Quaternion signs are kept continuous across frames
+	static void GetBoneDualQuaternions(
+		const TArray<FVector3f>& Positions, const TArray<FVector4f>& Rotations, const int32 NumBones,
+		TArray<FQuat4f>& OutReals, TArray<FQuat4f>& OutDuals);
+
+	// Normalizes Real quaternions to [0-1], and Dual quaternions with a symmetric range (OutMinBBox = -Range, OutSizeBBox = 2 * Range)
+	static void NormalizeBoneDualQuaternions(
+		const TArray<FQuat4f>& Reals, const TArray<FQuat4f>& Duals,
+		FVector3f& OutMinBBox, FVector3f& OutSizeBBox,
+		TArray<FVector4f>& OutNormalizedReals, TArray<FVector4f>& OutNormalizedDuals);
+
+	// Logs the max vertex error of the 16 bit Dual Quaternion textures against the CPU reference skinning
+	static void LogDualQuaternionError(const UStaticMesh* StaticMesh, const int32 LODIndex,
+		const TArray<VertexSkinWeightFour>& SkinWeights, const int32 NumBones,
+		const TArray<FQuat4f>& Reals, const TArray<FQuat4f>& Duals,
+		const TArray<FVector4f>& NormalizedReals, const TArray<FVector4f>& NormalizedDuals,
+		const FVector3f& MinBBox, const FVector3f& SizeBBox);
+
+	// Computes the residual (ground truth minus Bone Mode skinning) of each vertex at each stored frame, and the max residual length of each vertex.
+	// VertexDeltas are the ground truth deltas from RestVertices. Positions and Rotations have the RefPose first.
+	// Dual Quaternions (if any) are blended instead, as the DualQuaternion Bone Encoding
+	static void GetBoneResiduals(const TArray<FVector3f>& RestVertices, const TArray<FVector3f>& VertexDeltas,
+		const TArray<VertexSkinWeightFour>& SkinWeights,
+		const TArray<FVector3f>& Positions, const TArray<FVector4f>& Rotations,
+		const TArray<FQuat4f>& Reals, const TArray<FQuat4f>& Duals, const int32 NumBones, const int32 NumFrames,
+		TArray<FVector3f>& OutResiduals, TArray<float>& OutMaxResiduals);
+
 	/* Returns best resolution for the given data. 
+	*  All Widths are searched for the smallest texture (or padded power of two allocation) and the fill ratio is logged.
 	*  Returns false if data doesnt fit in the the max range */
 	static bool FindBestResolution(const int32 NumFrames, const int32 NumElements,
 								   int32& OutHeight, int32& OutWidth, int32& OutRowsPerFrame,
-								   const int32 MaxHeight = 4096, const int32 MaxWidth = 4096, bool bEnforcePowerOfTwo = false);
+								   const int32 MaxHeight = 4096, const int32 MaxWidth = 4096, bool bEnforcePowerOfTwo = false, bool bMinimizePaddedSize = false);
+
+	/* Returns best page resolution for the given data. Frames spill across pages of at most MaxHeight rows.
+	*  Frames of each FrameGroup (if any) are packed whole into pages sized to the largest group.
+	*  The first NumHeaderFrames frames are reserved at the start of every page.
+	*  OutFramePages stores the page (X) and the frame within the page (Y) of each frame.
+	*  Returns false if a single frame doesnt fit in a page, or there are too many pages */
+	static bool FindBestPagedResolution(const int32 NumFrames, const int32 NumElements, const TArray<int32>& FrameGroups, const int32 NumHeaderFrames,
+										int32& OutHeight, int32& OutWidth, int32& OutRowsPerFrame,
+										TArray<FIntPoint>& OutFramePages, int32& OutNumPages,
+										const int32 MaxHeight = 4096, const int32 MaxWidth = 4096, bool bEnforcePowerOfTwo = false, bool bMinimizePaddedSize = false);
+
+	/* Sets the pages of each animation. FrameGroups stores the animation of each frame */
+	static void SetAnimationPages(UVATModel* Model, const TArray<int32>& FrameGroups, const TArray<FIntPoint>& FramePages);
+
+	/* Writes the PageTable texture of the given LOD */
+	static bool WritePageTable(UVATModel* Model, const int32 LODIndex, const TArray<FIntPoint>& FramePages);
 
 	/* Sets Static Mesh FullPrecisionUVs Property*/
 	static void SetFullPrecisionUVs(UStaticMesh* StaticMesh, const int32 LODIndex, bool bFullPrecision=true);
@@ -91,9 +186,27 @@ protected:
 	/* Sets Static Mesh Bound Extensions */
 	static void SetBoundsExtensions(UStaticMesh* StaticMesh, const FVector& MinBBox, const FVector& SizeBBox);
 
-	/* Creates UV Coord with vertices */
+	/* Creates UV Coord with vertices.
+	*  VertexTexels (if any) stores the texel of each vertex, otherwise vertices are stored in order. Vertices without texel (INDEX_NONE) store (-1, -1).
+	*  SectionBones (if any) stores the bone of each rigid section (PolygonGroup). Rigid vertices store (Bone, -1).
+	*  VertexUVs (if any) stores the UV of the vertices addressing another texture (Vertex Sections) */
 	static bool CreateUVChannel(UStaticMesh* StaticMesh, const int32 LODIndex, const int32 UVChannelIndex,
-		const int32 Height, const int32 Width);
+		const int32 Height, const int32 Width, const TArray<int32>& VertexTexels = TArray<int32>(),
+		const TArray<int32>& SectionBones = TArray<int32>(), const TMap<int32, FVector2D>& VertexUVs = TMap<int32, FVector2D>());
+
+	/* Inserts a UVChannel if it doesnt exist. Returns false if UVChannelIndex is out of range */
+	static bool AddUVChannel(UStaticMesh* StaticMesh, const int32 LODIndex, const int32 UVChannelIndex);
+
+	/* Stores the four influences of each vertex in UVChannelIndex (influences 0-1) and UVChannelIndex + 1 (influences 2-3).
+	*  Each component packs BoneIndex + BoneWeight / 256 */
+	static bool CreateSkinWeightUVChannels(UStaticMesh* StaticMesh, const int32 LODIndex, const int32 UVChannelIndex,
+		const TArray<VertexSkinWeightFour>& SkinWeights);
+
+	/* Returns the texel of each vertex optimized for texture cache locality, and logs the simulated cache misses.
+	*  Indices are the cache optimized triangles used for assigning texels. MeshIndices are the triangles of the mesh,
+	*  used for measuring the misses. Returns false if the vertices can't be reordered */
+	static bool GetOptimizedVertexTexels(const TArray<int32>& Indices, const TArray<int32>& MeshIndices, const int32 NumVertices,
+		const int32 Width, const int32 RowsPerFrame, TArray<int32>& OutVertexTexels);
 
 protected:
 	void ExecuteGenerateVAT();
@@ -37,6 +37,13 @@ public:
 	/** Reduce Weights from MAX_TOTAL_INFLUENCES to 4 */
 	static void ReduceSkinWeights(const TArray<VertexSkinWeightMax>& InSkinWeights, TArray<VertexSkinWeightFour>& OutSkinWeights);
 
+	/** Drops influences lighter than Threshold (weight fraction) and merges repeated bones.
+	*   Weights are renormalized and sorted by descending weight, so empty influences come last */
+	static void PruneSkinWeights(TArray<VertexSkinWeightFour>& InOutSkinWeights, const float Threshold);
+
+	/** Returns the average number of non-empty influences per vertex */
+	static float GetAverageNumInfluences(const TArray<VertexSkinWeightFour>& SkinWeights, int32& OutMaxNumInfluences);
+
 	/* Interpolates an Array of SkinWeights with an Array of Weights(InverseDistanceWeights) */
 	static void InterpolateVertexSkinWeights(const TArray<VertexSkinWeightMax>& VertexSkinWeights, const TArray<float>& Weights,
 		VertexSkinWeightMax& OutVertexSkinWeights);
@@ -87,4 +94,14 @@ public:
 		
 	static void DecomposeTransformations(const TArray<FTransform>& Transforms, 
 		TArray<FVector3f>& OutTranslations, TArray<FVector4f>& OutRotations);
+
+	/* Returns the Dual Quaternion (Real, Dual) of a rigid transformation: Position' = Rotation * Position + Translation */
+	static void GetDualQuaternion(const FQuat4f& Rotation, const FVector3f& Translation,
+		FQuat4f& OutReal, FQuat4f& OutDual);
+
+	/* CPU reference of Dual Quaternion skinning with four influences (see VATBoneDualQuatSkinned).
+	*  Reals and Duals are indexed by bone. Quaternions are blended in the hemisphere of the accumulated Real, then normalized */
+	static FVector3f DualQuaternionSkinning(const FVector3f& Position, const FVector3f& Normal,
+		TConstArrayView<FQuat4f> Reals, TConstArrayView<FQuat4f> Duals, const VertexSkinWeightFour& SkinWeight,
+		FVector3f& OutNormal);
 };
@@ -0,0 +1,47 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "VATSkeletalMeshUtilities.h"
+
+/* Smooth Skinning Decomposition (SSDR).
+*  Fits a set of virtual bones (one rigid transform per frame) and per-vertex skin weights to vertex animation.
+*  Transforms are stored per frame, NumBones each, and map RestVertices to the animated vertices. */
+class FVATSkinningDecomposition
+{
+public:
+
+	/* Fits NumBones virtual bones to the given vertex deltas (NumFrames x NumVertices, relative to RestVertices).
+	*  Iterates until the RMS vertex error is under ErrorTolerance or MaxIterations is reached.
+	*  Returns the RMS vertex error */
+	static float Decompose(const TArray<FVector3f>& RestVertices, const TArray<FVector3f>& Deltas,
+		const int32 NumFrames, const int32 NumBones, const int32 NumInfluences,
+		const float ErrorTolerance, const int32 MaxIterations,
+		TArray<FTransform3f>& OutTransforms, TArray<VertexSkinWeightFour>& OutSkinWeights);
+
+	/* Solves skin weights for fixed bone transforms. 
+	*  Each vertex uses the NumInfluences bones that fit best, with positive weights that sum to one.
+	*  Returns the RMS vertex error */
+	static float SolveSkinWeights(const TArray<FVector3f>& RestVertices, const TArray<FVector3f>& Deltas,
+		const int32 NumFrames, const int32 NumBones, const int32 NumInfluences,
+		const TArray<FTransform3f>& Transforms, TArray<VertexSkinWeightFour>& OutSkinWeights);
+
+	/* Returns the rest pose pivot of each bone (weighted centroid of its vertices) */
+	static void GetBonePivots(const TArray<FVector3f>& RestVertices, const TArray<VertexSkinWeightFour>& SkinWeights,
+		const int32 NumBones, TArray<FVector3f>& OutPivots);
+
+private:
+
+	/* Solves bone transforms for fixed skin weights */
+	static void SolveTransforms(const TArray<FVector3f>& RestVertices, const TArray<FVector3f>& Deltas,
+		const int32 NumFrames, const int32 NumBones,
+		const TArray<VertexSkinWeightFour>& SkinWeights, TArray<FTransform3f>& InOutTransforms);
+
+	/* Initializes bones by clustering vertex trajectories */
+	static void InitializeClusters(const TArray<FVector3f>& RestVertices, const TArray<FVector3f>& Deltas,
+		const int32 NumFrames, const int32 NumBones, TArray<VertexSkinWeightFour>& OutSkinWeights);
+
+	/* Computes the RMS vertex error of the skinned vertices */
+	static float ComputeError(const TArray<FVector3f>& RestVertices, const TArray<FVector3f>& Deltas,
+		const int32 NumFrames, const int32 NumBones,
+		const TArray<FTransform3f>& Transforms, const TArray<VertexSkinWeightFour>& SkinWeights);
+};
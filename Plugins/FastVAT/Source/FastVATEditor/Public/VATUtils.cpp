@@ -1 +1,49 @@
 ﻿#include "VATUtils.h"
+
+int32 FVATUtils::GetNumTemporalMips(const int32 NumFrames, const int32 RowsPerFrame,
+	const int32 Height, const int32 Width, const int32 MaxNumMips)
+{
+	check(FMath::IsPowerOfTwo(Height) && FMath::IsPowerOfTwo(Width));
+
+	int32 NumMips = 1;
+	while (NumMips < MaxNumMips)
+	{
+		const int32 Mip = NumMips;
+		const int32 MipFrames = FMath::DivideAndRoundUp(NumFrames, 1 << (2 * Mip));
+
+		// Width must stay divisible, and the subsampled frames must fit the mip height
+		if ((Width >> Mip) < 1 || (Height >> Mip) < 1 || (int64)MipFrames * (RowsPerFrame << Mip) > (Height >> Mip))
+		{
+			break;
+		}
+		NumMips++;
+	}
+
+	return NumMips;
+}
+
+bool FVATUtils::WriteBoneIndicesToTexture(const TArray<VertexSkinWeightFour>& SkinWeights,
+	const int32 Height, const int32 Width, UTexture2D* Texture)
+{
+	check(Texture);
+
+	// Allocate PixelData.
+	TArray<FIndexPrecision::ColorType> Pixels;
+	Pixels.Init(FIndexPrecision::DefaultColor, Height * Width);
+
+	for (int32 VertexIndex = 0; VertexIndex < SkinWeights.Num(); ++VertexIndex)
+	{
+		const VertexSkinWeightFour& VertexSkinWeight = SkinWeights[VertexIndex];
+
+		const FVector4f BoneIndices(
+			(float)VertexSkinWeight.MeshBoneIndices[0],
+			(float)VertexSkinWeight.MeshBoneIndices[1],
+			(float)VertexSkinWeight.MeshBoneIndices[2],
+			(float)VertexSkinWeight.MeshBoneIndices[3]);
+
+		VectorToColor<FVector4f, FIndexPrecision::ColorType>(BoneIndices, Pixels[VertexIndex]);
+	}
+
+	// Write to Texture
+	return WriteToTexture<FIndexPrecision>(Texture, Height, Width, Pixels);
+}
@@ -27,6 +27,26 @@ struct FHighPrecision
 	static constexpr ColorType DefaultColor = { 0, 0, 0, 0 };
 };
 
+// Stores values as 16bit floats. Used for integer indices, which are exact up to 2048
+struct FIndexPrecision
+{
+	using ColorType = FFloat16Color;
+	static constexpr EPixelFormat PixelFormat = EPixelFormat::PF_FloatRGBA;
+	static constexpr ETextureSourceFormat TextureSourceFormat = ETextureSourceFormat::TSF_RGBA16F;
+	static constexpr TextureCompressionSettings CompressionSettings = TextureCompressionSettings::TC_HDR;
+	static inline const ColorType DefaultColor = FFloat16Color(FLinearColor(0.f, 0.f, 0.f, 0.f));
+};
+
+// Stores values as 32bit floats. Used for tables that need exact values (e.g. frame indices)
+struct FFullPrecision
+{
+	using ColorType = FLinearColor;
+	static constexpr EPixelFormat PixelFormat = EPixelFormat::PF_A32B32G32R32F;
+	static constexpr ETextureSourceFormat TextureSourceFormat = ETextureSourceFormat::TSF_RGBA32F;
+	static constexpr TextureCompressionSettings CompressionSettings = TextureCompressionSettings::TC_HDR_F32;
+	static constexpr ColorType DefaultColor = FLinearColor(0.f, 0.f, 0.f, 0.f);
+};
+
 class FVATUtils
 {
 public:
@@ -39,18 +59,65 @@ public:
 		const int32 Height, const int32 Width, 
 		UTexture2D* Texture);
 
+	/** Writes list of vectors into texture, with the frames of each element in adjacent rows.
+	*   Each row of elements is followed by NumFrames rows, one per frame. Texture is bilinear filtered.
+	*   Note: They must be pre-normalized. */
+	template<class V, class TextureSettings>
+	static bool WriteVectorsToInterleavedTexture(const TArray<V>& Vectors,
+		const int32 NumFrames, const int32 Height, const int32 Width,
+		UTexture2D* Texture);
+
+	/** Writes list of vectors into texture with temporal mips.
+	*   Mip Level stores every 4^Level-th frame. Elements are re-addressed to the mip Width (Width >> Level),
+	*   so RowsPerFrame doubles every level. Texture must be power of two.
+	*   Note: They must be pre-normalized. */
+	template<class V, class TextureSettings>
+	static bool WriteVectorsToTextureMips(const TArray<V>& Vectors,
+		const int32 NumFrames, const int32 RowsPerFrame,
+		const int32 Height, const int32 Width, const int32 NumMips,
+		UTexture2D* Texture);
+
+	/* Returns the number of temporal mips (up to MaxNumMips) that fit the frames of a power of two texture */
+	static int32 GetNumTemporalMips(const int32 NumFrames, const int32 RowsPerFrame,
+		const int32 Height, const int32 Width, const int32 MaxNumMips);
+
+	/** Writes list of vectors into the pages of a texture array
+	*   FramePages stores the page (X) and the frame within the page (Y) of each frame.
+	*   Note: They must be pre-normalized. */
+	template<class V, class TextureSettings>
+	static bool WriteVectorsToTextureArray(const TArray<V>& Vectors,
+		const int32 NumFrames, const int32 RowsPerFrame,
+		const int32 Height, const int32 Width,
+		const TArray<FIntPoint>& FramePages, const int32 NumPages,
+		UTexture2DArray* Texture);
+
 	/* Writes list of skinweights into texture.
 	*  The SkinWeights data is already in uint8 & uint16 format, no need for normalizing it.
+	*  Without indices (see WriteBoneIndicesToTexture), weights are stored in the first block.
 	*/
 	template<class TextureSettings>
 	static bool WriteSkinWeightsToTexture(const TArray<VertexSkinWeightFour>& SkinWeights, const int32 NumBones,
 		const int32 RowsPerFrame,
+		const int32 Height, const int32 Width,
+		UTexture2D* Texture, const bool bWriteIndices = true);
+
+	/* Writes the bone indices of the skinweights into texture as integers */
+	static bool WriteBoneIndicesToTexture(const TArray<VertexSkinWeightFour>& SkinWeights,
 		const int32 Height, const int32 Width,
 		UTexture2D* Texture);
 
 	/* Helper utility for writing 8 or 16 bits textures */
 	template<class TextureSettings>
-	static bool WriteToTexture(UTexture2D* Texture, const uint32 Height, const uint32 Width, const TArray<typename TextureSettings::ColorType>& Data);
+	static bool WriteToTexture(UTexture2D* Texture, const uint32 Height, const uint32 Width, const TArray<typename TextureSettings::ColorType>& Data,
+		const TextureFilter Filter = TextureFilter::TF_Nearest);
+
+	/* Helper utility for writing 8 or 16 bits textures with custom mips. Pixels are stored mip after mip */
+	template<class TextureSettings>
+	static bool WriteToTextureMips(UTexture2D* Texture, const uint32 Height, const uint32 Width, const uint32 NumMips, const TArray<typename TextureSettings::ColorType>& Data);
+
+	/* Helper utility for writing 8 or 16 bits texture arrays. Pixels are stored slice after slice */
+	template<class TextureSettings>
+	static bool WriteToTextureArray(UTexture2DArray* Texture, const uint32 Height, const uint32 Width, const uint32 NumSlices, const TArray<typename TextureSettings::ColorType>& Data);
 
 	template<class V /* FVector3f / FVector4f */, class C /* FColor / FVector4u16 */>
 	static void VectorToColor(const V& Vector, C& Color);
@@ -107,6 +174,27 @@ FORCEINLINE void FVATUtils::VectorToColor(const FVector4f& Vector, FVector4u16&
 	Color.W = FMath::RoundToInt(FMath::Clamp(Vector.W, 0.f, 1.f) * TNumericLimits<uint16>::Max());
 }
 
+// IndexPrecision. Values are not normalized
+template<>
+FORCEINLINE void FVATUtils::VectorToColor(const FVector4f& Vector, FFloat16Color& Color)
+{
+	Color = FFloat16Color(FLinearColor(Vector.X, Vector.Y, Vector.Z, Vector.W));
+}
+
+// FullPrecision. Values are not normalized
+template<>
+FORCEINLINE void FVATUtils::VectorToColor(const FVector3f& Vector, FLinearColor& Color)
+{
+	Color = FLinearColor(Vector.X, Vector.Y, Vector.Z, 1.f);
+}
+
+// FullPrecision. Values are not normalized
+template<>
+FORCEINLINE void FVATUtils::VectorToColor(const FVector4f& Vector, FLinearColor& Color)
+{
+	Color = FLinearColor(Vector.X, Vector.Y, Vector.Z, Vector.W);
+}
+
 template<class V, class TextureSettings>
 FORCEINLINE_DEBUGGABLE bool FVATUtils::WriteVectorsToTexture(const TArray<V>& Vectors,
 	const int32 NumFrames, const int32 RowsPerFrame,
@@ -143,13 +231,141 @@ FORCEINLINE_DEBUGGABLE bool FVATUtils::WriteVectorsToTexture(const TArray<V>& Ve
 	return WriteToTexture<TextureSettings>(Texture, Height, Width, Pixels);
 }
 
+template<class V, class TextureSettings>
+FORCEINLINE_DEBUGGABLE bool FVATUtils::WriteVectorsToInterleavedTexture(const TArray<V>& Vectors,
+	const int32 NumFrames, const int32 Height, const int32 Width, UTexture2D* Texture)
+{
+	if (!Texture || !NumFrames)
+	{
+		return false;
+	}
+
+	// NumElements Per-Frame
+	const int32 NumElements = Vectors.Num() / NumFrames;
+
+	// Allocate PixelData.
+	TArray<typename TextureSettings::ColorType> Pixels;
+	Pixels.Init(TextureSettings::DefaultColor, Height * Width);
+
+	// Fillout Frame Data
+	for (int32 Frame = 0; Frame < NumFrames; Frame++)
+	{
+		// Set Data.
+		for (int32 Index = 0; Index < NumElements; Index++)
+		{
+			const V& Vector = Vectors[NumElements * Frame + Index];
+			const int32 Row = (Index / Width) * NumFrames + Frame;
+			typename TextureSettings::ColorType& Pixel = Pixels[Row * Width + Index % Width];
+
+			VectorToColor<V, typename TextureSettings::ColorType>(Vector, Pixel);
+		}
+	}
+
+	// Write to Texture
+	return WriteToTexture<TextureSettings>(Texture, Height, Width, Pixels, TextureFilter::TF_Bilinear);
+}
+
+template<class V, class TextureSettings>
+FORCEINLINE_DEBUGGABLE bool FVATUtils::WriteVectorsToTextureMips(const TArray<V>& Vectors,
+	const int32 NumFrames, const int32 RowsPerFrame,
+	const int32 Height, const int32 Width, const int32 NumMips,
+	UTexture2D* Texture)
+{
+	if (!Texture || !NumFrames || !NumMips)
+	{
+		return false;
+	}
+
+	// NumElements Per-Frame
+	const int32 NumElements = Vectors.Num() / NumFrames;
+
+	// Allocate PixelData for all Mips.
+	int32 NumPixels = 0;
+	for (int32 Mip = 0; Mip < NumMips; Mip++)
+	{
+		NumPixels += FMath::Max(Height >> Mip, 1) * FMath::Max(Width >> Mip, 1);
+	}
+
+	TArray<typename TextureSettings::ColorType> Pixels;
+	Pixels.Init(TextureSettings::DefaultColor, NumPixels);
+
+	// Fillout Frame Data
+	int32 MipStart = 0;
+	for (int32 Mip = 0; Mip < NumMips; Mip++)
+	{
+		const int32 MipWidth = FMath::Max(Width >> Mip, 1);
+		const int32 MipHeight = FMath::Max(Height >> Mip, 1);
+		const int32 MipRowsPerFrame = RowsPerFrame << Mip;
+		const int32 Step = 1 << (2 * Mip);
+
+		for (int32 Frame = 0; Frame < NumFrames; Frame += Step)
+		{
+			const int32 BlockStart = MipStart + MipRowsPerFrame * MipWidth * (Frame / Step);
+			check((Frame / Step + 1) * MipRowsPerFrame <= MipHeight);
+
+			// Set Data.
+			for (int32 Index = 0; Index < NumElements; Index++)
+			{
+				const V& Vector = Vectors[NumElements * Frame + Index];
+				typename TextureSettings::ColorType& Pixel = Pixels[BlockStart + Index];
+
+				VectorToColor<V, typename TextureSettings::ColorType>(Vector, Pixel);
+			}
+		}
+
+		MipStart += MipWidth * MipHeight;
+	}
+
+	// Write to Texture
+	return WriteToTextureMips<TextureSettings>(Texture, Height, Width, NumMips, Pixels);
+}
+
+template<class V, class TextureSettings>
+FORCEINLINE_DEBUGGABLE bool FVATUtils::WriteVectorsToTextureArray(const TArray<V>& Vectors,
+	const int32 NumFrames, const int32 RowsPerFrame,
+	const int32 Height, const int32 Width,
+	const TArray<FIntPoint>& FramePages, const int32 NumPages,
+	UTexture2DArray* Texture)
+{
+	if (!Texture || !NumFrames || FramePages.Num() != NumFrames)
+	{
+		return false;
+	}
+
+	// NumElements Per-Frame
+	const int32 NumElements = Vectors.Num() / NumFrames;
+
+	// Allocate PixelData.
+	TArray<typename TextureSettings::ColorType> Pixels;
+	Pixels.Init(TextureSettings::DefaultColor, Height * Width * NumPages);
+
+	// Fillout Frame Data
+	for (int32 Frame = 0; Frame < NumFrames; Frame++)
+	{
+		const int32 BlockStart = Height * Width * FramePages[Frame].X + RowsPerFrame * Width * FramePages[Frame].Y;
+
+		// Set Data.
+		for (int32 Index = 0; Index < NumElements; Index++)
+		{
+			const V& Vector = Vectors[NumElements * Frame + Index];
+			typename TextureSettings::ColorType& Pixel = Pixels[BlockStart + Index];
+
+			VectorToColor<V, typename TextureSettings::ColorType>(Vector, Pixel);
+		}
+	}
+
+	// Write to Texture
+	return WriteToTextureArray<TextureSettings>(Texture, Height, Width, NumPages, Pixels);
+}
+
 template<class TextureSettings>
 FORCEINLINE_DEBUGGABLE bool FVATUtils::WriteSkinWeightsToTexture(const TArray<VertexSkinWeightFour>& SkinWeights, const int32 NumBones,
-	const int32 RowsPerFrame, const int32 Height, const int32 Width, UTexture2D* Texture)
+	const int32 RowsPerFrame, const int32 Height, const int32 Width, UTexture2D* Texture, const bool bWriteIndices)
 {
 	check(Texture);
 	
 	const int32 NumVertices = SkinWeights.Num();
+	const int32 WeightsBlockStart = bWriteIndices ? RowsPerFrame * Width : 0;
 
 	// Allocate PixelData.
 	TArray<typename TextureSettings::ColorType> Pixels;
@@ -174,6 +390,7 @@ FORCEINLINE_DEBUGGABLE bool FVATUtils::WriteSkinWeightsToTexture(const TArray<Ve
 			(float)VertexSkinWeight.BoneWeights[3] / 255.f);
 
 		// Write BoneIndex
+		if (bWriteIndices)
 		{
 			typename TextureSettings::ColorType& Pixel = Pixels[VertexIndex];
 			VectorToColor<FVector4f, typename TextureSettings::ColorType>(BoneIndices, Pixel);
@@ -181,7 +398,7 @@ FORCEINLINE_DEBUGGABLE bool FVATUtils::WriteSkinWeightsToTexture(const TArray<Ve
 		
 		// Write BoneWeight
 		{
-			typename TextureSettings::ColorType& Pixel = Pixels[RowsPerFrame * Width + VertexIndex];
+			typename TextureSettings::ColorType& Pixel = Pixels[WeightsBlockStart + VertexIndex];
 			VectorToColor<FVector4f, typename TextureSettings::ColorType>(BoneWeights, Pixel);
 		}
 	};
@@ -194,7 +411,7 @@ template<class TextureSettings>
 FORCEINLINE_DEBUGGABLE bool FVATUtils::WriteToTexture(
 	UTexture2D* Texture,
 	const uint32 Height, const uint32 Width,
-	const TArray<typename TextureSettings::ColorType>& Pixels)
+	const TArray<typename TextureSettings::ColorType>& Pixels, const TextureFilter Filter)
 {
 	check(Texture);
 
@@ -246,6 +463,58 @@ FORCEINLINE_DEBUGGABLE bool FVATUtils::WriteToTexture(
 	// Initialize a new texture
 	Texture->Source.Init(Width, Height, 1, 1, TextureSettings::TextureSourceFormat, PixelsData);
 	
+	// Set parameters
+	Texture->SRGB = 0;
+	Texture->Filter = Filter;
+	Texture->CompressionSettings = TextureSettings::CompressionSettings;
+	Texture->MipGenSettings = TextureMipGenSettings::TMGS_NoMipmaps;
+
+	// Update and Mark to Save.
+	Texture->UpdateResource();
+	Texture->MarkPackageDirty();
+
+	return true;
+}
+
+template<class TextureSettings>
+FORCEINLINE_DEBUGGABLE bool FVATUtils::WriteToTextureMips(
+	UTexture2D* Texture,
+	const uint32 Height, const uint32 Width, const uint32 NumMips,
+	const TArray<typename TextureSettings::ColorType>& Pixels)
+{
+	check(Texture);
+
+	// Mips are built from the Source, and kept as authored.
+	Texture->Source.Init(Width, Height, 1, NumMips, TextureSettings::TextureSourceFormat, (const uint8*)Pixels.GetData());
+
+	// Set parameters
+	Texture->SRGB = 0;
+	Texture->Filter = TextureFilter::TF_Nearest;
+	Texture->CompressionSettings = TextureSettings::CompressionSettings;
+	Texture->MipGenSettings = TextureMipGenSettings::TMGS_LeaveExistingMips;
+
+	// Mips are loaded by level in the shader. Streamed out mips would shift the levels, so they stay resident.
+	Texture->NeverStream = true;
+
+	// Update and Mark to Save.
+	Texture->UpdateResource();
+	Texture->MarkPackageDirty();
+
+	return true;
+}
+
+template<class TextureSettings>
+FORCEINLINE_DEBUGGABLE bool FVATUtils::WriteToTextureArray(
+	UTexture2DArray* Texture,
+	const uint32 Height, const uint32 Width, const uint32 NumSlices,
+	const TArray<typename TextureSettings::ColorType>& Pixels)
+{
+	check(Texture);
+	check(Pixels.Num() == Height * Width * NumSlices);
+
+	// Texture Arrays are built from their Source.
+	Texture->Source.Init(Width, Height, NumSlices, 1, TextureSettings::TextureSourceFormat, (const uint8*)Pixels.GetData());
+
 	// Set parameters
 	Texture->SRGB = 0;
 	Texture->Filter = TextureFilter::TF_Nearest;
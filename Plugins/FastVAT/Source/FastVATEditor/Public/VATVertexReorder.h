@@ -0,0 +1,46 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+/* Vertex reordering for texture fetch locality.
+*  Triangles are ordered for the post-transform vertex cache (Tipsify) and vertices get texels in the order they are first drawn.
+*  Texels are addressed in Morton ordered tiles within each frame block, so vertices drawn together share texture cache lines. */
+class FVATVertexReorder
+{
+public:
+
+	/* Returns the triangle vertex indices of the StaticMesh LOD */
+	static bool GetTriangleIndices(const UStaticMesh* StaticMesh, const int32 LODIndex, TArray<int32>& OutIndices, int32& OutNumVertices);
+
+	/* Reorders Triangles for a post-transform cache of CacheSize vertices (Tipsify, Sander et al. 2007) */
+	static void OptimizeTriangleOrder(const TArray<int32>& Indices, const int32 NumVertices, const int32 CacheSize, TArray<int32>& OutIndices);
+
+	/* Returns the texel (within the frame block) of each vertex. Vertices are ordered by first use in Indices,
+	*  and texels are ordered in TileSize x TileSize Morton tiles of the Width x RowsPerFrame frame block. */
+	static void GetVertexTexels(const TArray<int32>& Indices, const int32 NumVertices, const int32 Width, const int32 RowsPerFrame,
+		const int32 TileSize, TArray<int32>& OutVertexTexels);
+
+	/* Simulates the texel fetches for drawing Indices. Vertices missing a FIFO post-transform cache of VertexCacheSize
+	*  fetch their texel through an LRU texture cache of NumCacheLines lines of LineWidth x LineHeight texels.
+	*  Returns the number of texture cache misses */
+	static int32 SimulateTextureCacheMisses(const TArray<int32>& Indices, const TArray<int32>& VertexTexels, const int32 Width,
+		const int32 VertexCacheSize, const int32 NumCacheLines, const int32 LineWidth, const int32 LineHeight);
+
+	/* Moves each element of per-frame data (NumElements per frame) to its texel */
+	template<typename T>
+	static void ScatterElements(TArray<T>& InOutData, const int32 NumElements, const TArray<int32>& ElementTexels)
+	{
+		check(ElementTexels.Num() == NumElements);
+		TArray<T> Data;
+		Data.SetNumUninitialized(InOutData.Num());
+		for (int32 Block = 0; Block < InOutData.Num() / NumElements; Block++)
+		{
+			const int32 BlockStart = Block * NumElements;
+			for (int32 Index = 0; Index < NumElements; Index++)
+			{
+				Data[BlockStart + ElementTexels[Index]] = InOutData[BlockStart + Index];
+			}
+		}
+		InOutData = MoveTemp(Data);
+	}
+};